@@ -3246,8 +3246,8 @@ class LDdecode:
 
         return None
 
-    def build_json(self, f):
-        ''' build up the JSON structure for file output. '''
+    def build_json_header(self, f):
+        ''' build up the JSON video/audio parameters for file output. '''
         jout = {}
         jout['pcmAudioParameters'] = {'bits':16, 'isLittleEndian': True, 'isSigned': True, 'sampleRate': self.analog_audio}
 
@@ -3277,7 +3277,12 @@ class LDdecode:
         vp['activeVideoEnd'] = np.round((f.rf.SysParams['activeVideoUS'][1] * spu) + badj)
 
         jout['videoParameters'] = vp
-        
+
+        return jout
+
+    def build_json(self, f):
+        ''' build up the JSON structure for file output. '''
+        jout = self.build_json_header(f)
         jout['fields'] = self.fieldinfo.copy()
 
         return jout
@@ -788,5 +788,47 @@ def write_json(ldd, outname):
     
     os.rename(outname + '.tbc.json.tmp', outname + '.tbc.json')
 
+# Append-only journal of the .tbc.json metadata, written while decoding.
+#
+# Rewriting the whole .tbc.json at every checkpoint takes longer and longer as
+# the decode goes on, so instead each checkpoint appends the fields added since
+# the previous one (and the video/audio parameters, if they've changed) as
+# single-line JSON objects.  The ld-decode-tools can read a .tbc.jsonl journal
+# directly, and ld-export-metadata --json will compact one into a .tbc.json.
+class JsonJournal:
+    def __init__(self, outname):
+        self.filename = outname + '.tbc.jsonl'
+        self.fp = open(self.filename, 'w')
+        self.fields_written = 0
+        self.header = None
+
+        # Any existing .tbc.json is from an earlier decode; remove it so that
+        # tools reading the output while the decode is running use the journal
+        if os.path.exists(outname + '.tbc.json'):
+            os.remove(outname + '.tbc.json')
+
+    def checkpoint(self, ldd):
+        header = ldd.build_json_header(ldd.curfield)
+
+        if header is not None:
+            # The number of fields changes every time; readers count them instead
+            del header['videoParameters']['numberOfSequentialFields']
+
+            if header != self.header:
+                self.fp.write(json.dumps(header) + '\n')
+                self.header = header
+
+        for fi in ldd.fieldinfo[self.fields_written:]:
+            self.fp.write(json.dumps({'field': fi}) + '\n')
+        self.fields_written = len(ldd.fieldinfo)
+
+        self.fp.flush()
+
+    def close(self, remove=False):
+        self.fp.close()
+
+        if remove:
+            os.remove(self.filename)
+
 if __name__ == "__main__":
     print("Nothing to see here, move along ;)")
@@ -8,6 +8,8 @@ QT       += core gui
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
+QT += concurrent
+
 TARGET = ld-analyse
 TEMPLATE = app
 
@@ -46,6 +48,8 @@ SOURCES += \
     ../ld-chroma-decoder/framecanvas.cpp \
     ../ld-chroma-decoder/sourcefield.cpp \
     ../library/tbc/lddecodemetadata.cpp \
+    ../library/tbc/jsonreader.cpp \
+    ../library/tbc/jsonwriter.cpp \
     ../library/tbc/sourcevideo.cpp \
     ../library/tbc/vbidecoder.cpp \
     ../library/tbc/filters.cpp \
@@ -76,6 +80,8 @@ HEADERS += \
     ../ld-chroma-decoder/sourcefield.h \
     ../library/filter/firfilter.h \
     ../library/tbc/lddecodemetadata.h \
+    ../library/tbc/jsonreader.h \
+    ../library/tbc/jsonwriter.h \
     ../library/tbc/sourcevideo.h \
     ../library/tbc/vbidecoder.h \
     ../library/tbc/filters.h \
@@ -27,8 +27,10 @@
 #include <QDebug>
 #include <QtGlobal>
 #include <QCommandLineParser>
+#include <QStandardPaths>
 
 #include "logging.h"
+#include "transformpal.h"
 
 int main(int argc, char *argv[])
 {
@@ -74,6 +76,10 @@ int main(int argc, char *argv[])
         inputFileName.clear();
     }
 
+    // Cache FFTW wisdom for the Transform PAL decoders, so changing the
+    // chroma decoder configuration doesn't need to re-plan the FFTs
+    TransformPal::configurePlanner(false, QStandardPaths::writableLocation(QStandardPaths::CacheLocation));
+
     // Start the GUI application
     MainWindow w(inputFileName);
     w.show();
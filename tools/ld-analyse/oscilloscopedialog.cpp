@@ -172,11 +172,9 @@ QImage OscilloscopeDialog::getFieldLineTraceImage(TbcSource::ScanLineData scanLi
         Filters filters;
 
         if (scanLineData.isSourcePal) {
-            signalDataY = signalDataYC;
-            filters.palLumaFirFilter(signalDataY);
+            filters.palLumaFirFilter(signalDataYC, signalDataY);
         } else {
-            signalDataY = signalDataYC;
-            filters.ntscLumaFirFilter(signalDataY);
+            filters.ntscLumaFirFilter(signalDataYC, signalDataY);
         }
     }
 
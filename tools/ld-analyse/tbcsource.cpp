@@ -26,6 +26,12 @@
 
 #include "sourcefield.h"
 
+#include <algorithm>
+
+// Definitions of static constexpr data members, for compatibility with
+// pre-C++17 compilers
+constexpr qint32 TbcSource::PREFETCH_FRAMES;
+
 TbcSource::TbcSource(QObject *parent) : QObject(parent)
 {
     // Default frame image options
@@ -34,13 +40,28 @@ TbcSource::TbcSource(QObject *parent) : QObject(parent)
     reverseFoOn = false;
     sourceReady = false;
     fieldsPerGraphDataPoint = 0;
-    frameCacheFrameNumber = -1;
+
+    // Set up the frame cache (the cost of each entry is one frame)
+    frameCache.setMaxCost(32);
+    frameCacheGeneration = 0;
+
+    // Default prefetch state
+    prefetchRunning = false;
+    prefetchPending = false;
+    prefetchStopping = false;
+    prefetchFrameNumber = -1;
+    prefetchDirection = 1;
+    lastRequestedFrameNumber = -1;
 
     // Set the chroma decoder configuration to default
     palConfiguration = palColour.getConfiguration();
     palConfiguration.chromaFilter = PalColour::transform2DFilter;
     ntscConfiguration = ntscColour.getConfiguration();
-    decoderConfigurationChanged = false;
+}
+
+TbcSource::~TbcSource()
+{
+    stopPrefetch();
 }
 
 // Public methods -----------------------------------------------------------------------------------------------------
@@ -48,13 +69,22 @@ TbcSource::TbcSource(QObject *parent) : QObject(parent)
 // Method to load a TBC source file
 void TbcSource::loadSource(QString sourceFilename)
 {
+    // Make sure the prefetch thread isn't using the old source
+    stopPrefetch();
+
     // Default frame options
-    chromaOn = false;
-    dropoutsOn = false;
-    reverseFoOn = false;
-    sourceReady = false;
+    {
+        QMutexLocker renderLocker(&renderMutex);
+        QMutexLocker locker(&sourceMutex);
+
+        chromaOn = false;
+        dropoutsOn = false;
+        reverseFoOn = false;
+        sourceReady = false;
+        invalidateFrameCache();
+    }
     fieldsPerGraphDataPoint = 0;
-    frameCacheFrameNumber = -1;
+    lastRequestedFrameNumber = -1;
 
     // Set the current file name
     QFileInfo inFileInfo(sourceFilename);
@@ -71,6 +101,12 @@ void TbcSource::loadSource(QString sourceFilename)
 // Method to unload a TBC source file
 void TbcSource::unloadSource()
 {
+    stopPrefetch();
+
+    QMutexLocker renderLocker(&renderMutex);
+    QMutexLocker locker(&sourceMutex);
+
+    invalidateFrameCache();
     sourceVideo.close();
     sourceReady = false;
 }
@@ -78,12 +114,14 @@ void TbcSource::unloadSource()
 // Method returns true is a TBC source is loaded
 bool TbcSource::getIsSourceLoaded()
 {
+    QMutexLocker locker(&sourceMutex);
     return sourceReady;
 }
 
 // Method returns the filename of the current TBC source
 QString TbcSource::getCurrentSourceFilename()
 {
+    QMutexLocker locker(&sourceMutex);
     if (!sourceReady) return QString();
 
     return currentSourceFilename;
@@ -92,22 +130,31 @@ QString TbcSource::getCurrentSourceFilename()
 // Method to set the highlight dropouts mode (true = dropouts highlighted)
 void TbcSource::setHighlightDropouts(bool _state)
 {
-    frameCacheFrameNumber = -1;
+    QMutexLocker renderLocker(&renderMutex);
+    QMutexLocker locker(&sourceMutex);
+
     dropoutsOn = _state;
+    invalidateFrameCache();
 }
 
 // Method to set the chroma decoder mode (true = on)
 void TbcSource::setChromaDecoder(bool _state)
 {
-    frameCacheFrameNumber = -1;
+    QMutexLocker renderLocker(&renderMutex);
+    QMutexLocker locker(&sourceMutex);
+
     chromaOn = _state;
+    invalidateFrameCache();
 }
 
 // Method to set the field order (true = reversed, false = normal)
 void TbcSource::setFieldOrder(bool _state)
 {
-    frameCacheFrameNumber = -1;
+    QMutexLocker renderLocker(&renderMutex);
+    QMutexLocker locker(&sourceMutex);
+
     reverseFoOn = _state;
+    invalidateFrameCache();
 
     if (reverseFoOn) ldDecodeMetaData.setIsFirstFieldFirst(false);
     else ldDecodeMetaData.setIsFirstFieldFirst(true);
@@ -134,77 +181,30 @@ bool TbcSource::getFieldOrder()
 // Method to get a QImage from a frame number
 QImage TbcSource::getFrameImage(qint32 frameNumber)
 {
-    if (!sourceReady) return QImage();
+    QImage frameImage;
+    if (!getCachedFrameImage(frameNumber, frameImage)) {
+        // Not cached, so render it (waiting for the prefetch thread if it's
+        // rendering at the moment -- it may be rendering this frame)
+        QMutexLocker renderLocker(&renderMutex);
+        if (!sourceReady) return QImage();
 
-    // Check cached QImage
-    if (frameCacheFrameNumber == frameNumber && !decoderConfigurationChanged) return frameCache;
-    else {
-        frameCacheFrameNumber = frameNumber;
-        decoderConfigurationChanged = false;
-    }
-
-    // Get the required field numbers
-    qint32 firstFieldNumber = ldDecodeMetaData.getFirstFieldNumber(frameNumber);
-    qint32 secondFieldNumber = ldDecodeMetaData.getSecondFieldNumber(frameNumber);
-
-    // Make sure we have a valid response from the frame determination
-    if (firstFieldNumber == -1 || secondFieldNumber == -1) {
-        qCritical() << "Could not determine field numbers!";
-
-        // Jump back one frame
-        if (frameNumber != 1) {
-            frameNumber--;
-
-            firstFieldNumber = ldDecodeMetaData.getFirstFieldNumber(frameNumber);
-            secondFieldNumber = ldDecodeMetaData.getSecondFieldNumber(frameNumber);
+        if (!getCachedFrameImage(frameNumber, frameImage)) {
+            frameImage = renderFrameImage(frameNumber);
+            insertFrameImage(frameNumber, frameImage);
         }
-        qDebug() << "TbcSource::getFrameImage(): Jumping back one frame due to error";
     }
 
-    // Get a QImage for the frame
-    QImage frameImage = generateQImage(frameNumber);
-
-    // Get the field metadata
-    LdDecodeMetaData::Field firstField = ldDecodeMetaData.getField(firstFieldNumber);
-    LdDecodeMetaData::Field secondField = ldDecodeMetaData.getField(secondFieldNumber);
-
-    // Highlight dropouts
-    if (dropoutsOn) {
-        // Create a painter object
-        QPainter imagePainter;
-        imagePainter.begin(&frameImage);
-
-        // Draw the drop out data for the first field
-        imagePainter.setPen(Qt::red);
-        for (qint32 dropOutIndex = 0; dropOutIndex < firstField.dropOuts.size(); dropOutIndex++) {
-            qint32 startx = firstField.dropOuts.startx(dropOutIndex);
-            qint32 endx = firstField.dropOuts.endx(dropOutIndex);
-            qint32 fieldLine = firstField.dropOuts.fieldLine(dropOutIndex);
-
-            imagePainter.drawLine(startx, ((fieldLine - 1) * 2), endx, ((fieldLine - 1) * 2));
-        }
-
-        // Draw the drop out data for the second field
-        imagePainter.setPen(Qt::blue);
-        for (qint32 dropOutIndex = 0; dropOutIndex < secondField.dropOuts.size(); dropOutIndex++) {
-            qint32 startx = secondField.dropOuts.startx(dropOutIndex);
-            qint32 endx = secondField.dropOuts.endx(dropOutIndex);
-            qint32 fieldLine = secondField.dropOuts.fieldLine(dropOutIndex);
-
-            imagePainter.drawLine(startx, ((fieldLine - 1) * 2) + 1, endx, ((fieldLine - 1) * 2) + 1);
-        }
-
-        // End the painter object
-        imagePainter.end();
-    }
+    // Decode the next few frames in the background, so they're ready when
+    // the user moves on
+    startPrefetch(frameNumber);
 
-    frameCache = frameImage;
     return frameImage;
 }
 
 // Method to get the number of available frames
 qint32 TbcSource::getNumberOfFrames()
 {
+    QMutexLocker locker(&sourceMutex);
     if (!sourceReady) return 0;
     return ldDecodeMetaData.getNumberOfFrames();
 }
@@ -212,6 +212,7 @@ qint32 TbcSource::getNumberOfFrames()
 // Method to get the number of available fields
 qint32 TbcSource::getNumberOfFields()
 {
+    QMutexLocker locker(&sourceMutex);
     if (!sourceReady) return 0;
     return ldDecodeMetaData.getNumberOfFields();
 }
@@ -219,6 +220,7 @@ qint32 TbcSource::getNumberOfFields()
 // Method returns true if the TBC source is PAL (false for NTSC)
 bool TbcSource::getIsSourcePal()
 {
+    QMutexLocker locker(&sourceMutex);
     if (!sourceReady) return false;
     return ldDecodeMetaData.getVideoParameters().isSourcePal;
 }
@@ -226,6 +228,7 @@ bool TbcSource::getIsSourcePal()
 // Method to get the frame height in scanlines
 qint32 TbcSource::getFrameHeight()
 {
+    QMutexLocker locker(&sourceMutex);
     if (!sourceReady) return 0;
 
     // Get the metadata for the fields
@@ -238,6 +241,7 @@ qint32 TbcSource::getFrameHeight()
 // Method to get the frame width in dots
 qint32 TbcSource::getFrameWidth()
 {
+    QMutexLocker locker(&sourceMutex);
     if (!sourceReady) return 0;
 
     // Get the metadata for the fields
@@ -278,6 +282,82 @@ qint32 TbcSource::getGraphDataSize()
     return dropoutGraphData.size();
 }
 
+// Generate the data points for the Drop-out and SNR analysis graphs, averaging
+// the per-field metrics to give approximately _targetDataPoints points
+void TbcSource::generateGraphData(qint32 _targetDataPoints)
+{
+    dropoutGraphData.clear();
+    blackSnrGraphData.clear();
+    whiteSnrGraphData.clear();
+    cqiGraphData.clear();
+
+    const qint32 numberOfFields = dropoutLengthTotals.size() - 1;
+    if (numberOfFields < 1 || _targetDataPoints < 1) {
+        fieldsPerGraphDataPoint = 0;
+        return;
+    }
+
+    qreal targetDataPoints = static_cast<qreal>(_targetDataPoints);
+    qreal averageWidth = qRound(numberOfFields / targetDataPoints);
+    if (averageWidth < 1) averageWidth = 1; // Ensure we don't divide by zero
+    qint32 dataPoints = numberOfFields / static_cast<qint32>(averageWidth);
+    fieldsPerGraphDataPoint = numberOfFields / dataPoints;
+    if (fieldsPerGraphDataPoint < 1) fieldsPerGraphDataPoint = 1;
+
+    // Get the total number of dots per field
+    LdDecodeMetaData::VideoParameters videoParameters;
+    {
+        QMutexLocker locker(&sourceMutex);
+        videoParameters = ldDecodeMetaData.getVideoParameters();
+    }
+    qint32 totalDotsPerField = videoParameters.fieldHeight + videoParameters.fieldWidth;
+
+    dropoutGraphData.reserve(dataPoints);
+    blackSnrGraphData.reserve(dataPoints);
+    whiteSnrGraphData.reserve(dataPoints);
+    cqiGraphData.reserve(dataPoints);
+
+    for (qint32 dpCount = 0; dpCount < dataPoints; dpCount++) {
+        // Range of fields (indexed from 0) covered by this data point
+        const qint32 first = dpCount * fieldsPerGraphDataPoint;
+        const qint32 last = first + fieldsPerGraphDataPoint;
+
+        // Calculate the averages
+        qreal doLength = (dropoutLengthTotals[last] - dropoutLengthTotals[first]) / static_cast<qreal>(fieldsPerGraphDataPoint);
+        qreal syncConf = (syncConfTotals[last] - syncConfTotals[first]) / static_cast<qreal>(fieldsPerGraphDataPoint);
+
+        const qint32 blackSnrPoints = blackSnrCounts[last] - blackSnrCounts[first];
+        const qint32 whiteSnrPoints = whiteSnrCounts[last] - whiteSnrCounts[first];
+        qreal blackSnrTotal = 0;
+        qreal whiteSnrTotal = 0;
+        if (blackSnrPoints > 0) blackSnrTotal = (blackSnrTotals[last] - blackSnrTotals[first]) / blackSnrPoints;
+        if (whiteSnrPoints > 0) whiteSnrTotal = (whiteSnrTotals[last] - whiteSnrTotals[first]) / whiteSnrPoints;
+
+        // Calculate the Capture Quality Index
+        qreal fieldDoPercent = 100.0 - (static_cast<qreal>(doLength) / static_cast<qreal>(totalDotsPerField * fieldsPerGraphDataPoint));
+        qreal snrPercent = 0;
+
+        // Convert SNR to linear
+        qreal whiteSnrLinear = pow(whiteSnrTotal / 20, 10);
+        qreal blackSnrLinear = pow(blackSnrTotal / 20, 10);
+        qreal snrReferenceLinear = pow(43.0 / 20, 10); // Note: 43 dB is the expected maximum
+
+        if (whiteSnrTotal != 0) snrPercent = (100.0 / (snrReferenceLinear * 2)) * (blackSnrLinear + whiteSnrLinear);
+        else snrPercent = (100.0 / snrReferenceLinear) * blackSnrLinear;
+        if (snrPercent > 100.0) snrPercent = 100.0;
+
+        // Note: The weighting is 1000:1:1 - this is just because dropouts have a greater visual effect
+        // on the resulting capture than SNR.
+        qreal captureQualityIndex = ((fieldDoPercent * 1000.0) + snrPercent + syncConf) / 1002.0;
+
+        // Add the result to the vectors
+        dropoutGraphData.append(doLength);
+        blackSnrGraphData.append(blackSnrTotal);
+        whiteSnrGraphData.append(whiteSnrTotal);
+        cqiGraphData.append(captureQualityIndex);
+    }
+}
+
 // Method to get the number of fields averaged into each graphing data point
 qint32 TbcSource::getFieldsPerGraphDataPoint()
 {
@@ -287,6 +367,7 @@ qint32 TbcSource::getFieldsPerGraphDataPoint()
 // Method returns true if frame contains dropouts
 bool TbcSource::getIsDropoutPresent(qint32 frameNumber)
 {
+    QMutexLocker locker(&sourceMutex);
     if (!sourceReady) return false;
 
     bool dropOutsPresent = false;
@@ -304,6 +385,8 @@ bool TbcSource::getIsDropoutPresent(qint32 frameNumber)
 // Get scan line data from a frame
 TbcSource::ScanLineData TbcSource::getScanLineData(qint32 frameNumber, qint32 scanLine)
 {
+    // This reads from the source video, so it's serialised with rendering
+    QMutexLocker renderLocker(&renderMutex);
     if (!sourceReady) return ScanLineData();
 
     // Determine the first and second fields for the frame number
@@ -346,18 +429,16 @@ TbcSource::ScanLineData TbcSource::getScanLineData(qint32 frameNumber, qint32 sc
         dropouts = ldDecodeMetaData.getFieldDropOuts(secondFieldNumber);
     }
 
+    // Index the dropouts by line, for quick lookup
+    dropouts.sort();
+
     scanLineData.data.resize(videoParameters.fieldWidth);
     scanLineData.isDropout.resize(videoParameters.fieldWidth);
     for (qint32 xPosition = 0; xPosition < videoParameters.fieldWidth; xPosition++) {
         // Get the 16-bit YC value for the current pixel (frame data is numbered 0-624 or 0-524)
         scanLineData.data[xPosition] = fieldData[((fieldLine - 1) * videoParameters.fieldWidth) + xPosition];
 
-        scanLineData.isDropout[xPosition] = false;
-        for (qint32 doCount = 0; doCount < dropouts.size(); doCount++) {
-            if (dropouts.fieldLine(doCount) == fieldLine) {
-                if (xPosition >= dropouts.startx(doCount) && xPosition <= dropouts.endx(doCount)) scanLineData.isDropout[xPosition] = true;
-            }
-        }
+        scanLineData.isDropout[xPosition] = dropouts.isDropout(fieldLine, xPosition);
     }
 
     return scanLineData;
@@ -366,19 +447,17 @@ TbcSource::ScanLineData TbcSource::getScanLineData(qint32 frameNumber, qint32 sc
 // Method to return the decoded VBI data for a frame
 VbiDecoder::Vbi TbcSource::getFrameVbi(qint32 frameNumber)
 {
+    QMutexLocker locker(&sourceMutex);
     if (!sourceReady) return VbiDecoder::Vbi();
 
-    // Get the field VBI data
-    LdDecodeMetaData::Vbi firstField = ldDecodeMetaData.getFieldVbi(ldDecodeMetaData.getFirstFieldNumber(frameNumber));
-    LdDecodeMetaData::Vbi secondField = ldDecodeMetaData.getFieldVbi(ldDecodeMetaData.getSecondFieldNumber(frameNumber));
-
-    return vbiDecoder.decodeFrame(firstField.vbiData[0], firstField.vbiData[1], firstField.vbiData[2],
-            secondField.vbiData[0], secondField.vbiData[1], secondField.vbiData[2]);
+    // Get the decoded VBI from the metadata's cache
+    return ldDecodeMetaData.getFrameVbi(frameNumber);
 }
 
 // Method returns true if the VBI is valid for the specified frame number
 bool TbcSource::getIsFrameVbiValid(qint32 frameNumber)
 {
+    QMutexLocker locker(&sourceMutex);
     if (!sourceReady) return false;
 
     // Get the field VBI data
@@ -394,6 +473,7 @@ bool TbcSource::getIsFrameVbiValid(qint32 frameNumber)
 // Method to get the field number of the first field of the specified frame
 qint32 TbcSource::getFirstFieldNumber(qint32 frameNumber)
 {
+    QMutexLocker locker(&sourceMutex);
     if (!sourceReady) return 0;
 
     return ldDecodeMetaData.getFirstFieldNumber(frameNumber);
@@ -402,6 +482,7 @@ qint32 TbcSource::getFirstFieldNumber(qint32 frameNumber)
 // Method to get the field number of the second field of the specified frame
 qint32 TbcSource::getSecondFieldNumber(qint32 frameNumber)
 {
+    QMutexLocker locker(&sourceMutex);
     if (!sourceReady) return 0;
 
     return ldDecodeMetaData.getSecondFieldNumber(frameNumber);
@@ -409,6 +490,7 @@ qint32 TbcSource::getSecondFieldNumber(qint32 frameNumber)
 
 qint32 TbcSource::getCcData0(qint32 frameNumber)
 {
+    QMutexLocker locker(&sourceMutex);
     if (!sourceReady) return false;
 
     // Get the field metadata
@@ -421,6 +503,7 @@ qint32 TbcSource::getCcData0(qint32 frameNumber)
 
 qint32 TbcSource::getCcData1(qint32 frameNumber)
 {
+    QMutexLocker locker(&sourceMutex);
     if (!sourceReady) return false;
 
     // Get the field metadata
@@ -433,6 +516,9 @@ qint32 TbcSource::getCcData1(qint32 frameNumber)
 
 void TbcSource::setChromaConfiguration(const PalColour::Configuration &_palConfiguration, const Comb::Configuration &_ntscConfiguration)
 {
+    QMutexLocker renderLocker(&renderMutex);
+    QMutexLocker locker(&sourceMutex);
+
     palConfiguration = _palConfiguration;
     ntscConfiguration = _ntscConfiguration;
 
@@ -444,7 +530,7 @@ void TbcSource::setChromaConfiguration(const PalColour::Configuration &_palConfi
         ntscColour.updateConfiguration(videoParameters, ntscConfiguration);
     }
 
-    decoderConfigurationChanged = true;
+    invalidateFrameCache();
 }
 
 const PalColour::Configuration &TbcSource::getPalConfiguration()
@@ -460,50 +546,223 @@ const Comb::Configuration &TbcSource::getNtscConfiguration()
 // Return the frame number of the start of the next chapter
 qint32 TbcSource::startOfNextChapter(qint32 currentFrameNumber)
 {
-    // Do we have a chapter map?
-    if (chapterMap.size() == 0) return getNumberOfFrames();
+    QMutexLocker locker(&sourceMutex);
+    if (!sourceReady) return 1;
 
-    qint32 mapLocation = -1;
-    for (qint32 i = 0; i < chapterMap.size(); i++) {
-        if (chapterMap[i] > currentFrameNumber) {
-            mapLocation = i;
-            break;
-        }
-    }
+    // Find the first chapter start after the current frame
+    const QVector<LdDecodeMetaData::SeekIndexEntry> &chapterStarts = ldDecodeMetaData.getChapterStarts();
+    auto it = std::upper_bound(chapterStarts.begin(), chapterStarts.end(), currentFrameNumber,
+                               [](qint32 frameNumber, const LdDecodeMetaData::SeekIndexEntry &entry) {
+                                   return frameNumber < entry.frameNumber;
+                               });
 
     // Found?
-    if (mapLocation != -1) {
-        return chapterMap[mapLocation];
-    }
+    if (it != chapterStarts.end()) return it->frameNumber;
 
-    return getNumberOfFrames();
+    return ldDecodeMetaData.getNumberOfFrames();
 }
 
 // Return the frame number of the start of the current chapter
 qint32 TbcSource::startOfChapter(qint32 currentFrameNumber)
 {
-    // Do we have a chapter map?
-    if (chapterMap.size() == 0) return 1;
+    QMutexLocker locker(&sourceMutex);
+    if (!sourceReady) return 1;
 
-    qint32 mapLocation = -1;
-    for (qint32 i = chapterMap.size() - 1; i >= 0; i--) {
-        if (chapterMap[i] < currentFrameNumber) {
-            mapLocation = i;
-            break;
-        }
-    }
+    // Find the last chapter start before the current frame
+    const QVector<LdDecodeMetaData::SeekIndexEntry> &chapterStarts = ldDecodeMetaData.getChapterStarts();
+    auto it = std::lower_bound(chapterStarts.begin(), chapterStarts.end(), currentFrameNumber,
+                               [](const LdDecodeMetaData::SeekIndexEntry &entry, qint32 frameNumber) {
+                                   return entry.frameNumber < frameNumber;
+                               });
 
     // Found?
-    if (mapLocation != -1) {
-        return chapterMap[mapLocation];
-    }
+    if (it != chapterStarts.begin()) return (it - 1)->frameNumber;
 
     return 1;
 }
 
-
 // Private methods ----------------------------------------------------------------------------------------------------
 
+// Return the frame cache key for a frame number. This includes the generation
+// of the frame image options, so images rendered with an old configuration
+// (e.g. by the prefetch thread) are never returned.
+// Note: The caller must hold sourceMutex or renderMutex
+qint64 TbcSource::getFrameCacheKey(qint32 frameNumber)
+{
+    return (static_cast<qint64>(frameCacheGeneration) << 32) | static_cast<quint32>(frameNumber);
+}
+
+// Look up a frame in the frame cache. Returns false if the source isn't
+// ready, or the frame isn't cached.
+bool TbcSource::getCachedFrameImage(qint32 frameNumber, QImage &frameImage)
+{
+    QMutexLocker locker(&sourceMutex);
+    if (!sourceReady) return false;
+
+    const QImage *cachedImage = frameCache.object(getFrameCacheKey(frameNumber));
+    if (cachedImage == nullptr) return false;
+
+    frameImage = *cachedImage;
+    return true;
+}
+
+// Add a rendered frame to the frame cache
+// Note: The caller must hold renderMutex (so the options can't have changed
+// since the frame was rendered)
+void TbcSource::insertFrameImage(qint32 frameNumber, const QImage &frameImage)
+{
+    QMutexLocker locker(&sourceMutex);
+
+    frameCache.insert(getFrameCacheKey(frameNumber), new QImage(frameImage));
+}
+
+// Discard all cached frame images (called when the frame image options change)
+// Note: The caller must hold renderMutex and sourceMutex
+void TbcSource::invalidateFrameCache()
+{
+    frameCache.clear();
+    frameCacheGeneration++;
+}
+
+// Start (or redirect) the background prefetch following a request for frameNumber
+void TbcSource::startPrefetch(qint32 frameNumber)
+{
+    QMutexLocker locker(&prefetchMutex);
+
+    // Prefetch in the direction the user is moving
+    if (lastRequestedFrameNumber != -1 && frameNumber < lastRequestedFrameNumber) prefetchDirection = -1;
+    else if (frameNumber > lastRequestedFrameNumber) prefetchDirection = 1;
+    lastRequestedFrameNumber = frameNumber;
+
+    // Post the request
+    prefetchFrameNumber = frameNumber;
+    prefetchPending = true;
+    prefetchStopping = false;
+
+    // Start the prefetch thread if it isn't already running (if it is, it
+    // will abandon its current run and pick up this request)
+    if (!prefetchRunning) {
+        prefetchRunning = true;
+        prefetchFuture = QtConcurrent::run(this, &TbcSource::prefetchFrames);
+    }
+}
+
+// Stop the background prefetch, and wait for it to finish
+void TbcSource::stopPrefetch()
+{
+    {
+        QMutexLocker locker(&prefetchMutex);
+        prefetchPending = false;
+        prefetchStopping = true;
+    }
+
+    prefetchFuture.waitForFinished();
+}
+
+// Background thread to render the frames around the most recently requested
+// frame into the frame cache
+void TbcSource::prefetchFrames()
+{
+    while (true) {
+        // Take the most recent request
+        qint32 frameNumber, direction;
+        {
+            QMutexLocker locker(&prefetchMutex);
+            if (!prefetchPending) {
+                prefetchRunning = false;
+                return;
+            }
+
+            frameNumber = prefetchFrameNumber;
+            direction = prefetchDirection;
+            prefetchPending = false;
+        }
+
+        for (qint32 i = 1; i <= PREFETCH_FRAMES; i++) {
+            // Give up on this run if there's a newer request, or we're stopping
+            {
+                QMutexLocker locker(&prefetchMutex);
+                if (prefetchPending || prefetchStopping) break;
+            }
+
+            // Render the frame without holding sourceMutex, so the GUI can
+            // still get information about the source in the meantime
+            QMutexLocker renderLocker(&renderMutex);
+            if (!sourceReady) break;
+
+            const qint32 prefetchFrameNumber = frameNumber + (i * direction);
+            if (prefetchFrameNumber < 1 || prefetchFrameNumber > ldDecodeMetaData.getNumberOfFrames()) break;
+
+            QImage frameImage;
+            if (getCachedFrameImage(prefetchFrameNumber, frameImage)) continue;
+
+            insertFrameImage(prefetchFrameNumber, renderFrameImage(prefetchFrameNumber));
+        }
+    }
+}
+
+// Method to render a frame, including any overlays, into a QImage
+// Note: The caller must hold renderMutex
+QImage TbcSource::renderFrameImage(qint32 frameNumber)
+{
+    // Get the required field numbers
+    qint32 firstFieldNumber = ldDecodeMetaData.getFirstFieldNumber(frameNumber);
+    qint32 secondFieldNumber = ldDecodeMetaData.getSecondFieldNumber(frameNumber);
+
+    // Make sure we have a valid response from the frame determination
+    if (firstFieldNumber == -1 || secondFieldNumber == -1) {
+        qCritical() << "Could not determine field numbers!";
+
+        // Jump back one frame
+        if (frameNumber != 1) {
+            frameNumber--;
+
+            firstFieldNumber = ldDecodeMetaData.getFirstFieldNumber(frameNumber);
+            secondFieldNumber = ldDecodeMetaData.getSecondFieldNumber(frameNumber);
+        }
+        qDebug() << "TbcSource::renderFrameImage(): Jumping back one frame due to error";
+    }
+
+    // Get a QImage for the frame
+    QImage frameImage = generateQImage(frameNumber);
+
+    // Get the field metadata
+    LdDecodeMetaData::Field firstField = ldDecodeMetaData.getField(firstFieldNumber);
+    LdDecodeMetaData::Field secondField = ldDecodeMetaData.getField(secondFieldNumber);
+
+    // Highlight dropouts
+    if (dropoutsOn) {
+        // Create a painter object
+        QPainter imagePainter;
+        imagePainter.begin(&frameImage);
+
+        // Draw the drop out data for the first field
+        imagePainter.setPen(Qt::red);
+        for (qint32 dropOutIndex = 0; dropOutIndex < firstField.dropOuts.size(); dropOutIndex++) {
+            qint32 startx = firstField.dropOuts.startx(dropOutIndex);
+            qint32 endx = firstField.dropOuts.endx(dropOutIndex);
+            qint32 fieldLine = firstField.dropOuts.fieldLine(dropOutIndex);
+
+            imagePainter.drawLine(startx, ((fieldLine - 1) * 2), endx, ((fieldLine - 1) * 2));
+        }
+
+        // Draw the drop out data for the second field
+        imagePainter.setPen(Qt::blue);
+        for (qint32 dropOutIndex = 0; dropOutIndex < secondField.dropOuts.size(); dropOutIndex++) {
+            qint32 startx = secondField.dropOuts.startx(dropOutIndex);
+            qint32 endx = secondField.dropOuts.endx(dropOutIndex);
+            qint32 fieldLine = secondField.dropOuts.fieldLine(dropOutIndex);
+
+            imagePainter.drawLine(startx, ((fieldLine - 1) * 2) + 1, endx, ((fieldLine - 1) * 2) + 1);
+        }
+
+        // End the painter object
+        imagePainter.end();
+    }
+
+    return frameImage;
+}
+
 // Method to create a QImage for a source video frame
 QImage TbcSource::generateQImage(qint32 frameNumber)
 {
@@ -567,14 +826,12 @@ QImage TbcSource::generateQImage(qint32 frameNumber)
 
         // Copy the RGB16-16-16 data into the RGB888 QImage
         for (qint32 y = videoParameters.firstActiveFrameLine; y < videoParameters.lastActiveFrameLine; y++) {
-            for (qint32 x = videoParameters.activeVideoStart; x < videoParameters.activeVideoEnd; x++) {
-                qint32 pixelOffset = ((y * videoParameters.fieldWidth) + x) * 3;
+            const quint16 *inputLine = rgbPointer + (y * videoParameters.fieldWidth * 3);
+            uchar *outputLine = frameImage.scanLine(y);
 
-                // Take just the MSB of the input data
-                qint32 xpp = x * 3;
-                *(frameImage.scanLine(y) + xpp + 0) = static_cast<uchar>(rgbPointer[pixelOffset + 0] / 256); // R
-                *(frameImage.scanLine(y) + xpp + 1) = static_cast<uchar>(rgbPointer[pixelOffset + 1] / 256); // G
-                *(frameImage.scanLine(y) + xpp + 2) = static_cast<uchar>(rgbPointer[pixelOffset + 2] / 256); // B
+            // Take just the MSB of the input data
+            for (qint32 xpp = videoParameters.activeVideoStart * 3; xpp < videoParameters.activeVideoEnd * 3; xpp++) {
+                outputLine[xpp] = static_cast<uchar>(inputLine[xpp] / 256);
             }
         }
     } else {
@@ -586,20 +843,18 @@ QImage TbcSource::generateQImage(qint32 frameNumber)
 
         // Copy the raw 16-bit grayscale data into the RGB888 QImage
         for (qint32 y = 0; y < frameHeight; y++) {
+            const quint16 *inputLine = ((y % 2) ? secondFieldPointer : firstFieldPointer)
+                                       + (videoParameters.fieldWidth * (y / 2));
+            uchar *outputLine = frameImage.scanLine(y);
+
             for (qint32 x = 0; x < videoParameters.fieldWidth; x++) {
                 // Take just the MSB of the input data
-                qint32 pixelOffset = (videoParameters.fieldWidth * (y / 2)) + x;
-                uchar pixelValue;
-                if (y % 2) {
-                    pixelValue = static_cast<uchar>(secondFieldPointer[pixelOffset] / 256);
-                } else {
-                    pixelValue = static_cast<uchar>(firstFieldPointer[pixelOffset] / 256);
-                }
+                const uchar pixelValue = static_cast<uchar>(inputLine[x] / 256);
 
                 qint32 xpp = x * 3;
-                *(frameImage.scanLine(y) + xpp + 0) = static_cast<uchar>(pixelValue); // R
-                *(frameImage.scanLine(y) + xpp + 1) = static_cast<uchar>(pixelValue); // G
-                *(frameImage.scanLine(y) + xpp + 2) = static_cast<uchar>(pixelValue); // B
+                outputLine[xpp + 0] = pixelValue; // R
+                outputLine[xpp + 1] = pixelValue; // G
+                outputLine[xpp + 2] = pixelValue; // B
             }
         }
     }
@@ -607,99 +862,83 @@ QImage TbcSource::generateQImage(qint32 frameNumber)
     return frameImage;
 }
 
-// Generate the data points for the Drop-out and SNR analysis graphs
-// We do these both at the same time to reduce calls to the metadata
-void TbcSource::generateData(qint32 _targetDataPoints)
+// Extract the per-field metrics used by the Drop-out and SNR analysis graphs
+// from the metadata. This is done once, when the source is loaded.
+void TbcSource::extractFieldMetrics()
 {
-    dropoutGraphData.clear();
-    blackSnrGraphData.clear();
-    whiteSnrGraphData.clear();
-    cqiGraphData.clear();
+    // Hold the source lock so nothing modifies the metadata while the worker
+    // threads are reading it
+    QMutexLocker locker(&sourceMutex);
 
-    qreal targetDataPoints = static_cast<qreal>(_targetDataPoints);
-    qreal averageWidth = qRound(ldDecodeMetaData.getNumberOfFields() / targetDataPoints);
-    if (averageWidth < 1) averageWidth = 1; // Ensure we don't divide by zero
-    qint32 dataPoints = ldDecodeMetaData.getNumberOfFields() / static_cast<qint32>(averageWidth);
-    fieldsPerGraphDataPoint = ldDecodeMetaData.getNumberOfFields() / dataPoints;
-    if (fieldsPerGraphDataPoint < 1) fieldsPerGraphDataPoint = 1;
+    const qint32 numberOfFields = ldDecodeMetaData.getNumberOfFields();
 
-    // Get the total number of dots per field
-    qint32 totalDotsPerField = ldDecodeMetaData.getVideoParameters().fieldHeight + ldDecodeMetaData.getVideoParameters().fieldWidth;
+    // Compact per-field values
+    QVector<qint32> dropoutLength(numberOfFields);
+    QVector<float> blackSnr(numberOfFields);
+    QVector<float> whiteSnr(numberOfFields);
+    QVector<qint32> syncConf(numberOfFields);
 
-    qint32 fieldNumber = 1;
-    for (qint32 dpCount = 0; dpCount < dataPoints; dpCount++) {
-        qreal doLength = 0;
-        qreal blackSnrTotal = 0;
-        qreal whiteSnrTotal = 0;
-        qreal syncConf = 0;
-
-        // SNR data may be missing in some fields, so we count the points to prevent
-        // the average from being thrown-off by missing data
-        qreal blackSnrPoints = 0;
-        qreal whiteSnrPoints = 0;
-        for (qint32 avCount = 0; avCount < fieldsPerGraphDataPoint; avCount++) {
-            LdDecodeMetaData::Field field = ldDecodeMetaData.getField(fieldNumber);
-
-            // Get the DOs
-            if (field.dropOuts.size() > 0) {
-                // Calculate the total length of the dropouts
-                for (qint32 i = 0; i < field.dropOuts.size(); i++) {
-                    doLength += field.dropOuts.endx(i) - field.dropOuts.startx(i);
-                }
-            }
+    // Divide the fields into blocks, and extract the metrics for the blocks in
+    // parallel. (Reading from LdDecodeMetaData from multiple threads is safe,
+    // as long as nothing is modifying it at the same time.)
+    const qint32 blockSize = 1024;
+    QVector<qint32> blockStarts;
+    for (qint32 i = 0; i < numberOfFields; i += blockSize) blockStarts.append(i);
+
+    QtConcurrent::blockingMap(blockStarts, [&](qint32 &blockStart) {
+        const qint32 blockEnd = qMin(blockStart + blockSize, numberOfFields);
+        for (qint32 i = blockStart; i < blockEnd; i++) {
+            const LdDecodeMetaData::Field field = ldDecodeMetaData.getField(i + 1);
 
-            // Get the SNRs
-            if (field.vitsMetrics.inUse) {
-                if (field.vitsMetrics.bPSNR > 0) {
-                    blackSnrTotal += field.vitsMetrics.bPSNR;
-                    blackSnrPoints++;
-                }
-                if (field.vitsMetrics.wSNR > 0) {
-                    whiteSnrTotal += field.vitsMetrics.wSNR;
-                    whiteSnrPoints++;
-                }
+            // Calculate the total length of the dropouts
+            qint32 doLength = 0;
+            for (qint32 j = 0; j < field.dropOuts.size(); j++) {
+                doLength += field.dropOuts.endx(j) - field.dropOuts.startx(j);
             }
+            dropoutLength[i] = doLength;
 
-            // Get the sync confidence
-            syncConf += static_cast<qreal>(ldDecodeMetaData.getField(fieldNumber).syncConf);
+            // Get the SNRs (0 if not present)
+            blackSnr[i] = field.vitsMetrics.inUse ? static_cast<float>(field.vitsMetrics.bPSNR) : 0;
+            whiteSnr[i] = field.vitsMetrics.inUse ? static_cast<float>(field.vitsMetrics.wSNR) : 0;
 
-            // Next field...
-            fieldNumber++;
+            // Get the sync confidence
+            syncConf[i] = field.syncConf;
         }
-
-        // Calculate the average
-        doLength = doLength / static_cast<qreal>(fieldsPerGraphDataPoint);
-        blackSnrTotal = blackSnrTotal / blackSnrPoints;
-        whiteSnrTotal = whiteSnrTotal / whiteSnrPoints;
-        syncConf = syncConf / static_cast<qreal>(fieldsPerGraphDataPoint);
-
-        // Calculate the Capture Quality Index
-        qreal fieldDoPercent = 100.0 - (static_cast<qreal>(doLength) / static_cast<qreal>(totalDotsPerField * fieldsPerGraphDataPoint));
-        qreal snrPercent = 0;
-
-        // Convert SNR to linear
-        qreal whiteSnrLinear = pow(whiteSnrTotal / 20, 10);
-        qreal blackSnrLinear = pow(blackSnrTotal / 20, 10);
-        qreal snrReferenceLinear = pow(43.0 / 20, 10); // Note: 43 dB is the expected maximum
-
-        if (whiteSnrTotal != 0) snrPercent = (100.0 / (snrReferenceLinear * 2)) * (blackSnrLinear + whiteSnrLinear);
-        else snrPercent = (100.0 / snrReferenceLinear) * blackSnrLinear;
-        if (snrPercent > 100.0) snrPercent = 100.0;
-
-        // Note: The weighting is 1000:1:1 - this is just because dropouts have a greater visual effect
-        // on the resulting capture than SNR.
-        qreal captureQualityIndex = ((fieldDoPercent * 1000.0) + snrPercent + syncConf) / 1002.0;
-
-        // Add the result to the vectors
-        dropoutGraphData.append(doLength);
-        blackSnrGraphData.append(blackSnrTotal);
-        whiteSnrGraphData.append(whiteSnrTotal);
-        cqiGraphData.append(captureQualityIndex);
+    });
+
+    // Convert the values into running totals, so the average over any range
+    // of fields can be found in constant time. Element i is the total for
+    // fields 0 to i - 1. SNR data may be missing in some fields, so we count
+    // the valid points to prevent the averages being thrown off.
+    dropoutLengthTotals.resize(numberOfFields + 1);
+    blackSnrTotals.resize(numberOfFields + 1);
+    blackSnrCounts.resize(numberOfFields + 1);
+    whiteSnrTotals.resize(numberOfFields + 1);
+    whiteSnrCounts.resize(numberOfFields + 1);
+    syncConfTotals.resize(numberOfFields + 1);
+
+    dropoutLengthTotals[0] = 0;
+    blackSnrTotals[0] = 0;
+    blackSnrCounts[0] = 0;
+    whiteSnrTotals[0] = 0;
+    whiteSnrCounts[0] = 0;
+    syncConfTotals[0] = 0;
+
+    for (qint32 i = 0; i < numberOfFields; i++) {
+        dropoutLengthTotals[i + 1] = dropoutLengthTotals[i] + dropoutLength[i];
+        blackSnrTotals[i + 1] = blackSnrTotals[i] + (blackSnr[i] > 0 ? blackSnr[i] : 0);
+        blackSnrCounts[i + 1] = blackSnrCounts[i] + (blackSnr[i] > 0 ? 1 : 0);
+        whiteSnrTotals[i + 1] = whiteSnrTotals[i] + (whiteSnr[i] > 0 ? whiteSnr[i] : 0);
+        whiteSnrCounts[i + 1] = whiteSnrCounts[i] + (whiteSnr[i] > 0 ? 1 : 0);
+        syncConfTotals[i + 1] = syncConfTotals[i] + syncConf[i];
     }
 }
 
 void TbcSource::startBackgroundLoad(QString sourceFilename)
 {
+    // Nothing else uses the source until sourceReady is set at the end
+    bool isOpen = false;
+
     // Open the TBC metadata file
     qDebug() << "TbcSource::startBackgroundLoad(): Processing JSON metadata...";
     emit busyLoading("Processing JSON metadata...");
@@ -726,7 +965,7 @@ void TbcSource::startBackgroundLoad(QString sourceFilename)
             lastLoadError = "Could not open TBC data file!";
         } else {
             // Both the video and metadata files are now open
-            sourceReady = true;
+            isOpen = true;
             currentSourceFilename = sourceFilename;
         }
     }
@@ -743,28 +982,18 @@ void TbcSource::startBackgroundLoad(QString sourceFilename)
 
     // Generate the graph data for the source
     emit busyLoading("Generating graph data...");
-    generateData(2000);
+    extractFieldMetrics();
+    generateGraphData(2000);
 
-    // Generate a chapter map (used by the chapter skip
+    // Decode the VBI and build the seek index (used by the chapter skip
     // forwards and backwards buttons)
-    emit busyLoading("Generating VBI chapter map...");
-    qint32 lastChapter = -1;
-    qint32 giveUpCounter = 0;
-    chapterMap.clear();
-    for (qint32 i = 1; i <= getNumberOfFrames(); i++) {
-        qint32 currentChapter = getFrameVbi(i).chNo;
-        if (currentChapter != -1) {
-            if (currentChapter != lastChapter) {
-                lastChapter = currentChapter;
-                chapterMap.append(i);
-            } else giveUpCounter++;
-        }
+    emit busyLoading("Generating VBI seek index...");
+    ldDecodeMetaData.getChapterStarts();
 
-        if (i == 100 && giveUpCounter < 50) {
-            qDebug() << "Not seeing valid chapter numbers, giving up chapter mapping";
-            break;
-        }
-    }
+    // The source is ready for use
+    QMutexLocker renderLocker(&renderMutex);
+    QMutexLocker locker(&sourceMutex);
+    sourceReady = isOpen;
 }
 
 void TbcSource::finishBackgroundLoad()
@@ -26,7 +26,9 @@
 #define TBCSOURCE_H
 
 #include <QObject>
+#include <QCache>
 #include <QImage>
+#include <QMutex>
 #include <QPainter>
 #include <QtConcurrent/QtConcurrent>
 #include <QDebug>
@@ -47,6 +49,7 @@ class TbcSource : public QObject
     Q_OBJECT
 public:
     explicit TbcSource(QObject *parent = nullptr);
+    ~TbcSource();
 
     struct ScanLineData {
         QVector<qint32> data;
@@ -88,6 +91,7 @@ public:
     QVector<qreal> getCaptureQualityIndexGraphData();
     qint32 getGraphDataSize();
     qint32 getFieldsPerGraphDataPoint();
+    void generateGraphData(qint32 _targetDataPoints);
 
     bool getIsDropoutPresent(qint32 frameNumber);
     ScanLineData getScanLineData(qint32 frameNumber, qint32 scanLine);
@@ -122,6 +126,15 @@ private:
     QVector<qreal> cqiGraphData;
     qint32 fieldsPerGraphDataPoint;
 
+    // Running totals of the per-field metrics used for graphing (element i
+    // is the total for fields 0 to i - 1; see extractFieldMetrics)
+    QVector<qreal> dropoutLengthTotals;
+    QVector<qreal> blackSnrTotals;
+    QVector<qint32> blackSnrCounts;
+    QVector<qreal> whiteSnrTotals;
+    QVector<qint32> whiteSnrCounts;
+    QVector<qreal> syncConfTotals;
+
     // Frame image options
     bool chromaOn;
     bool dropoutsOn;
@@ -137,27 +150,52 @@ private:
     PalColour palColour;
     Comb ntscColour;
 
-    // VBI decoder
-    VbiDecoder vbiDecoder;
-
     // Background loader globals
     QFutureWatcher<void> watcher;
     QFuture <void> future;
 
-    // Cache of current frame QImage
-    QImage frameCache;
-    qint32 frameCacheFrameNumber;
+    // Protects the metadata, frame image options and frame cache, which are
+    // shared with the prefetch thread
+    QMutex sourceMutex;
+
+    // Serialises use of the source video and chroma decoders for rendering,
+    // so a render doesn't hold sourceMutex. The frame image options (and
+    // anything else rendering depends on) are only changed while holding
+    // both mutexes, so either one is enough to read them. If you need both,
+    // lock renderMutex first.
+    QMutex renderMutex;
+
+    // LRU cache of rendered frame QImages, keyed by frame number and the
+    // generation of the frame image options (see getFrameCacheKey)
+    QCache<qint64, QImage> frameCache;
+    qint32 frameCacheGeneration;
+
+    // Background prefetching of the frames following (or preceding) the
+    // current frame in the direction of navigation
+    static constexpr qint32 PREFETCH_FRAMES = 4;
+    QFuture<void> prefetchFuture;
+    QMutex prefetchMutex;
+    bool prefetchRunning;
+    bool prefetchPending;
+    bool prefetchStopping;
+    qint32 prefetchFrameNumber;
+    qint32 prefetchDirection;
+    qint32 lastRequestedFrameNumber;
 
     // Chroma decoder configuration
     PalColour::Configuration palConfiguration;
     Comb::Configuration ntscConfiguration;
-    bool decoderConfigurationChanged;
-
-    // Chapter map
-    QVector<qint32> chapterMap;
 
+    qint64 getFrameCacheKey(qint32 frameNumber);
+    bool getCachedFrameImage(qint32 frameNumber, QImage &frameImage);
+    void insertFrameImage(qint32 frameNumber, const QImage &frameImage);
+    void invalidateFrameCache();
+    void startPrefetch(qint32 frameNumber);
+    void stopPrefetch();
+    void prefetchFrames();
+    QImage renderFrameImage(qint32 frameNumber);
     QImage generateQImage(qint32 frameNumber);
-    void generateData(qint32 _targetDataPoints);
+    void extractFieldMetrics();
     void startBackgroundLoad(QString sourceFilename);
 };
 
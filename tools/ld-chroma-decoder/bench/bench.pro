@@ -0,0 +1,103 @@
+QT -= gui
+
+CONFIG += c++11 console
+CONFIG -= app_bundle
+
+TARGET = ld-chroma-decoder-bench
+
+# The following define makes your compiler emit warnings if you use
+# any feature of Qt which as been marked deprecated (the exact warnings
+# depend on your compiler). Please consult the documentation of the
+# deprecated API in order to know how to port your code away from it.
+DEFINES += QT_DEPRECATED_WARNINGS
+
+# You can also make your code fail to compile if you use deprecated APIs.
+# In order to do so, uncomment the following line.
+# You can also select to disable deprecated APIs only up to a certain version of Qt.
+#DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
+
+SOURCES += \
+    main.cpp \
+    testsource.cpp \
+    ../comb.cpp \
+    ../decoder.cpp \
+    ../decoderpool.cpp \
+    ../framecanvas.cpp \
+    ../monodecoder.cpp \
+    ../ntscdecoder.cpp \
+    ../palcolour.cpp \
+    ../paldecoder.cpp \
+    ../rgb.cpp \
+    ../sourcefield.cpp \
+    ../transformpal.cpp \
+    ../transformpal2d.cpp \
+    ../transformpal3d.cpp \
+    ../encoder/palencoder.cpp \
+    ../../library/tbc/lddecodemetadata.cpp \
+    ../../library/tbc/jsonreader.cpp \
+    ../../library/tbc/jsonwriter.cpp \
+    ../../library/tbc/sourcevideo.cpp \
+    ../../library/tbc/vbidecoder.cpp \
+    ../../library/tbc/logging.cpp \
+    ../../library/tbc/stagestats.cpp \
+    ../../library/tbc/dropouts.cpp
+
+HEADERS += \
+    testsource.h \
+    ../comb.h \
+    ../decoder.h \
+    ../decoderpool.h \
+    ../framecanvas.h \
+    ../monodecoder.h \
+    ../ntscdecoder.h \
+    ../palcolour.h \
+    ../paldecoder.h \
+    ../rgb.h \
+    ../rgbframe.h \
+    ../sourcefield.h \
+    ../transformpal.h \
+    ../transformpal2d.h \
+    ../transformpal3d.h \
+    ../yiq.h \
+    ../encoder/palencoder.h \
+    ../../library/filter/deemp.h \
+    ../../library/filter/firfilter.h \
+    ../../library/filter/iirfilter.h \
+    ../../library/tbc/lddecodemetadata.h \
+    ../../library/tbc/jsonreader.h \
+    ../../library/tbc/jsonwriter.h \
+    ../../library/tbc/sourcevideo.h \
+    ../../library/tbc/vbidecoder.h \
+    ../../library/tbc/logging.h \
+    ../../library/tbc/stagestats.h \
+    ../../library/tbc/dropouts.h
+
+# Add external includes to the include path
+INCLUDEPATH += ..
+INCLUDEPATH += ../encoder
+INCLUDEPATH += ../../library/filter
+INCLUDEPATH += ../../library/tbc
+
+# Include git information definitions
+isEmpty(BRANCH) {
+    BRANCH = "unknown"
+}
+isEmpty(COMMIT) {
+    COMMIT = "unknown"
+}
+DEFINES += APP_BRANCH=\"\\\"$${BRANCH}\\\"\" \
+    APP_COMMIT=\"\\\"$${COMMIT}\\\"\"
+
+# Rules for installation
+isEmpty(PREFIX) {
+    PREFIX = /usr/local
+}
+unix:!android: target.path = $$PREFIX/bin/
+!isEmpty(target.path): INSTALLS += target
+
+macx {
+INCLUDEPATH += "/usr/local/include"
+}
+
+LIBS += -L"/usr/local/lib"
+LIBS += -lfftw3
@@ -0,0 +1,378 @@
+/************************************************************************
+
+    main.cpp
+
+    ld-chroma-decoder-bench - Benchmark for the chroma decoders
+    Copyright (C) 2026 agent
+
+    This file is part of ld-decode-tools.
+
+    ld-chroma-decoder-bench is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+************************************************************************/
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QtGlobal>
+#include <QCommandLineParser>
+#include <QScopedPointer>
+#include <QThread>
+#include <cstdio>
+
+#ifdef Q_OS_UNIX
+#include <sys/resource.h>
+#endif
+
+#include "decoderpool.h"
+#include "jsonwriter.h"
+#include "lddecodemetadata.h"
+#include "logging.h"
+#include "stagestats.h"
+
+#include "comb.h"
+#include "monodecoder.h"
+#include "ntscdecoder.h"
+#include "palcolour.h"
+#include "paldecoder.h"
+#include "transformpal.h"
+
+#include "testsource.h"
+
+// The decoders that can be benchmarked, in the order they're run
+static const QStringList ALL_DECODERS = {
+    "pal2d", "transform2d", "transform3d", "ntsc1d", "ntsc2d", "ntsc3d", "mono"
+};
+
+// Reset the process's peak resident set size, so the next call to
+// getPeakRssKiB only covers what happens in between. This is only possible
+// on Linux; elsewhere, the peak is for the whole run so far.
+static void resetPeakRss()
+{
+#ifdef Q_OS_LINUX
+    QFile clearRefs("/proc/self/clear_refs");
+    if (clearRefs.open(QIODevice::WriteOnly)) {
+        clearRefs.write("5");
+        clearRefs.close();
+    }
+#endif
+}
+
+// Get the process's peak resident set size in KiB, or -1 if unknown
+static qint64 getPeakRssKiB()
+{
+#if defined(Q_OS_LINUX)
+    // VmHWM reflects resetPeakRss, unlike getrusage
+    QFile status("/proc/self/status");
+    if (!status.open(QIODevice::ReadOnly)) return -1;
+
+    for (const QByteArray &line : status.readAll().split('\n')) {
+        if (line.startsWith("VmHWM:")) {
+            return line.mid(6).trimmed().split(' ').first().toLongLong();
+        }
+    }
+    return -1;
+#elif defined(Q_OS_UNIX)
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return -1;
+#ifdef Q_OS_DARWIN
+    // macOS reports bytes rather than KiB
+    return usage.ru_maxrss / 1024;
+#else
+    return usage.ru_maxrss;
+#endif
+#else
+    return -1;
+#endif
+}
+
+int main(int argc, char *argv[])
+{
+    // Install the local debug message handler
+    setDebug(true);
+    qInstallMessageHandler(debugOutputHandler);
+
+    QCoreApplication a(argc, argv);
+
+    // Set application name and version
+    QCoreApplication::setApplicationName("ld-chroma-decoder-bench");
+    QCoreApplication::setApplicationVersion(QString("Branch: %1 / Commit: %2").arg(APP_BRANCH, APP_COMMIT));
+    QCoreApplication::setOrganizationDomain("domesday86.com");
+
+    // Set up the command line parser
+    QCommandLineParser parser;
+    parser.setApplicationDescription(
+                "ld-chroma-decoder-bench - Benchmark for the chroma decoders\n"
+                "\n"
+                "Decodes synthetic PAL and NTSC material held in memory with each\n"
+                "decoder, and reports the results as JSON.\n"
+                "\n"
+                "(c)2026 agent\n"
+                "GPLv3 Open-Source - github: https://github.com/happycube/ld-decode");
+    parser.addHelpOption();
+    parser.addVersionOption();
+
+    // -- General options --
+
+    // Add the standard debug options --debug and --quiet
+    addStandardDebugOptions(parser);
+
+    // Option to select the number of frames (-n)
+    QCommandLineOption framesOption(QStringList() << "n" << "frames",
+                                    QCoreApplication::translate("main", "Specify the number of frames to decode (default 32)"),
+                                    QCoreApplication::translate("main", "number"));
+    parser.addOption(framesOption);
+
+    // Option to select which decoders to run (-f)
+    QCommandLineOption decoderOption(QStringList() << "f" << "decoder",
+                                     QCoreApplication::translate("main", "Decoder to benchmark; may be given more than once (pal2d, transform2d, transform3d, ntsc1d, ntsc2d, ntsc3d, mono; default all)"),
+                                     QCoreApplication::translate("main", "decoder"));
+    parser.addOption(decoderOption);
+
+    // Option to select the maximum number of threads (-t)
+    QCommandLineOption threadsOption(QStringList() << "t" << "threads",
+                                     QCoreApplication::translate("main", "Specify the maximum number of concurrent threads; each decoder is run with 1, 2, 4... threads up to this (default number of logical CPUs)"),
+                                     QCoreApplication::translate("main", "number"));
+    parser.addOption(threadsOption);
+
+    // -- Positional arguments --
+
+    // Positional argument to specify output JSON file
+    parser.addPositionalArgument("output", QCoreApplication::translate("main", "Specify output JSON file (omit or - for piped output)"));
+
+    // Process the command line options and arguments given by the user
+    parser.process(a);
+
+    // Standard logging options
+    processStandardDebugOptions(parser);
+
+    // Get the arguments from the parser
+    QString outputFileName = "-";
+    QStringList positionalArguments = parser.positionalArguments();
+    if (positionalArguments.count() == 1) {
+        outputFileName = positionalArguments.at(0);
+    } else if (positionalArguments.count() > 1) {
+        // Quit with error
+        qCritical("You may only specify one output file");
+        return -1;
+    }
+
+    qint32 numFrames = 32;
+    if (parser.isSet(framesOption)) {
+        numFrames = parser.value(framesOption).toInt();
+
+        if (numFrames < 1) {
+            // Quit with error
+            qCritical("Specified number of frames must be at least 1");
+            return -1;
+        }
+    }
+
+    qint32 maxThreads = QThread::idealThreadCount();
+    if (parser.isSet(threadsOption)) {
+        maxThreads = parser.value(threadsOption).toInt();
+
+        if (maxThreads < 1) {
+            // Quit with error
+            qCritical("Specified number of threads must be greater than zero");
+            return -1;
+        }
+    }
+
+    QStringList decoderNames = ALL_DECODERS;
+    if (parser.isSet(decoderOption)) {
+        decoderNames = parser.values(decoderOption);
+
+        for (const QString &decoderName : decoderNames) {
+            if (!ALL_DECODERS.contains(decoderName)) {
+                // Quit with error
+                qCritical() << "Unknown decoder" << decoderName;
+                return -1;
+            }
+        }
+    }
+
+    // Plan FFTs for the Transform decoders without using the wisdom cache, so
+    // the configure time reflects the planning the decoder really does
+    TransformPal::configurePlanner(false, QString());
+
+    // Generate the input material. This is done up front, so only the
+    // decoding is included in the timings.
+    QElapsedTimer timer;
+    bool needPal = false;
+    bool needNtsc = false;
+    for (const QString &decoderName : decoderNames) {
+        if (decoderName.startsWith("ntsc")) needNtsc = true;
+        else needPal = true;
+    }
+
+    LdDecodeMetaData palMetaData;
+    QVector<SourceVideo::Data> palFields;
+    qint64 palSynthesisNsecs = 0;
+    if (needPal) {
+        qInfo() << "Generating" << numFrames << "frames of PAL";
+        timer.start();
+        if (!makePalSource(numFrames, palMetaData, palFields)) {
+            return -1;
+        }
+        palSynthesisNsecs = timer.nsecsElapsed();
+    }
+
+    LdDecodeMetaData ntscMetaData;
+    QVector<SourceVideo::Data> ntscFields;
+    qint64 ntscSynthesisNsecs = 0;
+    if (needNtsc) {
+        qInfo() << "Generating" << numFrames << "frames of NTSC";
+        timer.start();
+        makeNtscSource(numFrames, ntscMetaData, ntscFields);
+        ntscSynthesisNsecs = timer.nsecsElapsed();
+    }
+
+    // Collect per-stage timings for each run
+    StageStats::setEnabled(true);
+
+    // Work out the thread counts to try: powers of two, and the maximum
+    QVector<qint32> threadCounts;
+    for (qint32 threads = 1; threads < maxThreads; threads *= 2) {
+        threadCounts.append(threads);
+    }
+    threadCounts.append(maxThreads);
+
+    // Start the report
+    QByteArray report;
+    JsonWriter writer(report);
+    writer.beginObject();
+    writer.writeMember("frames");
+    writer.write(numFrames);
+    writer.writeMember("maxThreads");
+    writer.write(maxThreads);
+    writer.writeMember("idealThreadCount");
+    writer.write(static_cast<qint32>(QThread::idealThreadCount()));
+
+    writer.writeMember("sources");
+    writer.beginObject();
+    if (needPal) {
+        writer.writeMember("pal");
+        writer.beginObject();
+        writer.writeMember("synthesisNsecs");
+        writer.write(palSynthesisNsecs);
+        writer.endObject();
+    }
+    if (needNtsc) {
+        writer.writeMember("ntsc");
+        writer.beginObject();
+        writer.writeMember("synthesisNsecs");
+        writer.write(ntscSynthesisNsecs);
+        writer.endObject();
+    }
+    writer.endObject();
+
+    writer.writeMember("results");
+    writer.beginArray();
+
+    for (const QString &decoderName : decoderNames) {
+        // Mono can decode either; use PAL, as the larger frame
+        const bool isNtsc = decoderName.startsWith("ntsc");
+        LdDecodeMetaData &metaData = isNtsc ? ntscMetaData : palMetaData;
+        const QVector<SourceVideo::Data> &fields = isNtsc ? ntscFields : palFields;
+
+        for (qint32 threads : threadCounts) {
+            // Construct a fresh decoder for each run, with default settings
+            PalColour::Configuration palConfig;
+            Comb::Configuration combConfig;
+            QScopedPointer<Decoder> decoder;
+            if (decoderName == "pal2d") {
+                decoder.reset(new PalDecoder(palConfig));
+            } else if (decoderName == "transform2d") {
+                palConfig.chromaFilter = PalColour::transform2DFilter;
+                decoder.reset(new PalDecoder(palConfig));
+            } else if (decoderName == "transform3d") {
+                palConfig.chromaFilter = PalColour::transform3DFilter;
+                decoder.reset(new PalDecoder(palConfig));
+            } else if (decoderName == "ntsc1d") {
+                combConfig.dimensions = 1;
+                decoder.reset(new NtscDecoder(combConfig));
+            } else if (decoderName == "ntsc2d") {
+                combConfig.dimensions = 2;
+                decoder.reset(new NtscDecoder(combConfig));
+            } else if (decoderName == "ntsc3d") {
+                combConfig.dimensions = 3;
+                decoder.reset(new NtscDecoder(combConfig));
+            } else {
+                decoder.reset(new MonoDecoder);
+            }
+
+            qInfo().noquote() << "Benchmarking" << decoderName << "with" << threads << "threads";
+
+            resetPeakRss();
+            StageStats::reset();
+            DecoderPool decoderPool(*decoder, fields, metaData, threads);
+            if (!decoderPool.process()) {
+                qCritical() << "Decoding failed";
+                return -1;
+            }
+            const qint64 peakRssKiB = getPeakRssKiB();
+
+            const qint64 decodeNsecs = decoderPool.getDecodeNsecs();
+            const double framesPerSecond = (decodeNsecs == 0) ? 0.0 : (numFrames * 1.0e9) / decodeNsecs;
+
+            writer.beginObject();
+            writer.writeMember("decoder");
+            writer.write(decoderName);
+            writer.writeMember("system");
+            writer.write(QString(isNtsc ? "ntsc" : "pal"));
+            writer.writeMember("threads");
+            writer.write(threads);
+            writer.writeMember("configureNsecs");
+            writer.write(decoderPool.getConfigureNsecs());
+            writer.writeMember("decodeNsecs");
+            writer.write(decodeNsecs);
+            writer.writeMember("framesPerSecond");
+            writer.write(framesPerSecond);
+            writer.writeMember("peakRssKiB");
+            writer.write(peakRssKiB);
+            writer.writeMember("stageStats");
+            StageStats::writeJson(writer);
+            writer.endObject();
+        }
+    }
+
+    writer.endArray();
+    writer.endObject();
+    report.append('\n');
+
+    // Write the report
+    QFile outputFile;
+    if (outputFileName == "-") {
+        if (!outputFile.open(stdout, QIODevice::WriteOnly)) {
+            qCritical() << "Could not open stdout for JSON output";
+            return -1;
+        }
+    } else {
+        outputFile.setFileName(outputFileName);
+        if (!outputFile.open(QIODevice::WriteOnly)) {
+            qCritical() << "Could not open" << outputFileName << "as JSON output file";
+            return -1;
+        }
+    }
+    if (outputFile.write(report) != report.size()) {
+        qCritical() << "Writing to the output JSON file failed";
+        return -1;
+    }
+    outputFile.close();
+
+    // Quit with success
+    return 0;
+}
@@ -0,0 +1,225 @@
+/************************************************************************
+
+    testsource.cpp
+
+    ld-chroma-decoder-bench - Benchmark for the chroma decoders
+    Copyright (C) 2026 agent
+
+    This file is part of ld-decode-tools.
+
+    ld-chroma-decoder-bench is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+************************************************************************/
+
+#include "testsource.h"
+
+#include <QBuffer>
+#include <QtMath>
+
+#include <cmath>
+#include <cstring>
+
+#include "palencoder.h"
+
+// Size of the RGB frames PALEncoder expects
+static constexpr qint32 RGB_WIDTH = 928;
+static constexpr qint32 RGB_HEIGHT = 576;
+static constexpr qint64 RGB_FRAME_BYTES = RGB_WIDTH * RGB_HEIGHT * 3 * 2;
+
+// Distance the bars move each frame, as a fraction of the picture width
+static constexpr double BARS_SPEED = 2.0 / RGB_WIDTH;
+
+ColourBarsRgbDevice::ColourBarsRgbDevice(qint32 _numFrames)
+    : numFrames(_numFrames), position(0), bufferFrame(-1)
+{
+}
+
+bool ColourBarsRgbDevice::isSequential() const
+{
+    return true;
+}
+
+qint64 ColourBarsRgbDevice::readData(char *data, qint64 maxSize)
+{
+    const qint32 frameNo = static_cast<qint32>(position / RGB_FRAME_BYTES);
+    if (frameNo >= numFrames) {
+        // End of input
+        return 0;
+    }
+
+    if (frameNo != bufferFrame) generateFrame(frameNo);
+
+    // Return data up to the end of this frame
+    const qint64 offset = position - (frameNo * RGB_FRAME_BYTES);
+    const qint64 count = qMin(maxSize, RGB_FRAME_BYTES - offset);
+    memcpy(data, buffer.constData() + offset, static_cast<size_t>(count));
+    position += count;
+
+    return count;
+}
+
+qint64 ColourBarsRgbDevice::writeData(const char *, qint64)
+{
+    // This device is read-only
+    return -1;
+}
+
+// Generate one RGB frame into the buffer
+void ColourBarsRgbDevice::generateFrame(qint32 frameNo)
+{
+    buffer.resize(static_cast<qint32>(RGB_FRAME_BYTES));
+    quint16 *rgbData = reinterpret_cast<quint16 *>(buffer.data());
+
+    // The bars are vertical, so all the lines are the same
+    for (qint32 x = 0; x < RGB_WIDTH; x++) {
+        double r, g, b;
+        getColourBars(frameNo, static_cast<double>(x) / RGB_WIDTH, r, g, b);
+        rgbData[(x * 3)]     = static_cast<quint16>(r * 65535.0);
+        rgbData[(x * 3) + 1] = static_cast<quint16>(g * 65535.0);
+        rgbData[(x * 3) + 2] = static_cast<quint16>(b * 65535.0);
+    }
+    for (qint32 y = 1; y < RGB_HEIGHT; y++) {
+        memcpy(rgbData + (y * RGB_WIDTH * 3), rgbData, RGB_WIDTH * 3 * sizeof(quint16));
+    }
+
+    bufferFrame = frameNo;
+}
+
+void getColourBars(qint32 frameNo, double x, double &r, double &g, double &b)
+{
+    // White, yellow, cyan, green, magenta, red, blue, black
+    double pos = x + (frameNo * BARS_SPEED);
+    const qint32 bar = static_cast<qint32>((pos - std::floor(pos)) * 8) % 8;
+
+    r = (bar == 0 || bar == 1 || bar == 4 || bar == 5) ? 0.75 : 0.0;
+    g = (bar == 0 || bar == 1 || bar == 2 || bar == 3) ? 0.75 : 0.0;
+    b = (bar == 0 || bar == 2 || bar == 4 || bar == 6) ? 0.75 : 0.0;
+}
+
+bool makePalSource(qint32 numFrames, LdDecodeMetaData &metaData, QVector<SourceVideo::Data> &fields)
+{
+    ColourBarsRgbDevice rgbDevice(numFrames);
+    rgbDevice.open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+
+    QByteArray tbcData;
+    QBuffer tbcBuffer(&tbcData);
+    tbcBuffer.open(QIODevice::WriteOnly);
+
+    PALEncoder encoder(rgbDevice, tbcBuffer, metaData, false);
+    if (!encoder.encode()) {
+        return false;
+    }
+
+    tbcBuffer.close();
+    rgbDevice.close();
+
+    // Split the TBC data into fields
+    const LdDecodeMetaData::VideoParameters videoParameters = metaData.getVideoParameters();
+    const qint32 fieldLength = videoParameters.fieldWidth * videoParameters.fieldHeight;
+    const qint32 numFields = metaData.getNumberOfFields();
+    if (tbcData.size() != static_cast<qint64>(numFields) * fieldLength * 2) {
+        qCritical() << "Encoder produced the wrong amount of TBC data";
+        return false;
+    }
+
+    fields.resize(numFields);
+    for (qint32 i = 0; i < numFields; i++) {
+        fields[i].resize(fieldLength);
+        memcpy(fields[i].data(), tbcData.constData() + (static_cast<qint64>(i) * fieldLength * 2), fieldLength * 2);
+    }
+
+    return true;
+}
+
+void makeNtscSource(qint32 numFrames, LdDecodeMetaData &metaData, QVector<SourceVideo::Data> &fields)
+{
+    // Parameters matching ld-decode's usual NTSC output
+    LdDecodeMetaData::VideoParameters videoParameters;
+    videoParameters.isSourcePal = false;
+    videoParameters.isSubcarrierLocked = false;
+    videoParameters.colourBurstStart = 74;
+    videoParameters.colourBurstEnd = 110;
+    videoParameters.activeVideoStart = 134;
+    videoParameters.activeVideoEnd = 894;
+    videoParameters.white16bIre = 0xC800;
+    videoParameters.black16bIre = 0x3C00;
+    videoParameters.fieldWidth = 910;
+    videoParameters.fieldHeight = 263;
+    videoParameters.fsc = 3579545;
+    videoParameters.sampleRate = 4 * videoParameters.fsc;
+    videoParameters.isMapped = false;
+
+    const double black = videoParameters.black16bIre;
+    const double ire = (videoParameters.white16bIre - videoParameters.black16bIre) / 100.0;
+    const qint32 activeWidth = videoParameters.activeVideoEnd - videoParameters.activeVideoStart;
+
+    // Active frame lines, as given by LdDecodeMetaData for NTSC
+    const qint32 firstActiveFrameLine = 40;
+    const qint32 lastActiveFrameLine = 525;
+
+    fields.resize(numFrames * 2);
+    for (qint32 fieldNo = 0; fieldNo < fields.size(); fieldNo++) {
+        const qint32 frameNo = fieldNo / 2;
+        const bool isFirstField = (fieldNo % 2) == 0;
+
+        // The four-field colour sequence runs 1, 2, 3, 4
+        LdDecodeMetaData::Field fieldData;
+        fieldData.isFirstField = isFirstField;
+        fieldData.syncConf = 100;
+        fieldData.medianBurstIRE = 20.0;
+        fieldData.fieldPhaseID = (fieldNo % 4) + 1;
+        fieldData.audioSamples = 0;
+        metaData.appendField(fieldData);
+
+        // Burst is rising at the start of even lines in fields 1 and 4, and
+        // flips on each following line -- see Comb::FrameBuffer::getLinePhase
+        const bool isPositivePhaseOnEvenLines = (fieldData.fieldPhaseID == 1) || (fieldData.fieldPhaseID == 4);
+
+        SourceVideo::Data &data = fields[fieldNo];
+        data.resize(videoParameters.fieldWidth * videoParameters.fieldHeight);
+
+        for (qint32 fieldLine = 0; fieldLine < videoParameters.fieldHeight; fieldLine++) {
+            quint16 *line = data.data() + (fieldLine * videoParameters.fieldWidth);
+            const qint32 frameLine = (fieldLine * 2) + (isFirstField ? 0 : 1);
+            const bool isEvenLine = (fieldLine % 2) == 0;
+            const double linePhase = (isEvenLine == isPositivePhaseOnEvenLines) ? 0.0 : M_PI;
+            const bool isActive = frameLine >= firstActiveFrameLine && frameLine < lastActiveFrameLine;
+
+            for (qint32 x = 0; x < videoParameters.fieldWidth; x++) {
+                // The subcarrier is sampled at 0, 90, 180 and 270 degrees
+                const double phase = (x * M_PI / 2.0) + linePhase;
+                double value = black;
+
+                if (x >= videoParameters.colourBurstStart && x < videoParameters.colourBurstEnd) {
+                    // Burst at 180 degrees, 40 IRE peak-to-peak
+                    value -= 20.0 * ire * std::sin(phase);
+                } else if (isActive && x >= videoParameters.activeVideoStart && x < videoParameters.activeVideoEnd) {
+                    double r, g, b;
+                    getColourBars(frameNo, static_cast<double>(x - videoParameters.activeVideoStart) / activeWidth, r, g, b);
+
+                    const double y = (0.299 * r) + (0.587 * g) + (0.114 * b);
+                    const double u = 0.492 * (b - y);
+                    const double v = 0.877 * (r - y);
+
+                    value += 100.0 * ire * (y + (u * std::sin(phase)) + (v * std::cos(phase)));
+                }
+
+                line[x] = static_cast<quint16>(qBound(0.0, value, 65535.0));
+            }
+        }
+    }
+
+    // Store video parameters, now we've generated all the fields
+    metaData.setVideoParameters(videoParameters);
+}
@@ -0,0 +1,78 @@
+/************************************************************************
+
+    testsource.h
+
+    ld-chroma-decoder-bench - Benchmark for the chroma decoders
+    Copyright (C) 2026 agent
+
+    This file is part of ld-decode-tools.
+
+    ld-chroma-decoder-bench is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+************************************************************************/
+
+#ifndef TESTSOURCE_H
+#define TESTSOURCE_H
+
+#include <QByteArray>
+#include <QIODevice>
+#include <QVector>
+
+#include "lddecodemetadata.h"
+#include "sourcevideo.h"
+
+// Synthetic test material for the benchmark, generated in memory.
+//
+// The picture is a set of 75% colour bars, which moves horizontally by a
+// couple of samples each frame so that the 3D decoders see some motion.
+
+// Sequential device that produces RGB frames in the format PALEncoder reads
+// (928 x 576, RGB48 in native byte order), generating each frame as it's
+// needed rather than holding the whole sequence in memory.
+class ColourBarsRgbDevice : public QIODevice
+{
+public:
+    ColourBarsRgbDevice(qint32 numFrames);
+
+    bool isSequential() const override;
+
+protected:
+    qint64 readData(char *data, qint64 maxSize) override;
+    qint64 writeData(const char *data, qint64 maxSize) override;
+
+private:
+    qint32 numFrames;
+    qint64 position;
+    qint32 bufferFrame;
+    QByteArray buffer;
+
+    void generateFrame(qint32 frameNo);
+};
+
+// Get the colour of the bars at horizontal position x (0-1) in the given
+// frame, as R'G'B' values in the range 0-1
+void getColourBars(qint32 frameNo, double x, double &r, double &g, double &b);
+
+// Generate numFrames frames of PAL, using PALEncoder with line-locked
+// sampling.
+// Returns true on success; on failure, prints an error and returns false.
+bool makePalSource(qint32 numFrames, LdDecodeMetaData &metaData, QVector<SourceVideo::Data> &fields);
+
+// Generate numFrames frames of 4fSC NTSC, with the subcarrier phase following
+// each field's fieldPhaseID as the NTSC decoder expects. This is a much
+// simpler encoder than PALEncoder (no filtering, no sync pulses), but gives
+// the decoders realistic work to do.
+void makeNtscSource(qint32 numFrames, LdDecodeMetaData &metaData, QVector<SourceVideo::Data> &fields);
+
+#endif // TESTSOURCE_H
@@ -25,6 +25,7 @@
 #include "decoder.h"
 
 #include "decoderpool.h"
+#include "stagestats.h"
 
 qint32 Decoder::getLookBehind() const
 {
@@ -130,7 +131,9 @@ void DecoderThread::run()
         outputFrames.resize((endIndex - startIndex) / 2);
 
         // Decode the fields to frames
+        StageTimer decodeTimer("decode");
         decodeFrames(inputFields, startIndex, endIndex, outputFrames);
+        decodeTimer.stop();
 
         // Write the frames to the output file
         if (!decoderPool.putOutputFrames(startFrameNumber, outputFrames)) {
@@ -24,6 +24,8 @@
 
 #include "decoderpool.h"
 
+#include "stagestats.h"
+
 // Definitions of static constexpr data members, for compatibility with
 // pre-C++17 compilers
 constexpr qint32 DecoderPool::DEFAULT_BATCH_SIZE;
@@ -34,6 +36,15 @@ DecoderPool::DecoderPool(Decoder &_decoder, QString _inputFileName,
     : decoder(_decoder), inputFileName(_inputFileName),
       outputFileName(_outputFileName), startFrame(_startFrame),
       length(_length), maxThreads(_maxThreads),
+      inputFields(nullptr), configureNsecs(0), decodeNsecs(0),
+      abort(false), ldDecodeMetaData(_ldDecodeMetaData)
+{
+}
+
+DecoderPool::DecoderPool(Decoder &_decoder, const QVector<SourceVideo::Data> &_inputFields,
+                         LdDecodeMetaData &_ldDecodeMetaData, qint32 _maxThreads)
+    : decoder(_decoder), startFrame(-1), length(-1), maxThreads(_maxThreads),
+      inputFields(&_inputFields), configureNsecs(0), decodeNsecs(0),
       abort(false), ldDecodeMetaData(_ldDecodeMetaData)
 {
 }
@@ -43,16 +54,24 @@ bool DecoderPool::process()
     LdDecodeMetaData::VideoParameters videoParameters = ldDecodeMetaData.getVideoParameters();
 
     // Configure the decoder, and check that it can accept this video
+    QElapsedTimer configureTimer;
+    configureTimer.start();
     if (!decoder.configure(videoParameters)) {
         return false;
     }
+    configureNsecs = configureTimer.nsecsElapsed();
 
     // Get the decoder's lookbehind/lookahead requirements
     decoderLookBehind = decoder.getLookBehind();
     decoderLookAhead = decoder.getLookAhead();
 
-    // Open the source video file
-    if (!sourceVideo.open(inputFileName, videoParameters.fieldWidth * videoParameters.fieldHeight)) {
+    if (inputFields != nullptr) {
+        // Check the in-memory input matches the metadata
+        if (inputFields->size() != ldDecodeMetaData.getNumberOfFields()) {
+            qCritical() << "Number of input fields does not match the metadata";
+            return false;
+        }
+    } else if (!sourceVideo.open(inputFileName, videoParameters.fieldWidth * videoParameters.fieldHeight)) {
         // Could not open source video file
         qInfo() << "Unable to open ld-decode video file";
         return false;
@@ -77,7 +96,9 @@ bool DecoderPool::process()
     }
 
     // Open the output RGB file
-    if (outputFileName == "-") {
+    if (inputFields != nullptr) {
+        // The output will be discarded
+    } else if (outputFileName == "-") {
         // No output filename, use stdout instead
         if (!targetVideo.open(stdout, QIODevice::WriteOnly)) {
             // Failed to open stdout
@@ -136,6 +157,8 @@ bool DecoderPool::process()
         return false;
     }
 
+    decodeNsecs = totalTimer.nsecsElapsed();
+
     double totalSecs = (static_cast<double>(totalTimer.elapsed()) / 1000.0);
     qInfo() << "Processing complete -" << length << "frames in" << totalSecs << "seconds (" <<
                length / totalSecs << "FPS )";
@@ -149,8 +172,19 @@ bool DecoderPool::process()
     return true;
 }
 
+qint64 DecoderPool::getConfigureNsecs() const
+{
+    return configureNsecs;
+}
+
+qint64 DecoderPool::getDecodeNsecs() const
+{
+    return decodeNsecs;
+}
+
 bool DecoderPool::getInputFrames(qint32 &startFrameNumber, QVector<SourceField> &fields, qint32 &startIndex, qint32 &endIndex)
 {
+    StageTimer timer("input");
     QMutexLocker locker(&inputMutex);
 
     // Work out a reasonable batch size to provide work for all threads.
@@ -171,15 +205,22 @@ bool DecoderPool::getInputFrames(qint32 &startFrameNumber, QVector<SourceField>
     inputFrameNumber += batchFrames;
 
     // Load the fields
-    SourceField::loadFields(sourceVideo, ldDecodeMetaData,
-                            startFrameNumber, batchFrames, decoderLookBehind, decoderLookAhead,
-                            fields, startIndex, endIndex);
+    if (inputFields != nullptr) {
+        SourceField::loadFields(*inputFields, ldDecodeMetaData,
+                                startFrameNumber, batchFrames, decoderLookBehind, decoderLookAhead,
+                                fields, startIndex, endIndex);
+    } else {
+        SourceField::loadFields(sourceVideo, ldDecodeMetaData,
+                                startFrameNumber, batchFrames, decoderLookBehind, decoderLookAhead,
+                                fields, startIndex, endIndex);
+    }
 
     return true;
 }
 
 bool DecoderPool::putOutputFrames(qint32 startFrameNumber, const QVector<RGBFrame> &outputFrames)
 {
+    StageTimer timer("output");
     QMutexLocker locker(&outputMutex);
 
     for (qint32 i = 0; i < outputFrames.size(); i++) {
@@ -209,7 +250,7 @@ bool DecoderPool::putOutputFrame(qint32 frameNumber, const RGBFrame &outputFrame
         const RGBFrame& outputData = pendingOutputFrames.value(outputFrameNumber);
 
         // Save the frame data to the output file
-        if (!targetVideo.write(reinterpret_cast<const char *>(outputData.data()), outputData.size() * 2)) {
+        if (inputFields == nullptr && !targetVideo.write(reinterpret_cast<const char *>(outputData.data()), outputData.size() * 2)) {
             // Could not write to target video file
             qCritical() << "Writing to the output video file failed";
             return false;
@@ -217,6 +258,7 @@ bool DecoderPool::putOutputFrame(qint32 frameNumber, const RGBFrame &outputFrame
 
         pendingOutputFrames.remove(outputFrameNumber);
         outputFrameNumber++;
+        StageStats::count("frames");
 
         const qint32 outputCount = outputFrameNumber - startFrame;
         if ((outputCount % 32) == 0) {
@@ -46,10 +46,22 @@ public:
                          LdDecodeMetaData &ldDecodeMetaData, QString outputFileName,
                          qint32 startFrame, qint32 length, qint32 maxThreads);
 
+    // Decode fields held in memory rather than reading them from a file.
+    // inputFields contains the data for every field in the metadata, and the
+    // output is discarded. This is used for benchmarking the decoders.
+    explicit DecoderPool(Decoder &decoder, const QVector<SourceVideo::Data> &inputFields,
+                         LdDecodeMetaData &ldDecodeMetaData, qint32 maxThreads);
+
     // Decode fields to frames as specified by the constructor args.
     // Returns true on success; on failure, prints a message and returns false.
     bool process();
 
+    // Get the time taken by the last call to process() to configure the
+    // decoder, and to decode the frames (including starting and stopping the
+    // worker threads), in nanoseconds
+    qint64 getConfigureNsecs() const;
+    qint64 getDecodeNsecs() const;
+
     // For worker threads: get the next batch of data from the input file.
     //
     // fields will be resized and filled with pairs of SourceFields; entries
@@ -87,6 +99,9 @@ private:
     qint32 startFrame;
     qint32 length;
     qint32 maxThreads;
+    const QVector<SourceVideo::Data> *inputFields;
+    qint64 configureNsecs;
+    qint64 decodeNsecs;
 
     // Atomic abort flag shared by worker threads; workers watch this, and shut
     // down as soon as possible if it becomes true
@@ -20,6 +20,8 @@ SOURCES += \
     main.cpp \
     palencoder.cpp \
     ../../library/tbc/lddecodemetadata.cpp \
+    ../../library/tbc/jsonreader.cpp \
+    ../../library/tbc/jsonwriter.cpp \
     ../../library/tbc/logging.cpp \
     ../../library/tbc/vbidecoder.cpp \
     ../../library/tbc/dropouts.cpp
@@ -28,6 +30,8 @@ HEADERS += \
     palencoder.h \
     ../../library/filter/firfilter.h \
     ../../library/tbc/lddecodemetadata.h \
+    ../../library/tbc/jsonreader.h \
+    ../../library/tbc/jsonwriter.h \
     ../../library/tbc/logging.h \
     ../../library/tbc/vbidecoder.h \
     ../../library/tbc/dropouts.h
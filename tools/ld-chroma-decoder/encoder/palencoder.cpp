@@ -49,7 +49,7 @@
 #include <array>
 #include <cmath>
 
-PALEncoder::PALEncoder(QFile &_rgbFile, QFile &_tbcFile, LdDecodeMetaData &_metaData, bool _scLocked)
+PALEncoder::PALEncoder(QIODevice &_rgbFile, QIODevice &_tbcFile, LdDecodeMetaData &_metaData, bool _scLocked)
     : rgbFile(_rgbFile), tbcFile(_tbcFile), metaData(_metaData), scLocked(_scLocked)
 {
     // PAL subcarrier frequency [Poynton p529] [EBU p5]
@@ -298,7 +298,7 @@ static constexpr std::array<double, 13> uvFilterCoeffs {
     0.21375585039760908, 0.2677488885178237, 0.21375585039760908, 0.10876496139131472, 0.035272860169480155,
     0.007290763490157312, 0.0009604748783110286, 8.06454142158873e-05
 };
-static constexpr auto uvFilter = makeFIRFilter(uvFilterCoeffs);
+static constexpr auto uvFilter = makeSymmetricFIRFilter(uvFilterCoeffs);
 
 void PALEncoder::encodeLine(qint32 fieldNo, qint32 frameLine, const quint16 *rgbData, QVector<quint16> &outputLine)
 {
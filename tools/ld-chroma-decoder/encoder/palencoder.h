@@ -26,7 +26,7 @@
 #define PALENCODER_H
 
 #include <QByteArray>
-#include <QFile>
+#include <QIODevice>
 #include <QVector>
 
 #include "lddecodemetadata.h"
@@ -34,7 +34,7 @@
 class PALEncoder
 {
 public:
-    PALEncoder(QFile &rgbFile, QFile &tbcFile, LdDecodeMetaData &metaData, bool scLocked);
+    PALEncoder(QIODevice &rgbFile, QIODevice &tbcFile, LdDecodeMetaData &metaData, bool scLocked);
 
     // Encode RGB stream to PAL.
     // Returns true on success; on failure, prints an error and returns false.
@@ -45,8 +45,8 @@ private:
     bool encodeField(qint32 fieldNo);
     void encodeLine(qint32 fieldNo, qint32 frameLine, const quint16 *rgbData, QVector<quint16> &outputLine);
 
-    QFile &rgbFile;
-    QFile &tbcFile;
+    QIODevice &rgbFile;
+    QIODevice &tbcFile;
     LdDecodeMetaData &metaData;
     bool scLocked;
 
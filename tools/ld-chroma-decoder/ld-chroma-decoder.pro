@@ -30,9 +30,13 @@ SOURCES += \
     transformpal2d.cpp \
     transformpal3d.cpp \
     ../library/tbc/lddecodemetadata.cpp \
+    ../library/tbc/jsonreader.cpp \
+    ../library/tbc/jsonwriter.cpp \
     ../library/tbc/sourcevideo.cpp \
     ../library/tbc/vbidecoder.cpp \
     ../library/tbc/logging.cpp \
+    ../library/tbc/stagestats.cpp \
+    ../library/tbc/vbirange.cpp \
     ../library/tbc/dropouts.cpp
 
 HEADERS += \
@@ -55,9 +59,13 @@ HEADERS += \
     ../library/filter/firfilter.h \
     ../library/filter/iirfilter.h \
     ../library/tbc/lddecodemetadata.h \
+    ../library/tbc/jsonreader.h \
+    ../library/tbc/jsonwriter.h \
     ../library/tbc/sourcevideo.h \
     ../library/tbc/vbidecoder.h \
     ../library/tbc/logging.h \
+    ../library/tbc/stagestats.h \
+    ../library/tbc/vbirange.h \
     ../library/tbc/dropouts.h
 
 # Add external includes to the include path
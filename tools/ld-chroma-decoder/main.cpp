@@ -28,12 +28,15 @@
 #include <QtGlobal>
 #include <QCommandLineParser>
 #include <QScopedPointer>
+#include <QStandardPaths>
 #include <QThread>
 #include <fstream>
 
 #include "decoderpool.h"
 #include "lddecodemetadata.h"
 #include "logging.h"
+#include "stagestats.h"
+#include "vbirange.h"
 
 #include "comb.h"
 #include "monodecoder.h"
@@ -123,6 +126,9 @@ int main(int argc, char *argv[])
     // Add the standard debug options --debug and --quiet
     addStandardDebugOptions(parser);
 
+    // Add the standard statistics options --stats-json and --stats-interval
+    addStandardStatsOptions(parser);
+
     // Option to specify a different JSON input file
     QCommandLineOption inputJsonOption(QStringList() << "input-json",
                                        QCoreApplication::translate("main", "Specify the input JSON file (default input.json)"),
@@ -141,6 +147,9 @@ int main(int argc, char *argv[])
                                         QCoreApplication::translate("main", "number"));
     parser.addOption(lengthOption);
 
+    // Add the standard VBI range options --vbi-start, --vbi-end and --chapter
+    addStandardVbiRangeOptions(parser);
+
     // Option to reverse the field order (-r)
     QCommandLineOption setReverseOption(QStringList() << "r" << "reverse",
                                        QCoreApplication::translate("main", "Reverse the field order to second/first (default first/second)"));
@@ -223,6 +232,16 @@ int main(int argc, char *argv[])
                                       QCoreApplication::translate("main", "Transform: Overlay the input and output FFTs"));
     parser.addOption(showFFTsOption);
 
+    // Option to spend longer planning the FFTs
+    QCommandLineOption fftwPatientOption(QStringList() << "fftw-patient",
+                                         QCoreApplication::translate("main", "Transform: Search harder for fast FFT plans (slow the first time; results are cached)"));
+    parser.addOption(fftwPatientOption);
+
+    // Option to disable the FFTW wisdom cache
+    QCommandLineOption noFftwWisdomOption(QStringList() << "no-fftw-wisdom",
+                                          QCoreApplication::translate("main", "Transform: Do not load or save cached FFT plans"));
+    parser.addOption(noFftwWisdomOption);
+
     // -- Positional arguments --
 
     // Positional argument to specify input video file
@@ -237,6 +256,9 @@ int main(int argc, char *argv[])
     // Standard logging options
     processStandardDebugOptions(parser);
 
+    // Standard statistics options
+    if (!processStandardStatsOptions(parser)) return -1;
+
     // Get the arguments from the parser
     QString inputFileName;
     QString outputFileName = "-";
@@ -377,6 +399,14 @@ int main(int argc, char *argv[])
         palConfig.showFFTs = true;
     }
 
+    // Configure FFTW planning for the Transform decoders, caching wisdom
+    // between runs unless asked not to
+    QString fftwWisdomDirectory;
+    if (!parser.isSet(noFftwWisdomOption)) {
+        fftwWisdomDirectory = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    }
+    TransformPal::configurePlanner(parser.isSet(fftwPatientOption), fftwWisdomDirectory);
+
     // Work out the metadata filename
     QString inputJsonFileName = inputFileName + ".json";
     if (parser.isSet(inputJsonOption)) {
@@ -396,6 +426,11 @@ int main(int argc, char *argv[])
         metaData.setIsFirstFieldFirst(false);
     }
 
+    // Select the frames by VBI address if required
+    if (!processStandardVbiRangeOptions(parser, metaData, startFrame, length)) {
+        return -1;
+    }
+
     // Work out which decoder to use
     QString decoderName;
     if (parser.isSet(decoderOption)) {
@@ -408,7 +408,7 @@ void PalColour::decodeLine(const SourceField &inputField, const ChromaSample *ch
             0.09913768, 0.29007115, 0.38112572, 0.29007115, 0.09913768, -0.03793064,
             -0.05538487, -0.01034077, 0.01767698, 0.01226292, -0.00199265
         };
-        static constexpr auto uvFilter = makeFIRFilter(uvFilterCoeffs);
+        static constexpr auto uvFilter = makeSymmetricFIRFilter(uvFilterCoeffs);
 
         const qint32 overlap = uvFilterCoeffs.size() / 2;
         const qint32 startPos = videoParameters.activeVideoStart - overlap;
@@ -26,10 +26,13 @@
 
 #include "sourcevideo.h"
 
-void SourceField::loadFields(SourceVideo &sourceVideo, LdDecodeMetaData &ldDecodeMetaData,
-                             qint32 firstFrameNumber, qint32 numFrames,
-                             qint32 lookBehindFrames, qint32 lookAheadFrames,
-                             QVector<SourceField> &fields, qint32 &startIndex, qint32 &endIndex)
+// Load fields, getting the data for each real field from getFieldData.
+// This is shared between the file and in-memory versions of loadFields.
+template <typename GetFieldData>
+static void loadFieldsFrom(GetFieldData getFieldData, qint32 fieldLength, LdDecodeMetaData &ldDecodeMetaData,
+                           qint32 firstFrameNumber, qint32 numFrames,
+                           qint32 lookBehindFrames, qint32 lookAheadFrames,
+                           QVector<SourceField> &fields, qint32 &startIndex, qint32 &endIndex)
 {
     const LdDecodeMetaData::VideoParameters &videoParameters = ldDecodeMetaData.getVideoParameters();
 
@@ -60,12 +63,12 @@ void SourceField::loadFields(SourceVideo &sourceVideo, LdDecodeMetaData &ldDecod
 
         if (useBlankFrame) {
             // Fill both fields with black
-            fields[i].data.fill(black, sourceVideo.getFieldLength());
-            fields[i + 1].data.fill(black, sourceVideo.getFieldLength());
+            fields[i].data.fill(black, fieldLength);
+            fields[i + 1].data.fill(black, fieldLength);
         } else {
             // Fetch the input fields
-            fields[i].data = sourceVideo.getVideoField(firstFieldNumber);
-            fields[i + 1].data = sourceVideo.getVideoField(secondFieldNumber);
+            fields[i].data = getFieldData(firstFieldNumber);
+            fields[i + 1].data = getFieldData(secondFieldNumber);
 
             if (videoParameters.isSourcePal && videoParameters.isSubcarrierLocked) {
                 // With subcarrier-locked 4fSC PAL sampling, we have four
@@ -86,3 +89,28 @@ void SourceField::loadFields(SourceVideo &sourceVideo, LdDecodeMetaData &ldDecod
         frameNumber++;
     }
 }
+
+void SourceField::loadFields(SourceVideo &sourceVideo, LdDecodeMetaData &ldDecodeMetaData,
+                             qint32 firstFrameNumber, qint32 numFrames,
+                             qint32 lookBehindFrames, qint32 lookAheadFrames,
+                             QVector<SourceField> &fields, qint32 &startIndex, qint32 &endIndex)
+{
+    loadFieldsFrom([&](qint32 fieldNumber) { return sourceVideo.getVideoField(fieldNumber); },
+                   sourceVideo.getFieldLength(), ldDecodeMetaData,
+                   firstFrameNumber, numFrames, lookBehindFrames, lookAheadFrames,
+                   fields, startIndex, endIndex);
+}
+
+void SourceField::loadFields(const QVector<SourceVideo::Data> &fieldData, LdDecodeMetaData &ldDecodeMetaData,
+                             qint32 firstFrameNumber, qint32 numFrames,
+                             qint32 lookBehindFrames, qint32 lookAheadFrames,
+                             QVector<SourceField> &fields, qint32 &startIndex, qint32 &endIndex)
+{
+    const LdDecodeMetaData::VideoParameters &videoParameters = ldDecodeMetaData.getVideoParameters();
+
+    // Field numbers start at 1
+    loadFieldsFrom([&](qint32 fieldNumber) { return fieldData[fieldNumber - 1]; },
+                   videoParameters.fieldWidth * videoParameters.fieldHeight, ldDecodeMetaData,
+                   firstFrameNumber, numFrames, lookBehindFrames, lookAheadFrames,
+                   fields, startIndex, endIndex);
+}
@@ -42,6 +42,14 @@ struct SourceField {
                            qint32 lookBehindFrames, qint32 lookAheadFrames,
                            QVector<SourceField> &fields, qint32 &startIndex, qint32 &endIndex);
 
+    // As above, but taking the fields from memory rather than a file.
+    // fieldData contains the data for each field in the metadata, starting
+    // with field 1.
+    static void loadFields(const QVector<SourceVideo::Data> &fieldData, LdDecodeMetaData &ldDecodeMetaData,
+                           qint32 firstFrameNumber, qint32 numFrames,
+                           qint32 lookBehindFrames, qint32 lookAheadFrames,
+                           QVector<SourceField> &fields, qint32 &startIndex, qint32 &endIndex);
+
     // Return the vertical offset of this field within the interlaced frame
     // (i.e. 0 for the top field, 1 for the bottom field).
     qint32 getOffset() const {
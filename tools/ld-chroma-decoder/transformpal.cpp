@@ -27,8 +27,57 @@
 
 #include "transformpal.h"
 
+#include <QDir>
+#include <QFile>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QSysInfo>
 #include <cassert>
 #include <cmath>
+#include <cstdlib>
+
+// FFTW plans for one tile geometry
+struct TransformPalPlans {
+    fftw_plan forward;
+    fftw_plan inverse;
+};
+
+// Shared FFTW planner state. The FFTW planner is not thread-safe (although
+// executing plans is), so everything here is protected by plannerMutex.
+//
+// The cached plans live for the lifetime of the process.
+static QMutex plannerMutex;
+static unsigned plannerFlags = FFTW_MEASURE;
+static QString plannerWisdomDirectory;
+static QHash<QString, TransformPalPlans> plannerCache;
+
+// Return a string identifying this machine, for naming wisdom files. FFTW
+// wisdom is only valid for the CPU it was measured on.
+static QString machineKey()
+{
+    QString key = QSysInfo::currentCpuArchitecture() + "-" + QSysInfo::machineHostName();
+
+    // Make sure the key is safe to use in a filename
+    for (qint32 i = 0; i < key.size(); i++) {
+        const QChar c = key[i];
+        if (!c.isLetterOrNumber() && c != '-' && c != '_' && c != '.') key[i] = '_';
+    }
+
+    return key;
+}
+
+// Return FFTW's current wisdom as a string
+static QByteArray exportWisdom()
+{
+    char *wisdom = fftw_export_wisdom_to_string();
+    if (wisdom == nullptr) return QByteArray();
+
+    QByteArray result(wisdom);
+    free(wisdom);
+    return result;
+}
 
 TransformPal::TransformPal(qint32 _xComplex, qint32 _yComplex, qint32 _zComplex)
     : xComplex(_xComplex), yComplex(_yComplex), zComplex(_zComplex), configurationSet(false)
@@ -39,6 +88,79 @@ TransformPal::~TransformPal()
 {
 }
 
+void TransformPal::configurePlanner(bool patient, const QString &wisdomDirectory)
+{
+    QMutexLocker locker(&plannerMutex);
+
+    plannerFlags = patient ? FFTW_PATIENT : FFTW_MEASURE;
+    plannerWisdomDirectory = wisdomDirectory;
+}
+
+void TransformPal::getPlans(const QVector<int> &dims, double *fftReal,
+                            fftw_complex *fftComplexIn, fftw_complex *fftComplexOut,
+                            fftw_plan &forwardPlan, fftw_plan &inversePlan)
+{
+    QMutexLocker locker(&plannerMutex);
+
+    // Describe the geometry, e.g. "r2c-8x32x16"
+    QString geometryKey = "r2c";
+    for (qint32 i = 0; i < dims.size(); i++) {
+        geometryKey += (i == 0 ? "-" : "x") + QString::number(dims[i]);
+    }
+
+    // If we've already got plans for this geometry, reuse them
+    auto it = plannerCache.constFind(geometryKey);
+    if (it != plannerCache.constEnd()) {
+        forwardPlan = it->forward;
+        inversePlan = it->inverse;
+        return;
+    }
+
+    // Load any existing wisdom for this geometry
+    QString wisdomFileName;
+    if (!plannerWisdomDirectory.isEmpty()) {
+        wisdomFileName = QDir(plannerWisdomDirectory).filePath("fftw-" + geometryKey + "-" + machineKey() + ".wisdom");
+        if (QFile::exists(wisdomFileName)) {
+            if (fftw_import_wisdom_from_filename(QFile::encodeName(wisdomFileName).constData())) {
+                qDebug() << "TransformPal::getPlans(): Loaded FFTW wisdom from" << wisdomFileName;
+            } else {
+                qWarning() << "Could not load FFTW wisdom from" << wisdomFileName;
+            }
+        }
+    }
+
+    // Plan FFTW operations. If we have suitable wisdom, this is quick;
+    // otherwise, FFTW will measure the alternatives using the supplied buffers.
+    if (plannerFlags == FFTW_PATIENT) {
+        qInfo() << "Planning FFTW transforms for" << geometryKey << "in patient mode - this may take some time";
+    }
+    const QByteArray previousWisdom = wisdomFileName.isEmpty() ? QByteArray() : exportWisdom();
+    TransformPalPlans plans;
+    plans.forward = fftw_plan_dft_r2c(dims.size(), dims.constData(), fftReal, fftComplexIn, plannerFlags);
+    plans.inverse = fftw_plan_dft_c2r(dims.size(), dims.constData(), fftComplexOut, fftReal, plannerFlags);
+    plannerCache.insert(geometryKey, plans);
+
+    // If FFTW had to measure anything, save the updated wisdom for next time.
+    // The file is replaced atomically, so other processes sharing the wisdom
+    // directory never see a partly-written file.
+    if (!wisdomFileName.isEmpty()) {
+        const QByteArray wisdom = exportWisdom();
+        if (wisdom != previousWisdom) {
+            QDir().mkpath(plannerWisdomDirectory);
+            QSaveFile wisdomFile(wisdomFileName);
+            if (!wisdomFile.open(QIODevice::WriteOnly) || wisdomFile.write(wisdom) != wisdom.size()
+                    || !wisdomFile.commit()) {
+                qWarning() << "Could not save FFTW wisdom to" << wisdomFileName;
+            } else {
+                qDebug() << "TransformPal::getPlans(): Saved FFTW wisdom to" << wisdomFileName;
+            }
+        }
+    }
+
+    forwardPlan = plans.forward;
+    inversePlan = plans.inverse;
+}
+
 void TransformPal::updateConfiguration(const LdDecodeMetaData::VideoParameters &_videoParameters,
                                        TransformPal::TransformMode _mode, double threshold,
                                        const QVector<double> &_thresholds)
@@ -28,6 +28,7 @@
 #ifndef TRANSFORMPAL_H
 #define TRANSFORMPAL_H
 
+#include <QString>
 #include <QVector>
 #include <fftw3.h>
 
@@ -43,6 +44,17 @@ public:
     TransformPal(qint32 xComplex, qint32 yComplex, qint32 zComplex);
     virtual ~TransformPal();
 
+    // Configure how FFTW plans are created for all Transform PAL filters.
+    //
+    // If patient is true, plans are created with FFTW_PATIENT rather than
+    // FFTW_MEASURE; this takes much longer, but may find faster plans. If
+    // wisdomDirectory is not empty, FFTW wisdom is loaded from and saved to a
+    // cache file in that directory, so the planning cost is only paid once
+    // for each tile geometry on each machine.
+    //
+    // This should be called before any TransformPal object is constructed.
+    static void configurePlanner(bool patient, const QString &wisdomDirectory);
+
     // Specify what the frequency-domain filter should do to each pair of
     // bins that should be symmetrical around the carriers.
     enum TransformMode {
@@ -81,6 +93,16 @@ public:
                     QVector<RGBFrame> &rgbFrames);
 
 protected:
+    // Get the forward and inverse plans for a real tile with the given
+    // dimensions (slowest-varying first). The plans are created the first time
+    // a geometry is requested, using the supplied buffers for measurement, and
+    // are then shared between all instances -- so they must be run with
+    // fftw_execute_dft_r2c/fftw_execute_dft_c2r on the caller's own buffers,
+    // which must be allocated with FFTW's allocation functions.
+    static void getPlans(const QVector<int> &dims, double *fftReal,
+                         fftw_complex *fftComplexIn, fftw_complex *fftComplexOut,
+                         fftw_plan &forwardPlan, fftw_plan &inversePlan);
+
     // Overlay a visualisation of one field's FFT.
     // Calls back to overlayFFTArrays to draw the arrays.
     virtual void overlayFFTFrame(qint32 positionX, qint32 positionY,
@@ -78,16 +78,13 @@ TransformPal2D::TransformPal2D()
     fftComplexIn = fftw_alloc_complex(YCOMPLEX * XCOMPLEX);
     fftComplexOut = fftw_alloc_complex(YCOMPLEX * XCOMPLEX);
 
-    // Plan FFTW operations
-    forwardPlan = fftw_plan_dft_r2c_2d(YTILE, XTILE, fftReal, fftComplexIn, FFTW_MEASURE);
-    inversePlan = fftw_plan_dft_c2r_2d(YTILE, XTILE, fftComplexOut, fftReal, FFTW_MEASURE);
+    // Get (shared) FFTW plans
+    getPlans({YTILE, XTILE}, fftReal, fftComplexIn, fftComplexOut, forwardPlan, inversePlan);
 }
 
 TransformPal2D::~TransformPal2D()
 {
-    // Free FFTW plans and buffers
-    fftw_destroy_plan(forwardPlan);
-    fftw_destroy_plan(inversePlan);
+    // Free FFTW buffers (the plans are shared, so they're not freed here)
     fftw_free(fftReal);
     fftw_free(fftComplexIn);
     fftw_free(fftComplexOut);
@@ -177,7 +174,7 @@ void TransformPal2D::forwardFFTTile(qint32 tileX, qint32 tileY, qint32 startY, q
     }
 
     // Convert time domain in fftReal to frequency domain in fftComplexIn
-    fftw_execute(forwardPlan);
+    fftw_execute_dft_r2c(forwardPlan, fftReal, fftComplexIn);
 }
 
 // Apply the inverse FFT to fftComplexOut, overlaying the result into chromaBuf[outputIndex]
@@ -188,7 +185,7 @@ void TransformPal2D::inverseFFTTile(qint32 tileX, qint32 tileY, qint32 startY, q
     const qint32 endX = qMin(videoParameters.activeVideoEnd - tileX, XTILE);
 
     // Convert frequency domain in fftComplexOut back to time domain in fftReal
-    fftw_execute(inversePlan);
+    fftw_execute_dft_c2r(inversePlan, fftComplexOut, fftReal);
 
     // Overlay the result, normalising the FFTW output, into chromaBuf
     double *outputPtr = chromaBuf[outputIndex].data();
@@ -87,16 +87,13 @@ TransformPal3D::TransformPal3D()
     fftComplexIn = fftw_alloc_complex(ZCOMPLEX * YCOMPLEX * XCOMPLEX);
     fftComplexOut = fftw_alloc_complex(ZCOMPLEX * YCOMPLEX * XCOMPLEX);
 
-    // Plan FFTW operations
-    forwardPlan = fftw_plan_dft_r2c_3d(ZTILE, YTILE, XTILE, fftReal, fftComplexIn, FFTW_MEASURE);
-    inversePlan = fftw_plan_dft_c2r_3d(ZTILE, YTILE, XTILE, fftComplexOut, fftReal, FFTW_MEASURE);
+    // Get (shared) FFTW plans
+    getPlans({ZTILE, YTILE, XTILE}, fftReal, fftComplexIn, fftComplexOut, forwardPlan, inversePlan);
 }
 
 TransformPal3D::~TransformPal3D()
 {
-    // Free FFTW plans and buffers
-    fftw_destroy_plan(forwardPlan);
-    fftw_destroy_plan(inversePlan);
+    // Free FFTW buffers (the plans are shared, so they're not freed here)
     fftw_free(fftReal);
     fftw_free(fftComplexIn);
     fftw_free(fftComplexOut);
@@ -202,7 +199,7 @@ void TransformPal3D::forwardFFTTile(qint32 tileX, qint32 tileY, qint32 tileZ, co
     }
 
     // Convert time domain in fftReal to frequency domain in fftComplexIn
-    fftw_execute(forwardPlan);
+    fftw_execute_dft_r2c(forwardPlan, fftReal, fftComplexIn);
 }
 
 // Apply the inverse FFT to fftComplexOut, overlaying the result into chromaBuf
@@ -217,7 +214,7 @@ void TransformPal3D::inverseFFTTile(qint32 tileX, qint32 tileY, qint32 tileZ, qi
     const qint32 endZ = qMin(endIndex - tileZ, ZTILE);
 
     // Convert frequency domain in fftComplexOut back to time domain in fftReal
-    fftw_execute(inversePlan);
+    fftw_execute_dft_c2r(inversePlan, fftComplexOut, fftReal);
 
     // Overlay the result, normalising the FFTW output, into the chroma buffers
     for (qint32 z = startZ; z < endZ; z++) {
@@ -92,7 +92,7 @@ protected:
     fftw_complex *fftComplexIn;
     fftw_complex *fftComplexOut;
 
-    // FFT plans
+    // FFT plans (shared between all instances; see TransformPal::getPlans)
     fftw_plan forwardPlan, inversePlan;
 
     // The combined result of all the FFT processing for each input field.
@@ -5,6 +5,7 @@ SUBDIRS = \
     ld-analyse \
     ld-chroma-decoder \
     ld-chroma-decoder/encoder \
+    ld-chroma-decoder/bench \
     ld-diffdod \
     ld-discmap \
     ld-dropout-correct \
@@ -25,6 +25,8 @@
 #include "diffdod.h"
 #include "sources.h"
 
+#include <algorithm>
+
 DiffDod::DiffDod(QAtomicInt& abort, Sources& sources, QObject *parent)
     : QThread(parent), m_abort(abort), m_sources(sources)
 {
@@ -79,11 +81,8 @@ void DiffDod::run()
             performClipCheck(secondFields, secondFieldDiff, videoParameters, availableSourcesForFrame);
         }
 
-        // Filter the frame to leave just the luma information
-        performLumaFilter(firstFields, videoParameters, availableSourcesForFrame);
-        performLumaFilter(secondFields, videoParameters, availableSourcesForFrame);
-
         // Create a differential map of the fields for the avaialble frames (based on the DOD threshold)
+        // Note: The fields are luma filtered line by line as part of this
         getFieldErrorByMedian(firstFields, firstFieldDiff, dodThreshold, videoParameters, availableSourcesForFrame);
         getFieldErrorByMedian(secondFields, secondFieldDiff, dodThreshold, videoParameters, availableSourcesForFrame);
 
@@ -160,32 +159,20 @@ void DiffDod::performClipCheck(QVector<SourceVideo::Data> &fields, QVector<QByte
     }
 }
 
-void DiffDod::performLumaFilter(QVector<SourceVideo::Data> &fields,
-                                LdDecodeMetaData::VideoParameters videoParameters,
-                                QVector<qint32> availableSourcesForFrame)
-{
-    // Filter out the chroma information from the fields leaving just luma
-    Filters filters;
-
-    for (qint32 sourcePointer = 0; sourcePointer < availableSourcesForFrame.size(); sourcePointer++) {
-        qint32 sourceNo = availableSourcesForFrame[sourcePointer]; // Get the actual source
-        if (videoParameters.isSourcePal) {
-            filters.palLumaFirFilter(fields[sourceNo].data(), videoParameters.fieldWidth * videoParameters.fieldHeight);
-        } else {
-            filters.ntscLumaFirFilter(fields[sourceNo].data(), videoParameters.fieldWidth * videoParameters.fieldHeight);
-        }
-    }
-}
-
 // Create an error map of the fields based on median value differential analysis
 // Note: This only functions within the colour burst and visible areas of the frame
+//
+// Each source's field is luma filtered into a scratch buffer in one pass (leaving the input
+// fields untouched), then the median of the available sources is found for each dot and any
+// source that differs from it by more than the threshold is marked in the difference map.
 void DiffDod::getFieldErrorByMedian(QVector<SourceVideo::Data> &fields, QVector<QByteArray> &fieldDiff,
                                                    qint32 dodThreshold,
                                                    LdDecodeMetaData::VideoParameters videoParameters,
                                                    QVector<qint32> availableSourcesForFrame)
 {
     // This method requires at least three source frames
-    if (availableSourcesForFrame.size() < 3) {
+    const qint32 numSources = availableSourcesForFrame.size();
+    if (numSources < 3) {
         return;
     }
 
@@ -195,35 +182,68 @@ void DiffDod::getFieldErrorByMedian(QVector<SourceVideo::Data> &fields, QVector<
     // Calculate the linear threshold for the colourburst region
     qint32 cbThreshold = ((65535 / 100) * dodThreshold) / 4; // Note: The /4 is just a guess
 
+    // Make sure the brightness look-up table matches the source's black and white levels
+    updateBrightnessLut(videoParameters);
+
+    // The region of each line to compare
+    const qint32 areaStart = videoParameters.colourBurstStart;
+    const qint32 areaEnd = videoParameters.activeVideoEnd;
+    if (areaEnd <= areaStart) return;
+
+    // Filter each source's field to leave just the luma information. The luma filter is
+    // applied to the whole field as a single run of samples, so each dot depends upon its
+    // neighbours (including those on the adjacent lines)
+    const qint32 fieldLength = videoParameters.fieldWidth * videoParameters.fieldHeight;
+
+    lumaBuffer.resize(numSources * fieldLength);
+    dotValues.resize(numSources);
+
+    Filters filters;
+
+    for (qint32 sourcePointer = 0; sourcePointer < numSources; sourcePointer++) {
+        qint32 sourceNo = availableSourcesForFrame[sourcePointer]; // Get the actual source
+        quint16 *lumaField = lumaBuffer.data() + (sourcePointer * fieldLength);
+
+        if (videoParameters.isSourcePal) {
+            filters.palLumaFirFilter(fields[sourceNo].constData(), lumaField, fieldLength);
+        } else {
+            filters.ntscLumaFirFilter(fields[sourceNo].constData(), lumaField, fieldLength);
+        }
+    }
+
     for (qint32 y = 0; y < videoParameters.fieldHeight; y++) {
         qint32 startOfLinePointer = y * videoParameters.fieldWidth;
-        for (qint32 x = videoParameters.colourBurstStart; x < videoParameters.activeVideoEnd; x++) {
-            // Get the dot value from all of the sources
-            QVector<qint32> dotValues(fields.size());
-            for (qint32 sourcePointer = 0; sourcePointer < availableSourcesForFrame.size(); sourcePointer++) {
-                qint32 sourceNo = availableSourcesForFrame[sourcePointer]; // Get the actual source
-                dotValues[sourceNo] = static_cast<qint32>(fields[sourceNo][x + startOfLinePointer]);
+
+        for (qint32 x = areaStart; x < areaEnd; x++) {
+            const bool isVisible = (x >= videoParameters.activeVideoStart);
+            const bool isColourBurst = (x < videoParameters.colourBurstEnd);
+            if (!isVisible && !isColourBurst) continue;
+
+            // Get the dot value from all of the available sources
+            const quint16 *dots = lumaBuffer.constData() + startOfLinePointer + x;
+            for (qint32 sourcePointer = 0; sourcePointer < numSources; sourcePointer++) {
+                dotValues[sourcePointer] = dots[sourcePointer * fieldLength];
             }
+            const qint32 dotMedian = median(dotValues.data(), numSources);
 
             // If we are in the visible area use Rec.709 logarithmic comparison
-            if (x >= videoParameters.activeVideoStart && x < videoParameters.activeVideoEnd) {
-                // Compute the median of the dot values
-                float vMedian = static_cast<float>(convertLinearToBrightness(median(dotValues), videoParameters.black16bIre, videoParameters.white16bIre, videoParameters.isSourcePal));
+            if (isVisible) {
+                // The transfer function is monotonic, so the median brightness is the brightness of the median
+                const float vMedian = brightnessLut[dotMedian];
 
-                for (qint32 sourcePointer = 0; sourcePointer < availableSourcesForFrame.size(); sourcePointer++) {
+                for (qint32 sourcePointer = 0; sourcePointer < numSources; sourcePointer++) {
                     qint32 sourceNo = availableSourcesForFrame[sourcePointer]; // Get the actual source
-                    float v = convertLinearToBrightness(dotValues[sourceNo], videoParameters.black16bIre, videoParameters.white16bIre, videoParameters.isSourcePal);
+                    float v = brightnessLut[dots[sourcePointer * fieldLength]];
                     if ((v - vMedian) > threshold) fieldDiff[sourceNo][x + startOfLinePointer] = 2;
                 }
             }
 
             // If we are in the colourburst use linear comparison
-            if (x >= videoParameters.colourBurstStart && x < videoParameters.colourBurstEnd) {
-                // We are in the colour burst, use linear comparison
-                qint32 dotMedian = median(dotValues);
-                for (qint32 sourcePointer = 0; sourcePointer < availableSourcesForFrame.size(); sourcePointer++) {
+            if (isColourBurst) {
+                for (qint32 sourcePointer = 0; sourcePointer < numSources; sourcePointer++) {
                     qint32 sourceNo = availableSourcesForFrame[sourcePointer]; // Get the actual source
-                    if ((dotValues[sourceNo] - dotMedian) > cbThreshold) fieldDiff[sourceNo][x + startOfLinePointer] = 2;
+                    qint32 dotValue = dots[sourcePointer * fieldLength];
+                    if ((dotValue - dotMedian) > cbThreshold) fieldDiff[sourceNo][x + startOfLinePointer] = 2;
                 }
             }
         }
@@ -313,12 +333,41 @@ void DiffDod::concatenateFieldDropouts(QVector<DropOuts> &dropouts,
     }
 }
 
-// Method to find the median of a vector of qint32s
-qint32 DiffDod::median(QVector<qint32> v)
+// Method to find the median of count values (reordering them in place)
+qint32 DiffDod::median(qint32 *values, qint32 count)
+{
+    // For the handful of sources usually available, an insertion sort is quicker than nth_element
+    if (count <= 8) {
+        for (qint32 i = 1; i < count; i++) {
+            qint32 value = values[i];
+            qint32 j = i;
+            for (; j > 0 && values[j - 1] > value; j--) values[j] = values[j - 1];
+            values[j] = value;
+        }
+        return values[count / 2];
+    }
+
+    std::nth_element(values, values + (count / 2), values + count);
+    return values[count / 2];
+}
+
+// Method to (re)build the linear to brightness look-up table if the video parameters have changed
+void DiffDod::updateBrightnessLut(const LdDecodeMetaData::VideoParameters &videoParameters)
 {
-    size_t n = v.size() / 2;
-    std::nth_element(v.begin(), v.begin()+n, v.end());
-    return v[n];
+    if (!brightnessLut.isEmpty() && lutBlack16bIre == videoParameters.black16bIre
+            && lutWhite16bIre == videoParameters.white16bIre && lutIsSourcePal == videoParameters.isSourcePal) {
+        return;
+    }
+
+    brightnessLut.resize(65536);
+    for (qint32 value = 0; value < 65536; value++) {
+        brightnessLut[value] = convertLinearToBrightness(static_cast<quint16>(value), videoParameters.black16bIre,
+                                                         videoParameters.white16bIre, videoParameters.isSourcePal);
+    }
+
+    lutBlack16bIre = videoParameters.black16bIre;
+    lutWhite16bIre = videoParameters.white16bIre;
+    lutIsSourcePal = videoParameters.isSourcePal;
 }
 
 // Method to convert a linear IRE to a logarithmic reflective brightness %
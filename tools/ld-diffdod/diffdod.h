@@ -54,13 +54,20 @@ private:
     QAtomicInt& m_abort;
     Sources& m_sources;
 
+    // Linear to brightness look-up table, and the parameters it was built for
+    QVector<float> brightnessLut;
+    qint32 lutBlack16bIre = -1;
+    qint32 lutWhite16bIre = -1;
+    bool lutIsSourcePal = false;
+
+    // Scratch buffers for getFieldErrorByMedian, kept to avoid reallocating them for every field
+    QVector<quint16> lumaBuffer;
+    QVector<qint32> dotValues;
+
     // Processing methods
     void performClipCheck(QVector<SourceVideo::Data> &fields, QVector<QByteArray> &fieldDiff,
                                    LdDecodeMetaData::VideoParameters videoParameters,
                                    QVector<qint32> availableSourcesForFrame);
-    void performLumaFilter(QVector<SourceVideo::Data> &fields,
-                                    LdDecodeMetaData::VideoParameters videoParameters,
-                                    QVector<qint32> availableSourcesForFrame);
     void getFieldErrorByMedian(QVector<SourceVideo::Data> &fields, QVector<QByteArray> &fieldDiff, qint32 dodThreshold,
                                               LdDecodeMetaData::VideoParameters videoParameters,
                                               QVector<qint32> availableSourcesForFrame);
@@ -70,7 +77,8 @@ private:
 
     void concatenateFieldDropouts(QVector<DropOuts> &dropouts, QVector<qint32> availableSourcesForFrame);
 
-    qint32 median(QVector<qint32> v);
+    qint32 median(qint32 *values, qint32 count);
+    void updateBrightnessLut(const LdDecodeMetaData::VideoParameters &videoParameters);
     float convertLinearToBrightness(quint16 value, quint16 black16bIre, quint16 white16bIre, bool isSourcePal);
 };
 
@@ -1,4 +1,5 @@
 QT -= gui
+QT += concurrent
 
 CONFIG += c++11 console
 CONFIG -= app_bundle
@@ -16,10 +17,15 @@ DEFINES += QT_DEPRECATED_WARNINGS
 
 SOURCES += \
     ../library/tbc/lddecodemetadata.cpp \
+    ../library/tbc/jsonreader.cpp \
+    ../library/tbc/jsonwriter.cpp \
     ../library/tbc/sourcevideo.cpp \
+    ../library/tbc/multisourcereader.cpp \
     ../library/tbc/vbidecoder.cpp \
+    ../library/tbc/vbiframemap.cpp \
     ../library/tbc/filters.cpp \
     ../library/tbc/logging.cpp \
+    ../library/tbc/stagestats.cpp \
     ../library/tbc/dropouts.cpp \
     diffdod.cpp \
     main.cpp \
@@ -28,10 +34,15 @@ SOURCES += \
 HEADERS += \
     ../library/filter/firfilter.h \
     ../library/tbc/lddecodemetadata.h \
+    ../library/tbc/jsonreader.h \
+    ../library/tbc/jsonwriter.h \
     ../library/tbc/sourcevideo.h \
+    ../library/tbc/multisourcereader.h \
     ../library/tbc/vbidecoder.h \
+    ../library/tbc/vbiframemap.h \
     ../library/tbc/filters.h \
     ../library/tbc/logging.h \
+    ../library/tbc/stagestats.h \
     ../library/tbc/dropouts.h \
     diffdod.h \
     sources.h
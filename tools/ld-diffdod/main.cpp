@@ -28,6 +28,7 @@
 #include <QCommandLineParser>
 
 #include "logging.h"
+#include "stagestats.h"
 #include "sources.h"
 
 int main(int argc, char *argv[])
@@ -56,6 +57,9 @@ int main(int argc, char *argv[])
     // Add the standard debug options --debug and --quiet
     addStandardDebugOptions(parser);
 
+    // Add the standard statistics options --stats-json and --stats-interval
+    addStandardStatsOptions(parser);
+
     // Option to reverse the field order (-r / --reverse)
     QCommandLineOption setReverseOption(QStringList() << "r" << "reverse",
                                        QCoreApplication::translate("main", "Reverse the field order to second/first (default first/second)"));
@@ -100,6 +104,9 @@ int main(int argc, char *argv[])
     // Standard logging options
     processStandardDebugOptions(parser);
 
+    // Standard statistics options
+    if (!processStandardStatsOptions(parser)) return -1;
+
     // Get the options from the parser
     bool reverse = parser.isSet(setReverseOption);
     bool signalClip = true;
@@ -24,13 +24,15 @@
 
 #include "sources.h"
 
+#include <QtConcurrent/QtConcurrent>
+
 Sources::Sources(QVector<QString> inputFilenames, bool reverse,
                  qint32 dodThreshold, bool signalClip,
                  qint32 startVbi, qint32 lengthVbi,
                  qint32 maxThreads, QObject *parent)
     : QObject(parent), m_inputFilenames(inputFilenames), m_reverse(reverse),
       m_dodThreshold(dodThreshold), m_signalClip(signalClip), m_startVbi(startVbi),
-      m_lengthVbi(lengthVbi), m_maxThreads(maxThreads)
+      m_lengthVbi(lengthVbi), m_maxThreads(maxThreads), sourceReader(maxThreads * 2)
 {
     // Used to track the sources as they are loaded
     currentSource = 0;
@@ -77,9 +79,13 @@ bool Sources::process()
 
     // Process the sources --------------------------------------------------------------------------------------------
     inputFrameNumber = vbiStartFrame;
+    firstFrameNumber = vbiStartFrame;
     lastFrameNumber = vbiStartFrame + length;
     processedFrames = 0;
 
+    // Start reading the fields for every frame from the sources in the background
+    startSourceReader();
+
     qInfo() << "";
     qInfo() << "Beginning multi-threaded diffDOD processing...";
     qInfo() << "Processing" << length << "frames - from VBI frame" << inputFrameNumber << "to" << lastFrameNumber;
@@ -99,6 +105,7 @@ bool Sources::process()
         threads[i]->wait();
         delete threads[i];
     }
+    sourceReader.stop();
 
     // Did any of the threads abort?
     if (abort) {
@@ -149,9 +156,7 @@ bool Sources::getInputFrame(qint32& targetVbiFrame,
     // Get the number of available sources for the current frame
     availableSourcesForFrame = getAvailableSourcesForFrame(targetVbiFrame);
 
-    // Get the field data for the current frame (from all available sources)
-    firstFields = getFieldData(targetVbiFrame, true, availableSourcesForFrame);
-    secondFields = getFieldData(targetVbiFrame, false, availableSourcesForFrame);
+    qDebug() << "Processing VBI Frame" << targetVbiFrame << "-" << availableSourcesForFrame.size() << "sources available";
 
     // Set the other miscellaneous parameters
     dodThreshold = m_dodThreshold;
@@ -160,7 +165,11 @@ bool Sources::getInputFrame(qint32& targetVbiFrame,
     // User feedback
     if (processedFrames % 100 == 0) qInfo() << "Processing frame" << targetVbiFrame;
 
-    return true;
+    // Wait for the source reader to provide the field data for the current frame (from
+    // all available sources). This doesn't need the input lock, so other threads can
+    // carry on meanwhile.
+    locker.unlock();
+    return sourceReader.getFrame(targetVbiFrame - firstFrameNumber, firstFields, secondFields);
 }
 
 // Receive a frame from the threaded processing
@@ -176,10 +185,9 @@ bool Sources::setOutputFrame(qint32 targetVbiFrame,
         qint32 sourceNo = availableSourcesForFrame[sourcePointer]; // Get the actual source
 
         // Get the required field numbers
-        qint32 firstFieldNumber = sourceVideos[sourceNo]->
-                ldDecodeMetaData.getFirstFieldNumber(convertVbiFrameNumberToSequential(targetVbiFrame, sourceNo));
-        qint32 secondFieldNumber = sourceVideos[sourceNo]->
-                ldDecodeMetaData.getSecondFieldNumber(convertVbiFrameNumberToSequential(targetVbiFrame, sourceNo));
+        const VbiFrameMap::Frame &frame = sourceVideos[sourceNo]->frameMap.getVbiFrame(targetVbiFrame);
+        qint32 firstFieldNumber = frame.firstFieldNumber;
+        qint32 secondFieldNumber = frame.secondFieldNumber;
 
         // Calculate the total number of dropouts detected for the frame
         qint32 totalFirstDropouts = 0;
@@ -191,15 +199,11 @@ bool Sources::setOutputFrame(qint32 targetVbiFrame,
                     "frame" << targetVbiFrame << "fields" << firstFieldNumber << "/" << secondFieldNumber <<
                     "- Dropout records" << totalFirstDropouts << "/" << totalSecondDropouts;
 
-        // Only replace the existing metadata if it was possible to create new metadata
+        // Only replace the existing metadata if it was possible to create new metadata.
+        // The new dropouts are queued, and written into the metadata by saveSources.
         if (availableSourcesForFrame.size() >= 3) {
-            // Remove the existing field dropout metadata for the field
-            sourceVideos[sourceNo]->ldDecodeMetaData.clearFieldDropOuts(firstFieldNumber);
-            sourceVideos[sourceNo]->ldDecodeMetaData.clearFieldDropOuts(secondFieldNumber);
-
-            // Write the new field dropout metadata
-            sourceVideos[sourceNo]->ldDecodeMetaData.updateFieldDropOuts(firstFieldDropouts[sourceNo], firstFieldNumber);
-            sourceVideos[sourceNo]->ldDecodeMetaData.updateFieldDropOuts(secondFieldDropouts[sourceNo], secondFieldNumber);
+            queueFieldDropOuts(*sourceVideos[sourceNo], firstFieldNumber, firstFieldDropouts[sourceNo]);
+            queueFieldDropOuts(*sourceVideos[sourceNo], secondFieldNumber, secondFieldDropouts[sourceNo]);
         }
     }
 
@@ -337,102 +341,29 @@ bool Sources::loadSource(QString filename, bool reverse)
 }
 
 // Method to work out the disc type (CAV or CLV) and the maximum and minimum
-// VBI frame numbers for the source
+// VBI frame numbers for the source, and build its VBI frame map
 bool Sources::setDiscTypeAndMaxMinFrameVbi(qint32 sourceNumber)
 {
-    sourceVideos[sourceNumber]->isSourceCav = false;
-
-    // Determine the disc type
-    VbiDecoder vbiDecoder;
-    qint32 cavCount = 0;
-    qint32 clvCount = 0;
-
-    qint32 typeCountMax = 100;
-    if (sourceVideos[sourceNumber]->ldDecodeMetaData.getNumberOfFrames() < typeCountMax)
-        typeCountMax = sourceVideos[sourceNumber]->ldDecodeMetaData.getNumberOfFrames();
-
-    // Using sequential frame numbering starting from 1
-    for (qint32 seqFrame = 1; seqFrame <= typeCountMax; seqFrame++) {
-        // Get the VBI data and then decode
-        QVector<qint32> vbi1 = sourceVideos[sourceNumber]->ldDecodeMetaData.getFieldVbi(sourceVideos[sourceNumber]->
-                                                                                        ldDecodeMetaData.getFirstFieldNumber(seqFrame)).vbiData;
-        QVector<qint32> vbi2 = sourceVideos[sourceNumber]->ldDecodeMetaData.getFieldVbi(sourceVideos[sourceNumber]->
-                                                                                        ldDecodeMetaData.getSecondFieldNumber(seqFrame)).vbiData;
-        VbiDecoder::Vbi vbi = vbiDecoder.decodeFrame(vbi1[0], vbi1[1], vbi1[2], vbi2[0], vbi2[1], vbi2[2]);
-
-        // Look for a complete, valid CAV picture number or CLV time-code
-        if (vbi.picNo > 0) cavCount++;
-
-        if (vbi.clvHr != -1 && vbi.clvMin != -1 &&
-                vbi.clvSec != -1 && vbi.clvPicNo != -1) clvCount++;
-    }
-    qDebug() << "Got" << cavCount << "CAV picture codes and" << clvCount << "CLV timecodes";
-
-    // If the metadata has no picture numbers or time-codes, we cannot use the source
-    if (cavCount == 0 && clvCount == 0) {
+    VbiFrameMap &frameMap = sourceVideos[sourceNumber]->frameMap;
+    if (!frameMap.build(sourceVideos[sourceNumber]->ldDecodeMetaData)) {
         qDebug() << "Source does not seem to contain valid CAV picture numbers or CLV time-codes - cannot process";
         return false;
     }
 
-    // Determine disc type
-    if (cavCount > clvCount) {
-        sourceVideos[sourceNumber]->isSourceCav = true;
-        qDebug() << "Got" << cavCount << "valid CAV picture numbers - source disc type is CAV";
+    if (frameMap.isDiscCav()) {
         qInfo() << "Disc type is CAV";
-    } else {
-        sourceVideos[sourceNumber]->isSourceCav = false;
-        qDebug() << "Got" << clvCount << "valid CLV picture numbers - source disc type is CLV";
-        qInfo() << "Disc type is CLV";
-
-    }
-
-    // Disc has been mapped, so we can use the first and last frame numbers as the
-    // min and max range of VBI frame numbers in the input source
-    QVector<qint32> vbi1 = sourceVideos[sourceNumber]->ldDecodeMetaData.getFieldVbi(sourceVideos[sourceNumber]->
-                                                                                    ldDecodeMetaData.getFirstFieldNumber(1)).vbiData;
-    QVector<qint32> vbi2 = sourceVideos[sourceNumber]->ldDecodeMetaData.getFieldVbi(sourceVideos[sourceNumber]->
-                                                                                    ldDecodeMetaData.getSecondFieldNumber(1)).vbiData;
-    VbiDecoder::Vbi vbi = vbiDecoder.decodeFrame(vbi1[0], vbi1[1], vbi1[2], vbi2[0], vbi2[1], vbi2[2]);
 
-    if (sourceVideos[sourceNumber]->isSourceCav) {
-        sourceVideos[sourceNumber]->minimumVbiFrameNumber = vbi.picNo;
-    } else {
-        LdDecodeMetaData::ClvTimecode timecode;
-        timecode.hours = vbi.clvHr;
-        timecode.minutes = vbi.clvMin;
-        timecode.seconds = vbi.clvSec;
-        timecode.pictureNumber = vbi.clvPicNo;
-        sourceVideos[sourceNumber]->minimumVbiFrameNumber = sourceVideos[sourceNumber]->ldDecodeMetaData.convertClvTimecodeToFrameNumber(timecode);
-    }
-
-    vbi1 = sourceVideos[sourceNumber]->ldDecodeMetaData.getFieldVbi(sourceVideos[sourceNumber]->
-                       ldDecodeMetaData.getFirstFieldNumber(sourceVideos[sourceNumber]->ldDecodeMetaData.getNumberOfFrames())).vbiData;
-    vbi2 = sourceVideos[sourceNumber]->ldDecodeMetaData.getFieldVbi(sourceVideos[sourceNumber]->
-                       ldDecodeMetaData.getSecondFieldNumber(sourceVideos[sourceNumber]->ldDecodeMetaData.getNumberOfFrames())).vbiData;
-    vbi = vbiDecoder.decodeFrame(vbi1[0], vbi1[1], vbi1[2], vbi2[0], vbi2[1], vbi2[2]);
-
-    if (sourceVideos[sourceNumber]->isSourceCav) {
-        sourceVideos[sourceNumber]->maximumVbiFrameNumber = vbi.picNo;
-    } else {
-        LdDecodeMetaData::ClvTimecode timecode;
-        timecode.hours = vbi.clvHr;
-        timecode.minutes = vbi.clvMin;
-        timecode.seconds = vbi.clvSec;
-        timecode.pictureNumber = vbi.clvPicNo;
-        sourceVideos[sourceNumber]->maximumVbiFrameNumber = sourceVideos[sourceNumber]->ldDecodeMetaData.convertClvTimecodeToFrameNumber(timecode);
-    }
-
-    if (sourceVideos[sourceNumber]->isSourceCav) {
         // If the source is CAV frame numbering should be a minimum of 1 (it
         // can be 0 for CLV sources)
-        if (sourceVideos[sourceNumber]->minimumVbiFrameNumber < 1) {
-            qCritical() << "CAV start frame of" << sourceVideos[sourceNumber]->minimumVbiFrameNumber << "is out of bounds (should be 1 or above)";
+        if (frameMap.getMinimumVbiFrame() < 1) {
+            qCritical() << "CAV start frame of" << frameMap.getMinimumVbiFrame() << "is out of bounds (should be 1 or above)";
             return false;
         }
+    } else {
+        qInfo() << "Disc type is CLV";
     }
 
-    qInfo() << "VBI frame number range is" << sourceVideos[sourceNumber]->minimumVbiFrameNumber << "to" <<
-        sourceVideos[sourceNumber]->maximumVbiFrameNumber;
+    qInfo() << "VBI frame number range is" << frameMap.getMinimumVbiFrame() << "to" << frameMap.getMaximumVbiFrame();
 
     return true;
 }
@@ -442,8 +373,8 @@ qint32 Sources::getMinimumVbiFrameNumber()
 {
     qint32 minimumFrameNumber = 1000000;
     for (qint32 i = 0; i < sourceVideos.size(); i++) {
-        if (sourceVideos[i]->minimumVbiFrameNumber < minimumFrameNumber)
-            minimumFrameNumber = sourceVideos[i]->minimumVbiFrameNumber;
+        if (sourceVideos[i]->frameMap.getMinimumVbiFrame() < minimumFrameNumber)
+            minimumFrameNumber = sourceVideos[i]->frameMap.getMinimumVbiFrame();
     }
 
     return minimumFrameNumber;
@@ -454,8 +385,8 @@ qint32 Sources::getMaximumVbiFrameNumber()
 {
     qint32 maximumFrameNumber = 0;
     for (qint32 i = 0; i < sourceVideos.size(); i++) {
-        if (sourceVideos[i]->maximumVbiFrameNumber > maximumFrameNumber)
-            maximumFrameNumber = sourceVideos[i]->maximumVbiFrameNumber;
+        if (sourceVideos[i]->frameMap.getMaximumVbiFrame() > maximumFrameNumber)
+            maximumFrameNumber = sourceVideos[i]->frameMap.getMaximumVbiFrame();
     }
 
     return maximumFrameNumber;
@@ -492,29 +423,14 @@ QVector<qint32> Sources::getAvailableSourcesForFrame(qint32 vbiFrameNumber)
 {
     QVector<qint32> availableSourcesForFrame;
     for (qint32 sourceNo = 0; sourceNo < sourceVideos.size(); sourceNo++) {
-        if (vbiFrameNumber >= sourceVideos[sourceNo]->minimumVbiFrameNumber && vbiFrameNumber <= sourceVideos[sourceNo]->maximumVbiFrameNumber) {
-            // Get the field numbers for the frame
-            qint32 firstFieldNumber = sourceVideos[sourceNo]->ldDecodeMetaData.getFirstFieldNumber(convertVbiFrameNumberToSequential(vbiFrameNumber, sourceNo));
-            qint32 secondFieldNumber = sourceVideos[sourceNo]->ldDecodeMetaData.getSecondFieldNumber(convertVbiFrameNumberToSequential(vbiFrameNumber, sourceNo));
-
-            // Ensure the frame is not a padded field (i.e. missing)
-            if (!(sourceVideos[sourceNo]->ldDecodeMetaData.getField(firstFieldNumber).pad &&
-                  sourceVideos[sourceNo]->ldDecodeMetaData.getField(secondFieldNumber).pad)) {
-                availableSourcesForFrame.append(sourceNo);
-            }
+        if (sourceVideos[sourceNo]->frameMap.containsVbiFrame(vbiFrameNumber)) {
+            availableSourcesForFrame.append(sourceNo);
         }
     }
 
     return availableSourcesForFrame;
 }
 
-// Method to convert a VBI frame number to a sequential frame number
-qint32 Sources::convertVbiFrameNumberToSequential(qint32 vbiFrameNumber, qint32 sourceNumber)
-{
-    // Offset the VBI frame number to get the sequential source frame number
-    return vbiFrameNumber - sourceVideos[sourceNumber]->minimumVbiFrameNumber + 1;
-}
-
 // Get the number of available sources
 qint32 Sources::getNumberOfAvailableSources()
 {
@@ -524,39 +440,82 @@ qint32 Sources::getNumberOfAvailableSources()
 // Method to write the source metadata to disc
 void Sources::saveSources()
 {
-    // Save the sources' metadata
-    for (qint32 sourceNo = 0; sourceNo < sourceVideos.size(); sourceNo++) {
+    // The sources' metadata is independent, so update and save them in parallel
+    QtConcurrent::blockingMap(sourceVideos, [&](Source *&source) {
+        // Replace the dropouts for the processed fields
+        writeQueuedDropOuts(*source);
+
         // Write the JSON metadata
-        qInfo() << "Writing JSON metadata file for TBC file" << sourceNo;
-        sourceVideos[sourceNo]->ldDecodeMetaData.write(sourceVideos[sourceNo]->filename + ".json");
+        qInfo() << "Writing JSON metadata file for TBC file" << source->filename;
+        source->ldDecodeMetaData.write(source->filename + ".json");
+    });
+}
+
+// Method to queue the new dropouts for a field, to be written into the source's metadata later.
+// Each field is stored in the source's queue as its field number, the number of dropouts,
+// then the start x, end x and field line of each dropout.
+// Note: Must be called with outputMutex held
+void Sources::queueFieldDropOuts(Source &source, qint32 fieldNumber, const DropOuts &dropOuts)
+{
+    // Note: This doesn't reserve space, as QVector::reserve would reallocate
+    // to exactly the requested size each time; append grows it geometrically
+    QVector<qint32> &queue = source.queuedDropOuts;
+    queue.append(fieldNumber);
+    queue.append(dropOuts.size());
+    for (qint32 i = 0; i < dropOuts.size(); i++) {
+        queue.append(dropOuts.startx(i));
+        queue.append(dropOuts.endx(i));
+        queue.append(dropOuts.fieldLine(i));
     }
 }
 
-// Get the field data for the specified frame
-QVector<SourceVideo::Data> Sources::getFieldData(qint32 targetVbiFrame, bool isFirstField,
-                                                 QVector<qint32> &availableSourcesForFrame)
+// Method to replace the dropout metadata for all the fields in the source's queue
+void Sources::writeQueuedDropOuts(Source &source)
 {
-    // Only display on first field (otherwise we will get 2 of the same debug)
-    if (isFirstField) qDebug() << "Processing VBI Frame" << targetVbiFrame << "-" << availableSourcesForFrame.size() << "sources available";
+    const QVector<qint32> &queue = source.queuedDropOuts;
 
-    // Get the field data for the frame from all of the available sources and copy locally
-    QVector<SourceVideo::Data> fields;
-    fields.resize(getNumberOfAvailableSources());
+    qint32 position = 0;
+    while (position < queue.size()) {
+        const qint32 fieldNumber = queue[position++];
+        const qint32 numberOfDropOuts = queue[position++];
 
-    QVector<SourceVideo::Data*> sourceFirstFieldPointer;
-    sourceFirstFieldPointer.resize(getNumberOfAvailableSources());
+        DropOuts dropOuts;
+        for (qint32 i = 0; i < numberOfDropOuts; i++) {
+            dropOuts.append(queue[position], queue[position + 1], queue[position + 2]);
+            position += 3;
+        }
 
-    for (qint32 sourcePointer = 0; sourcePointer < availableSourcesForFrame.size(); sourcePointer++) {
-        qint32 sourceNo = availableSourcesForFrame[sourcePointer]; // Get the actual source
-        qint32 fieldNumber = -1;
-        if (isFirstField) fieldNumber = sourceVideos[sourceNo]->
-                ldDecodeMetaData.getFirstFieldNumber(convertVbiFrameNumberToSequential(targetVbiFrame, sourceNo));
-        else fieldNumber = sourceVideos[sourceNo]->
-                ldDecodeMetaData.getSecondFieldNumber(convertVbiFrameNumberToSequential(targetVbiFrame, sourceNo));
-
-        // Copy the data locally
-        fields[sourceNo] = (sourceVideos[sourceNo]->sourceVideo.getVideoField(fieldNumber));
+        // Note: This replaces any existing dropouts for the field
+        source.ldDecodeMetaData.updateFieldDropOuts(dropOuts, fieldNumber);
+    }
+
+    source.queuedDropOuts.clear();
+}
+
+// Start reading the field data for the frames to be processed from all the available sources
+void Sources::startSourceReader()
+{
+    QVector<SourceVideo *> sourceVideoFiles;
+    for (qint32 sourceNo = 0; sourceNo < sourceVideos.size(); sourceNo++) {
+        sourceVideoFiles.append(&sourceVideos[sourceNo]->sourceVideo);
+    }
+
+    QVector<MultiSourceReader::FrameFields> frames;
+    for (qint32 vbiFrame = firstFrameNumber; vbiFrame <= lastFrameNumber; vbiFrame++) {
+        MultiSourceReader::FrameFields frameFields;
+        frameFields.firstFieldNumber.fill(-1, sourceVideos.size());
+        frameFields.secondFieldNumber.fill(-1, sourceVideos.size());
+
+        QVector<qint32> availableSourcesForFrame = getAvailableSourcesForFrame(vbiFrame);
+        for (qint32 sourcePointer = 0; sourcePointer < availableSourcesForFrame.size(); sourcePointer++) {
+            qint32 sourceNo = availableSourcesForFrame[sourcePointer]; // Get the actual source
+            const VbiFrameMap::Frame &frame = sourceVideos[sourceNo]->frameMap.getVbiFrame(vbiFrame);
+            frameFields.firstFieldNumber[sourceNo] = frame.firstFieldNumber;
+            frameFields.secondFieldNumber[sourceNo] = frame.secondFieldNumber;
+        }
+
+        frames.append(frameFields);
     }
 
-    return fields;
+    sourceReader.start(sourceVideoFiles, frames);
 }
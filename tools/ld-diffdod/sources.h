@@ -35,6 +35,8 @@
 #include <QThread>
 
 #include "diffdod.h"
+#include "multisourcereader.h"
+#include "vbiframemap.h"
 
 class Sources : public QObject
 {
@@ -66,9 +68,10 @@ private:
         SourceVideo sourceVideo;
         LdDecodeMetaData ldDecodeMetaData;
         QString filename;
-        qint32 minimumVbiFrameNumber;
-        qint32 maximumVbiFrameNumber;
-        bool isSourceCav;
+        VbiFrameMap frameMap;
+
+        // New dropouts waiting to be written into the metadata (guarded by outputMutex)
+        QVector<qint32> queuedDropOuts;
     };
 
     QVector<Source*> sourceVideos;
@@ -85,9 +88,13 @@ private:
     qint32 m_lengthVbi;
     qint32 m_maxThreads;
 
+    // Reads the field data from the sources ahead of the worker threads
+    MultiSourceReader sourceReader;
+
     // Input stream variables (all guarded by inputMutex while threads are running)
     QMutex inputMutex;
     qint32 inputFrameNumber;
+    qint32 firstFrameNumber;
     qint32 lastFrameNumber;
 
     // Output stream variables (all guarded by outputMutex while threads are running)
@@ -105,12 +112,12 @@ private:
     qint32 getMaximumVbiFrameNumber();
     void verifySources(qint32 vbiStartFrame, qint32 length);
     QVector<qint32> getAvailableSourcesForFrame(qint32 vbiFrameNumber);
-    qint32 convertVbiFrameNumberToSequential(qint32 vbiFrameNumber, qint32 sourceNumber);
     qint32 getNumberOfAvailableSources();
     //void processSources(qint32 vbiStartFrame, qint32 length, qint32 dodThreshold, bool lumaClip);
     void saveSources();
-    QVector<SourceVideo::Data> getFieldData(qint32 targetVbiFrame, bool isFirstField,
-                                                     QVector<qint32> &availableSourcesForFrame);
+    void queueFieldDropOuts(Source &source, qint32 fieldNumber, const DropOuts &dropOuts);
+    void writeQueuedDropOuts(Source &source);
+    void startSourceReader();
 };
 
 #endif // SOURCES_H
@@ -10,18 +10,28 @@ CONFIG -= app_bundle
 SOURCES += \
     main.cpp \
     ../library/tbc/lddecodemetadata.cpp \
+    ../library/tbc/jsonreader.cpp \
+    ../library/tbc/jsonwriter.cpp \
     ../library/tbc/sourcevideo.cpp \
+    ../library/tbc/multisourcereader.cpp \
     ../library/tbc/vbidecoder.cpp \
+    ../library/tbc/vbiframemap.cpp \
     ../library/tbc/logging.cpp \
+    ../library/tbc/stagestats.cpp \
     ../library/tbc/dropouts.cpp \
     stacker.cpp \
     stackingpool.cpp
 
 HEADERS += \
     ../library/tbc/lddecodemetadata.h \
+    ../library/tbc/jsonreader.h \
+    ../library/tbc/jsonwriter.h \
     ../library/tbc/sourcevideo.h \
+    ../library/tbc/multisourcereader.h \
     ../library/tbc/vbidecoder.h \
+    ../library/tbc/vbiframemap.h \
     ../library/tbc/logging.h \
+    ../library/tbc/stagestats.h \
     ../library/tbc/dropouts.h \
     stacker.h \
     stackingpool.h
@@ -31,6 +31,7 @@
 #include <QFileInfo>
 
 #include "logging.h"
+#include "stagestats.h"
 #include "lddecodemetadata.h"
 #include "sourcevideo.h"
 #include "stackingpool.h"
@@ -61,6 +62,9 @@ int main(int argc, char *argv[])
     // Add the standard debug options --debug and --quiet
     addStandardDebugOptions(parser);
 
+    // Add the standard statistics options --stats-json and --stats-interval
+    addStandardStatsOptions(parser);
+
     // Option to specify a different JSON input file
     QCommandLineOption inputJsonOption(QStringList() << "input-json",
                                        QCoreApplication::translate("main", "Specify the input JSON file for the first input file (default input.json)"),
@@ -99,6 +103,9 @@ int main(int argc, char *argv[])
     // Standard logging options
     processStandardDebugOptions(parser);
 
+    // Standard statistics options
+    if (!processStandardStatsOptions(parser)) return -1;
+
     // Get the options from the parser
     bool reverse = parser.isSet(setReverseOption);
 
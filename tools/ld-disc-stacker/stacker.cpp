@@ -24,6 +24,7 @@
 
 #include "stacker.h"
 #include "stackingpool.h"
+#include "stagestats.h"
 
 Stacker::Stacker(QAtomicInt& _abort, StackingPool& _stackingPool, QObject *parent)
     : QThread(parent), abort(_abort), stackingPool(_stackingPool)
@@ -53,6 +54,8 @@ void Stacker::run()
             break;
         }
 
+        StageTimer stackTimer("stack");
+
         qint32 totalAvailableSources = firstFieldSeqNo.size();
         qDebug().nospace() << "Frame #" << frameNumber << " - There are " << totalAvailableSources << " sources available of which " <<
                               availableSourcesForFrame.size() << " contain the required frame";
@@ -66,6 +69,8 @@ void Stacker::run()
         stackField(firstSourceField, videoParameters[0], firstFieldMetadata, availableSourcesForFrame, outputFirstField, outputFirstFieldDropOuts);
         stackField(secondSourceField, videoParameters[0], secondFieldMetadata, availableSourcesForFrame, outputSecondField, outputSecondFieldDropOuts);
 
+        stackTimer.stop();
+
         // Return the processed fields
         stackingPool.setOutputFrame(frameNumber, outputFirstField, outputSecondField,
                                     firstFieldSeqNo[0], secondFieldSeqNo[0],
@@ -81,13 +86,18 @@ void Stacker::stackField(QVector<SourceVideo::Data> inputFields,
                                       SourceVideo::Data &outputField,
                                       DropOuts &dropOuts)
 {
+    // Index the sources' dropouts by line, for quick lookup
+    for (qint32 i = 0; i < availableSourcesForFrame.size(); i++) {
+        fieldMetadata[availableSourcesForFrame[i]].dropOuts.sort();
+    }
+
     for (qint32 y = 0; y < videoParameters.fieldHeight; y++) {
         for (qint32 x = 0; x < videoParameters.fieldWidth; x++) {
             // Get the input values from the input sources
             QVector<quint16> inputValues;
             for (qint32 i = 0; i < availableSourcesForFrame.size(); i++) {
                 // Include the source's pixel data if it's not marked as a dropout
-                if (!isDropout(fieldMetadata[availableSourcesForFrame[i]].dropOuts, x, y)) {
+                if (!fieldMetadata[availableSourcesForFrame[i]].dropOuts.isDropout(y + 1, x)) {
                     // Pixel is valid
                     inputValues.append(inputFields[availableSourcesForFrame[i]][(videoParameters.fieldWidth * y) + x]);
                 }
@@ -138,17 +148,4 @@ quint16 Stacker::median(QVector<quint16> v)
     return (v[(v.size() - 1) / 2] + v[n]) / 2;
 }
 
-// Method returns true if specified pixel is a dropout
-bool Stacker::isDropout(DropOuts dropOuts, qint32 fieldX, qint32 fieldY)
-{
-    for (qint32 i = 0; i < dropOuts.size(); i++) {
-        if ((dropOuts.fieldLine(i) - 1) == fieldY) {
-            if ((fieldX >= dropOuts.startx(i)) && (fieldX <= dropOuts.endx(i)))
-                return true;
-        }
-    }
-
-    return false;
-}
-
 
@@ -56,7 +56,6 @@ private:
                     QVector<LdDecodeMetaData::Field> fieldMetadata, QVector<qint32> availableSourcesForFrame,
                     SourceVideo::Data &outputField, DropOuts &dropOuts);
     quint16 median(QVector<quint16> v);
-    bool isDropout(DropOuts dropOuts, qint32 fieldX, qint32 fieldY);
 };
 
 #endif // STACKER_H
@@ -24,12 +24,15 @@
 
 #include "stackingpool.h"
 
+#include "stagestats.h"
+
 StackingPool::StackingPool(QString _outputFilename, QString _outputJsonFilename,
                              qint32 _maxThreads, QVector<LdDecodeMetaData *> &_ldDecodeMetaData, QVector<SourceVideo *> &_sourceVideos,
                              bool _reverse, QObject *parent)
     : QObject(parent), outputFilename(_outputFilename), outputJsonFilename(_outputJsonFilename),
       maxThreads(_maxThreads), reverse(_reverse),
-      abort(false), ldDecodeMetaData(_ldDecodeMetaData), sourceVideos(_sourceVideos)
+      abort(false), ldDecodeMetaData(_ldDecodeMetaData), sourceVideos(_sourceVideos),
+      sourceReader(_maxThreads * 2)
 {
 }
 
@@ -70,7 +73,7 @@ bool StackingPool::process()
 
     qInfo() << "Scanning source videos for VBI frame number ranges...";
     // Get the VBI frame range for all sources
-    if (!setMinAndMaxVbiFrames()) {
+    if (!buildSourceFrameMaps()) {
         qInfo() << "It was not possible to determine the VBI frame number range for the source video - cannot continue!";
         return false;
     }
@@ -84,6 +87,14 @@ bool StackingPool::process()
     lastFrameNumber = ldDecodeMetaData[0]->getNumberOfFrames();
     totalTimer.start();
 
+    // Work out which fields are needed from each source for every frame, and
+    // start reading them in the background
+    inputFrameFields.resize(lastFrameNumber);
+    for (qint32 frameNumber = 1; frameNumber <= lastFrameNumber; frameNumber++) {
+        inputFrameFields[frameNumber - 1] = getFrameFields(frameNumber);
+    }
+    sourceReader.start(sourceVideos, inputFrameFields);
+
     // Start a vector of decoding threads to process the video
     qInfo() << "Beginning multi-threaded disc stacking process...";
     QVector<QThread *> threads;
@@ -98,6 +109,7 @@ bool StackingPool::process()
         threads[i]->wait();
         delete threads[i];
     }
+    sourceReader.stop();
 
     // Did any of the threads abort?
     if (abort) {
@@ -130,6 +142,7 @@ bool StackingPool::getInputFrame(qint32& frameNumber,
                                   bool& _reverse,
                                   QVector<qint32>& availableSourcesForFrame)
 {
+    StageTimer timer("input");
     QMutexLocker locker(&inputMutex);
 
     if (inputFrameNumber > lastFrameNumber) {
@@ -148,54 +161,29 @@ bool StackingPool::getInputFrame(qint32& frameNumber,
 
     // Prepare the vectors
     firstFieldNumber.resize(numberOfSources);
-    firstFieldVideoData.resize(numberOfSources);
     firstFieldMetadata.resize(numberOfSources);
     secondFieldNumber.resize(numberOfSources);
-    secondFieldVideoData.resize(numberOfSources);
     secondFieldMetadata.resize(numberOfSources);
     videoParameters.resize(numberOfSources);
 
     // Get the current VBI frame number based on the first source
     qint32 currentVbiFrame = -1;
-    if (numberOfSources > 1) currentVbiFrame = convertSequentialFrameNumberToVbi(frameNumber, 0);
+    if (numberOfSources > 1) currentVbiFrame = sourceFrameMaps[0].convertSequentialFrameNumberToVbi(frameNumber);
     for (qint32 sourceNo = 0; sourceNo < numberOfSources; sourceNo++) {
-        // Determine the fields for the input frame
-        firstFieldNumber[sourceNo] = -1;
-        secondFieldNumber[sourceNo] = -1;
-
-        if (sourceNo == 0) {
-            // No need to perform VBI frame number mapping on the first source
-            firstFieldNumber[sourceNo] = ldDecodeMetaData[sourceNo]->getFirstFieldNumber(frameNumber);
-            secondFieldNumber[sourceNo] = ldDecodeMetaData[sourceNo]->getSecondFieldNumber(frameNumber);
-            qDebug().nospace() << "Source #0 fields are " <<
-                                  firstFieldNumber[sourceNo] << "/" << secondFieldNumber[sourceNo];
-        } else if (currentVbiFrame >= sourceMinimumVbiFrame[sourceNo] && currentVbiFrame <= sourceMaximumVbiFrame[sourceNo]) {
-            // Use VBI frame number mapping to get the same frame from the
-            // current additional source
-            qint32 currentSourceFrameNumber = convertVbiFrameNumberToSequential(currentVbiFrame, sourceNo);
-            firstFieldNumber[sourceNo] = ldDecodeMetaData[sourceNo]->getFirstFieldNumber(currentSourceFrameNumber);
-            secondFieldNumber[sourceNo] = ldDecodeMetaData[sourceNo]->getSecondFieldNumber(currentSourceFrameNumber);
-
-            qDebug().nospace() << "Source #" << sourceNo << " has VBI frame number " << currentVbiFrame <<
-                        " and fields " << firstFieldNumber[sourceNo] << "/" << secondFieldNumber[sourceNo];
-        } else {
-            qDebug().nospace() << "Source #" << sourceNo << " does not contain a usable frame";
-        }
+        // Get the fields for the input frame
+        firstFieldNumber[sourceNo] = inputFrameFields[frameNumber - 1].firstFieldNumber[sourceNo];
+        secondFieldNumber[sourceNo] = inputFrameFields[frameNumber - 1].secondFieldNumber[sourceNo];
 
         // If the field numbers are valid - get the rest of the required data
         if (firstFieldNumber[sourceNo] != -1 && secondFieldNumber[sourceNo] != -1) {
-            // Fetch the input data (get the fields in TBC sequence order to save seeking)
-            if (firstFieldNumber[sourceNo] < secondFieldNumber[sourceNo]) {
-                firstFieldVideoData[sourceNo] = sourceVideos[sourceNo]->getVideoField(firstFieldNumber[sourceNo]);
-                secondFieldVideoData[sourceNo] = sourceVideos[sourceNo]->getVideoField(secondFieldNumber[sourceNo]);
-            } else {
-                secondFieldVideoData[sourceNo] = sourceVideos[sourceNo]->getVideoField(secondFieldNumber[sourceNo]);
-                firstFieldVideoData[sourceNo] = sourceVideos[sourceNo]->getVideoField(firstFieldNumber[sourceNo]);
-            }
+            qDebug().nospace() << "Source #" << sourceNo << " has VBI frame number " << currentVbiFrame <<
+                        " and fields " << firstFieldNumber[sourceNo] << "/" << secondFieldNumber[sourceNo];
 
             firstFieldMetadata[sourceNo] = ldDecodeMetaData[sourceNo]->getField(firstFieldNumber[sourceNo]);
             secondFieldMetadata[sourceNo] = ldDecodeMetaData[sourceNo]->getField(secondFieldNumber[sourceNo]);
             videoParameters[sourceNo] = ldDecodeMetaData[sourceNo]->getVideoParameters();
+        } else {
+            qDebug().nospace() << "Source #" << sourceNo << " does not contain a usable frame";
         }
     }
 
@@ -210,7 +198,10 @@ bool StackingPool::getInputFrame(qint32& frameNumber,
     // Set the other miscellaneous parameters
     _reverse = reverse;
 
-    return true;
+    // Wait for the source reader to provide the field data. This doesn't need
+    // the input lock, so other threads can carry on meanwhile.
+    locker.unlock();
+    return sourceReader.getFrame(frameNumber - 1, firstFieldVideoData, secondFieldVideoData);
 }
 
 // Put a corrected frame into the output stream.
@@ -226,7 +217,9 @@ bool StackingPool::setOutputFrame(qint32 frameNumber,
                                    qint32 firstFieldSeqNo, qint32 secondFieldSeqNo,
                                    DropOuts firstTargetFieldDropOuts, DropOuts secondTargetFieldDropouts)
 {
+    StageTimer timer("output");
     QMutexLocker locker(&outputMutex);
+    StageStats::count("frames");
 
     // Put the output frame into the map
     OutputFrame pendingFrame;
@@ -281,130 +274,77 @@ bool StackingPool::setOutputFrame(qint32 frameNumber,
     return true;
 }
 
-// Determine the minimum and maximum VBI frame numbers for all sources
+// Build the VBI frame maps for all sources
 // Expects sourceVideos[] and ldDecodeMetaData[] to be populated
-// Note: This function returns frame number even if the disc is CLV - conversion
-// from timecodes is performed automatically.
-bool StackingPool::setMinAndMaxVbiFrames()
+// Note: CLV time-codes are converted to frame numbers automatically.
+bool StackingPool::buildSourceFrameMaps()
 {
     // Determine the number of sources available
     qint32 numberOfSources = sourceVideos.size();
-
-    // Resize vectors
-    sourceDiscTypeCav.resize(numberOfSources);
-    sourceMaximumVbiFrame.resize(numberOfSources);
-    sourceMinimumVbiFrame.resize(numberOfSources);
+    sourceFrameMaps.resize(numberOfSources);
 
     for (qint32 sourceNumber = 0; sourceNumber < numberOfSources; sourceNumber++) {
         // Determine the disc type and max/min VBI frame numbers
-        VbiDecoder vbiDecoder;
-        qint32 cavCount = 0;
-        qint32 clvCount = 0;
-        qint32 cavMin = 1000000;
-        qint32 cavMax = 0;
-        qint32 clvMin = 1000000;
-        qint32 clvMax = 0;
-
-        sourceMinimumVbiFrame[sourceNumber] = 0;
-        sourceMaximumVbiFrame[sourceNumber] = 0;
-        sourceDiscTypeCav[sourceNumber] = false;
-
-        // Using sequential frame numbering starting from 1
-        for (qint32 seqFrame = 1; seqFrame <= ldDecodeMetaData[sourceNumber]->getNumberOfFrames(); seqFrame++) {
-            // Get the VBI data and then decode
-            QVector<qint32> vbi1 = ldDecodeMetaData[sourceNumber]->getFieldVbi(ldDecodeMetaData[sourceNumber]->getFirstFieldNumber(seqFrame)).vbiData;
-            QVector<qint32> vbi2 = ldDecodeMetaData[sourceNumber]->getFieldVbi(ldDecodeMetaData[sourceNumber]->getSecondFieldNumber(seqFrame)).vbiData;
-            VbiDecoder::Vbi vbi = vbiDecoder.decodeFrame(vbi1[0], vbi1[1], vbi1[2], vbi2[0], vbi2[1], vbi2[2]);
-
-            // Look for a complete, valid CAV picture number or CLV time-code
-            if (vbi.picNo > 0) {
-                cavCount++;
-
-                if (vbi.picNo < cavMin) cavMin = vbi.picNo;
-                if (vbi.picNo > cavMax) cavMax = vbi.picNo;
-            }
-
-            if (vbi.clvHr != -1 && vbi.clvMin != -1 &&
-                    vbi.clvSec != -1 && vbi.clvPicNo != -1) {
-                clvCount++;
-
-                LdDecodeMetaData::ClvTimecode timecode;
-                timecode.hours = vbi.clvHr;
-                timecode.minutes = vbi.clvMin;
-                timecode.seconds = vbi.clvSec;
-                timecode.pictureNumber = vbi.clvPicNo;
-                qint32 cvFrameNumber = ldDecodeMetaData[sourceNumber]->convertClvTimecodeToFrameNumber(timecode);
-
-                if (cvFrameNumber < clvMin) clvMin = cvFrameNumber;
-                if (cvFrameNumber > clvMax) clvMax = cvFrameNumber;
-            }
-        }
-        qDebug() << "StackingPool::setMinAndMaxVbiFrames(): Got" << cavCount << "CAV picture codes and" << clvCount << "CLV timecodes";
-
-        // If the metadata has no picture numbers or time-codes, we cannot use the source
-        if (cavCount == 0 && clvCount == 0) {
-            qDebug() << "StackingPool::setMinAndMaxVbiFrames(): Source does not seem to contain valid CAV picture numbers or CLV time-codes - cannot process";
+        if (!sourceFrameMaps[sourceNumber].build(*ldDecodeMetaData[sourceNumber])) {
+            qDebug() << "StackingPool::buildSourceFrameMaps(): Source does not seem to contain valid CAV picture numbers or CLV time-codes - cannot process";
             return false;
         }
 
-        // Determine disc type
-        if (cavCount > clvCount) {
-            sourceDiscTypeCav[sourceNumber] = true;
-            qDebug() << "StackingPool::setMinAndMaxVbiFrames(): Got" << cavCount << "valid CAV picture numbers - source disc type is CAV";
+        if (sourceFrameMaps[sourceNumber].isDiscCav()) {
             qInfo().nospace() << "Source #" << sourceNumber << " has a disc type of CAV (uses VBI frame numbers)";
-
-            sourceMaximumVbiFrame[sourceNumber] = cavMax;
-            sourceMinimumVbiFrame[sourceNumber] = cavMin;
         } else {
-            sourceDiscTypeCav[sourceNumber] = false;
-            qDebug() << "StackingPool::setMinAndMaxVbiFrames(): Got" << clvCount << "valid CLV picture numbers - source disc type is CLV";
             qInfo().nospace() << "Source #" << sourceNumber << " has a disc type of CLV (uses VBI time codes)";
-
-            sourceMaximumVbiFrame[sourceNumber] = clvMax;
-            sourceMinimumVbiFrame[sourceNumber] = clvMin;
         }
 
-        qInfo().nospace() << "Source #" << sourceNumber << " has a VBI frame number range of " << sourceMinimumVbiFrame[sourceNumber] << " to " <<
-            sourceMaximumVbiFrame[sourceNumber];
+        qInfo().nospace() << "Source #" << sourceNumber << " has a VBI frame number range of " << sourceFrameMaps[sourceNumber].getMinimumVbiFrame() << " to " <<
+            sourceFrameMaps[sourceNumber].getMaximumVbiFrame();
     }
 
     return true;
 }
 
-// Method to convert the first source sequential frame number to a VBI frame number
-qint32 StackingPool::convertSequentialFrameNumberToVbi(qint32 sequentialFrameNumber, qint32 sourceNumber)
-{
-    return (sourceMinimumVbiFrame[sourceNumber] - 1) + sequentialFrameNumber;
-}
-
-// Method to convert a VBI frame number to a sequential frame number
-qint32 StackingPool::convertVbiFrameNumberToSequential(qint32 vbiFrameNumber, qint32 sourceNumber)
-{
-    // Offset the VBI frame number to get the sequential source frame number
-    return vbiFrameNumber - sourceMinimumVbiFrame[sourceNumber] + 1;
-}
-
 // Method that returns a vector of the sources that contain data for the required VBI frame number
 QVector<qint32> StackingPool::getAvailableSourcesForFrame(qint32 vbiFrameNumber)
 {
     QVector<qint32> availableSourcesForFrame;
     for (qint32 sourceNo = 0; sourceNo < sourceVideos.size(); sourceNo++) {
-        if (vbiFrameNumber >= sourceMinimumVbiFrame[sourceNo] && vbiFrameNumber <= sourceMaximumVbiFrame[sourceNo]) {
-            // Get the field numbers for the frame
-            qint32 firstFieldNumber = ldDecodeMetaData[sourceNo]->getFirstFieldNumber(convertVbiFrameNumberToSequential(vbiFrameNumber, sourceNo));
-            qint32 secondFieldNumber = ldDecodeMetaData[sourceNo]->getSecondFieldNumber(convertVbiFrameNumberToSequential(vbiFrameNumber, sourceNo));
-
-            // Ensure the frame is not a padded field (i.e. missing)
-            if (!(ldDecodeMetaData[sourceNo]->getField(firstFieldNumber).pad &&
-                  ldDecodeMetaData[sourceNo]->getField(secondFieldNumber).pad)) {
-                availableSourcesForFrame.append(sourceNo);
-            }
+        if (sourceFrameMaps[sourceNo].containsVbiFrame(vbiFrameNumber)) {
+            availableSourcesForFrame.append(sourceNo);
         }
     }
 
     return availableSourcesForFrame;
 }
 
+// Method to determine which fields to use from each source for a sequential frame number
+MultiSourceReader::FrameFields StackingPool::getFrameFields(qint32 frameNumber)
+{
+    qint32 numberOfSources = sourceVideos.size();
+
+    MultiSourceReader::FrameFields frameFields;
+    frameFields.firstFieldNumber.fill(-1, numberOfSources);
+    frameFields.secondFieldNumber.fill(-1, numberOfSources);
+
+    // Get the current VBI frame number based on the first source
+    qint32 currentVbiFrame = -1;
+    if (numberOfSources > 1) currentVbiFrame = sourceFrameMaps[0].convertSequentialFrameNumberToVbi(frameNumber);
+    for (qint32 sourceNo = 0; sourceNo < numberOfSources; sourceNo++) {
+        if (sourceNo == 0) {
+            // No need to perform VBI frame number mapping on the first source
+            frameFields.firstFieldNumber[sourceNo] = ldDecodeMetaData[sourceNo]->getFirstFieldNumber(frameNumber);
+            frameFields.secondFieldNumber[sourceNo] = ldDecodeMetaData[sourceNo]->getSecondFieldNumber(frameNumber);
+        } else {
+            // Use VBI frame number mapping to get the same frame from the
+            // current additional source (if it has it)
+            const VbiFrameMap::Frame &frame = sourceFrameMaps[sourceNo].getVbiFrame(currentVbiFrame);
+            frameFields.firstFieldNumber[sourceNo] = frame.firstFieldNumber;
+            frameFields.secondFieldNumber[sourceNo] = frame.secondFieldNumber;
+        }
+    }
+
+    return frameFields;
+}
+
 // Write a field to the output file.
 // Returns true on success, false on failure.
 bool StackingPool::writeOutputField(const SourceVideo::Data &fieldData)
@@ -33,6 +33,8 @@
 
 #include "sourcevideo.h"
 #include "lddecodemetadata.h"
+#include "multisourcereader.h"
+#include "vbiframemap.h"
 #include "stacker.h"
 
 class StackingPool : public QObject
@@ -74,6 +76,8 @@ private:
     qint32 lastFrameNumber;
     QVector<LdDecodeMetaData *> &ldDecodeMetaData;
     QVector<SourceVideo *> &sourceVideos;
+    QVector<MultiSourceReader::FrameFields> inputFrameFields;
+    MultiSourceReader sourceReader;
 
     // Output stream information (all guarded by outputMutex while threads are running)
     QMutex outputMutex;
@@ -92,14 +96,11 @@ private:
     QFile targetVideo;
 
     // Local source information
-    QVector<bool> sourceDiscTypeCav;
-    QVector<qint32> sourceMinimumVbiFrame;
-    QVector<qint32> sourceMaximumVbiFrame;
+    QVector<VbiFrameMap> sourceFrameMaps;
 
-    bool setMinAndMaxVbiFrames();
-    qint32 convertSequentialFrameNumberToVbi(qint32 sequentialFrameNumber, qint32 sourceNumber);
-    qint32 convertVbiFrameNumberToSequential(qint32 vbiFrameNumber, qint32 sourceNumber);
+    bool buildSourceFrameMaps();
     QVector<qint32> getAvailableSourcesForFrame(qint32 vbiFrameNumber);
+    MultiSourceReader::FrameFields getFrameFields(qint32 frameNumber);
     bool writeOutputField(const SourceVideo::Data &fieldData);
 };
 
@@ -66,19 +66,14 @@ DiscMap::DiscMap(const QFileInfo &metadataFileInfo, const bool &reverseFieldOrde
     // Resize the frame store
     m_frames.resize(m_numberOfFrames);
 
-    // Decode the VBI information for the TBC and initialise the frame object
-    VbiDecoder vbiDecoder;
-    QVector<VbiDecoder::Vbi> vbiData(m_numberOfFrames);
+    // Get the decoded VBI information for the TBC and initialise the frame object
+    const QVector<VbiDecoder::Vbi> vbiData = ldDecodeMetaData->getFrameVbiTable();
     for (qint32 frameNumber = 0; frameNumber < m_numberOfFrames; frameNumber++) {
         // Store the original sequential frame number and the fields
         m_frames[frameNumber].seqFrameNumber(frameNumber + 1);
         m_frames[frameNumber].firstField(ldDecodeMetaData->getFirstFieldNumber(frameNumber + 1));
         m_frames[frameNumber].secondField(ldDecodeMetaData->getSecondFieldNumber(frameNumber + 1));
 
-        // Get the VBI data and then decode (frames are indexed from 1)
-        QVector<qint32> vbi1 = ldDecodeMetaData->getFieldVbi(ldDecodeMetaData->getFirstFieldNumber(frameNumber + 1)).vbiData;
-        QVector<qint32> vbi2 = ldDecodeMetaData->getFieldVbi(ldDecodeMetaData->getSecondFieldNumber(frameNumber + 1)).vbiData;
-        vbiData[frameNumber] = vbiDecoder.decodeFrame(vbi1[0], vbi1[1], vbi1[2], vbi2[0], vbi2[1], vbi2[2]);
 
         if (vbiData[frameNumber].leadIn || vbiData[frameNumber].leadOut) m_frames[frameNumber].isLeadInOrOut(true);
         else m_frames[frameNumber].isLeadInOrOut(false);
@@ -16,6 +16,8 @@ DEFINES += QT_DEPRECATED_WARNINGS
 
 SOURCES += \
     ../library/tbc/lddecodemetadata.cpp \
+    ../library/tbc/jsonreader.cpp \
+    ../library/tbc/jsonwriter.cpp \
     ../library/tbc/sourcevideo.cpp \
     ../library/tbc/vbidecoder.cpp \
     ../library/tbc/logging.cpp \
@@ -27,6 +29,8 @@ SOURCES += \
 
 HEADERS += \
     ../library/tbc/lddecodemetadata.h \
+    ../library/tbc/jsonreader.h \
+    ../library/tbc/jsonwriter.h \
     ../library/tbc/sourcevideo.h \
     ../library/tbc/vbidecoder.h \
     ../library/tbc/logging.h \
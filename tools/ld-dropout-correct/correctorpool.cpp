@@ -25,12 +25,21 @@
 
 #include "correctorpool.h"
 
-CorrectorPool::CorrectorPool(QString _outputFilename, QString _outputJsonFilename,
-                             qint32 _maxThreads, QVector<LdDecodeMetaData *> &_ldDecodeMetaData, QVector<SourceVideo *> &_sourceVideos,
-                             bool _reverse, bool _intraField, bool _overCorrect, QObject *parent)
-    : QObject(parent), outputFilename(_outputFilename), outputJsonFilename(_outputJsonFilename),
-      maxThreads(_maxThreads), reverse(_reverse), intraField(_intraField), overCorrect(_overCorrect),
-      abort(false), ldDecodeMetaData(_ldDecodeMetaData), sourceVideos(_sourceVideos)
+#include "stagestats.h"
+
+#include <algorithm>
+
+#ifdef Q_OS_LINUX
+#include <unistd.h>
+#endif
+
+CorrectorPool::CorrectorPool(QString _inputFilename, QString _outputFilename, QString _outputJsonFilename,
+                             qint32 _startFrame, qint32 _length, qint32 _maxThreads, QVector<LdDecodeMetaData *> &_ldDecodeMetaData, QVector<SourceVideo *> &_sourceVideos,
+                             bool _reverse, bool _intraField, bool _overCorrect, bool _selective, QObject *parent)
+    : QObject(parent), inputFilename(_inputFilename), outputFilename(_outputFilename), outputJsonFilename(_outputJsonFilename),
+      startFrame(_startFrame), length(_length), maxThreads(_maxThreads), reverse(_reverse), intraField(_intraField), overCorrect(_overCorrect), selective(_selective),
+      abort(false), ldDecodeMetaData(_ldDecodeMetaData), sourceVideos(_sourceVideos),
+      sourceReader(_maxThreads * 2)
 {
 }
 
@@ -39,7 +48,21 @@ bool CorrectorPool::process()
     qInfo() << "Performing final sanity checks...";
     // Open the target video
     targetVideo.setFileName(outputFilename);
-    if (outputFilename == "-") {
+    if (selective) {
+        // Start with a copy of the input, then only rewrite the fields that
+        // need correcting
+        qInfo() << "Copying the input TBC file to the output TBC file...";
+        if (!copyInputVideo()) {
+                // Could not copy the source video file
+                qInfo() << "Unable to copy the input video file to the output video file";
+                return false;
+        }
+        if (!targetVideo.open(QIODevice::ReadWrite)) {
+                // Could not open target video file
+                qInfo() << "Unable to open output video file";
+                return false;
+        }
+    } else if (outputFilename == "-") {
         if (!targetVideo.open(stdout, QIODevice::WriteOnly)) {
                 // Could not open stdout
                 qInfo() << "Unable to open stdout";
@@ -59,7 +82,7 @@ bool CorrectorPool::process()
     qint32 firstFieldNumber = ldDecodeMetaData[0]->getFirstFieldNumber(1);
     qint32 secondFieldNumber = ldDecodeMetaData[0]->getSecondFieldNumber(1);
 
-    if (firstFieldNumber != 1 && secondFieldNumber != 1) {
+    if (!selective && firstFieldNumber != 1 && secondFieldNumber != 1) {
         SourceVideo::Data sourceField = sourceVideos[0]->getVideoField(1);
         if (!writeOutputField(sourceField)) {
             // Could not write to target TBC file
@@ -73,26 +96,57 @@ bool CorrectorPool::process()
     if (sourceVideos.size() > 1) {
         qInfo() << "Performing multi-source correction... Scanning source videos for VBI frame number ranges...";
         // Get the VBI frame range for all sources
-        if (!setMinAndMaxVbiFrames()) {
+        if (!buildSourceFrameMaps()) {
             qInfo() << "It was not possible to determine the VBI frame number range for the source video - cannot continue!";
             return false;
         }
     }
 
-    // Show some information for the user
-    qInfo() << "Using" << maxThreads << "threads to process" << ldDecodeMetaData[0]->getNumberOfFrames() << "frames";
-
     // Initialise reporting
     sameSourceConcealmentTotal = 0;
     multiSourceConcealmentTotal = 0;
     multiSourceCorrectionTotal = 0;
+    selectiveFrameCount = 0;
 
     // Initialise processing state
-    inputFrameNumber = 1;
+    inputFrameIndex = 0;
     outputFrameNumber = 1;
     lastFrameNumber = ldDecodeMetaData[0]->getNumberOfFrames();
     totalTimer.start();
 
+    // Limit processing to the selected range of frames, if any (the other
+    // frames have already been copied to the output in selective mode)
+    const qint32 firstFrameNumber = (startFrame == -1) ? 1 : startFrame;
+    if (length != -1) lastFrameNumber = qMin(lastFrameNumber, firstFrameNumber + length - 1);
+    const qint32 numberOfFrames = lastFrameNumber - firstFrameNumber + 1;
+
+    // Work out which frames to process. In selective mode, frames without
+    // drop outs are already correct in the output, so they can be skipped.
+    inputFrameList.clear();
+    for (qint32 frameNumber = firstFrameNumber; frameNumber <= lastFrameNumber; frameNumber++) {
+        if (selective && !frameHasDropOuts(frameNumber)) continue;
+        inputFrameList.append(frameNumber);
+    }
+
+    // Show some information for the user
+    if (selective) {
+        qInfo() << "Using" << maxThreads << "threads to process" << inputFrameList.size() << "of" << numberOfFrames <<
+                   "frames (the rest contain no drop-outs)";
+    } else {
+        qInfo() << "Using" << maxThreads << "threads to process" << numberOfFrames << "frames";
+    }
+
+    // Work out which fields are needed from each source for every frame, and
+    // how good each source's copy of the frame is, then start reading the
+    // fields in the background
+    inputFrameFields.resize(inputFrameList.size());
+    inputFrameSources.resize(inputFrameList.size());
+    for (qint32 frameIndex = 0; frameIndex < inputFrameList.size(); frameIndex++) {
+        inputFrameFields[frameIndex] = getFrameFields(inputFrameList[frameIndex]);
+        inputFrameSources[frameIndex] = getFrameSources(inputFrameList[frameIndex], inputFrameFields[frameIndex]);
+    }
+    sourceReader.start(sourceVideos, inputFrameFields);
+
     // Start a vector of decoding threads to process the video
     qInfo() << "Beginning multi-threaded dropout correction process...";
     QVector<QThread *> threads;
@@ -107,6 +161,7 @@ bool CorrectorPool::process()
         threads[i]->wait();
         delete threads[i];
     }
+    sourceReader.stop();
 
     // Did any of the threads abort?
     if (abort) {
@@ -116,8 +171,14 @@ bool CorrectorPool::process()
 
     // Show the processing speed to the user
     qreal totalSecs = (static_cast<qreal>(totalTimer.elapsed()) / 1000.0);
-    qInfo() << "Dropout correction complete -" << lastFrameNumber << "frames in" << totalSecs << "seconds (" <<
-               lastFrameNumber / totalSecs << "FPS )";
+    qInfo() << "Dropout correction complete -" << numberOfFrames << "frames in" << totalSecs << "seconds (" <<
+               numberOfFrames / totalSecs << "FPS )";
+
+    // Summarise what selective mode changed
+    if (selective) {
+        qInfo() << "Rewrote" << 2 * selectiveFrameCount << "fields in" << selectiveFrameCount << "frames containing drop-outs;" <<
+                   ldDecodeMetaData[0]->getNumberOfFields() - (2 * selectiveFrameCount) << "fields were left as copied";
+    }
 
     qInfo() << "Creating JSON metadata file for drop-out corrected TBC...";
     ldDecodeMetaData[0]->write(outputJsonFilename);
@@ -139,15 +200,17 @@ bool CorrectorPool::getInputFrame(qint32& frameNumber,
                                   bool& _reverse, bool& _intraField, bool& _overCorrect,
                                   QVector<qint32>& availableSourcesForFrame, QVector<qreal>& sourceFrameQuality)
 {
+    StageTimer timer("input");
     QMutexLocker locker(&inputMutex);
 
-    if (inputFrameNumber > lastFrameNumber) {
+    if (inputFrameIndex >= inputFrameList.size()) {
         // No more input frames
         return false;
     }
 
-    frameNumber = inputFrameNumber;
-    inputFrameNumber++;
+    const qint32 frameIndex = inputFrameIndex;
+    frameNumber = inputFrameList[frameIndex];
+    inputFrameIndex++;
 
     // Determine the number of sources available
     qint32 numberOfSources = sourceVideos.size();
@@ -157,47 +220,28 @@ bool CorrectorPool::getInputFrame(qint32& frameNumber,
 
     // Prepare the vectors
     firstFieldNumber.resize(numberOfSources);
-    firstFieldVideoData.resize(numberOfSources);
     firstFieldMetadata.resize(numberOfSources);
     secondFieldNumber.resize(numberOfSources);
-    secondFieldVideoData.resize(numberOfSources);
     secondFieldMetadata.resize(numberOfSources);
     videoParameters.resize(numberOfSources);
-    sourceFrameQuality.resize(numberOfSources);
+
+    // Get the frame quality and source ranking from the table
+    sourceFrameQuality = inputFrameSources[frameIndex].quality;
+    availableSourcesForFrame = inputFrameSources[frameIndex].rankedSources;
 
     // Get the current VBI frame number based on the first source
     qint32 currentVbiFrame = -1;
-    if (numberOfSources > 1) currentVbiFrame = convertSequentialFrameNumberToVbi(frameNumber, 0);
+    if (numberOfSources > 1) currentVbiFrame = sourceFrameMaps[0].convertSequentialFrameNumberToVbi(frameNumber);
     for (qint32 sourceNo = 0; sourceNo < numberOfSources; sourceNo++) {
-        // Determine the fields for the input frame
-        firstFieldNumber[sourceNo] = -1;
-        secondFieldNumber[sourceNo] = -1;
-        sourceFrameQuality[sourceNo] = -1;
-
-        if (sourceNo == 0) {
-            // No need to perform VBI frame number mapping on the first source
-            firstFieldNumber[sourceNo] = ldDecodeMetaData[sourceNo]->getFirstFieldNumber(frameNumber);
-            secondFieldNumber[sourceNo] = ldDecodeMetaData[sourceNo]->getSecondFieldNumber(frameNumber);
-
-            // Determine the frame quality (currently this is based on frame average black SNR)
-            qreal firstFrameSnr = ldDecodeMetaData[sourceNo]->getField(firstFieldNumber[sourceNo]).vitsMetrics.bPSNR;
-            qreal secondFrameSnr = ldDecodeMetaData[sourceNo]->getField(secondFieldNumber[sourceNo]).vitsMetrics.bPSNR;
-            sourceFrameQuality[sourceNo] = (firstFrameSnr + secondFrameSnr) / 2.0;
-
-            qDebug().nospace() << "CorrectorPool::getInputFrame(): Source #0 fields are " <<
-                                  firstFieldNumber[sourceNo] << "/" << secondFieldNumber[sourceNo] <<
-                                  " (quality is " << sourceFrameQuality[sourceNo] << ")";
-        } else if (currentVbiFrame >= sourceMinimumVbiFrame[sourceNo] && currentVbiFrame <= sourceMaximumVbiFrame[sourceNo]) {
-            // Use VBI frame number mapping to get the same frame from the
-            // current additional source
-            qint32 currentSourceFrameNumber = convertVbiFrameNumberToSequential(currentVbiFrame, sourceNo);
-            firstFieldNumber[sourceNo] = ldDecodeMetaData[sourceNo]->getFirstFieldNumber(currentSourceFrameNumber);
-            secondFieldNumber[sourceNo] = ldDecodeMetaData[sourceNo]->getSecondFieldNumber(currentSourceFrameNumber);
+        // Get the fields for the input frame
+        firstFieldNumber[sourceNo] = inputFrameFields[frameIndex].firstFieldNumber[sourceNo];
+        secondFieldNumber[sourceNo] = inputFrameFields[frameIndex].secondFieldNumber[sourceNo];
 
-            // Determine the frame quality (currently this is based on frame average black SNR)
-            qreal firstFrameSnr = ldDecodeMetaData[sourceNo]->getField(firstFieldNumber[sourceNo]).vitsMetrics.bPSNR;
-            qreal secondFrameSnr = ldDecodeMetaData[sourceNo]->getField(secondFieldNumber[sourceNo]).vitsMetrics.bPSNR;
-            sourceFrameQuality[sourceNo] = (firstFrameSnr + secondFrameSnr) / 2.0;
+        // If the field numbers are valid - get the rest of the required data
+        if (firstFieldNumber[sourceNo] != -1 && secondFieldNumber[sourceNo] != -1) {
+            firstFieldMetadata[sourceNo] = ldDecodeMetaData[sourceNo]->getField(firstFieldNumber[sourceNo]);
+            secondFieldMetadata[sourceNo] = ldDecodeMetaData[sourceNo]->getField(secondFieldNumber[sourceNo]);
+            videoParameters[sourceNo] = ldDecodeMetaData[sourceNo]->getVideoParameters();
 
             qDebug().nospace() << "CorrectorPool::getInputFrame(): Source #" << sourceNo << " has VBI frame number " << currentVbiFrame <<
                         " and fields " << firstFieldNumber[sourceNo] << "/" << secondFieldNumber[sourceNo] <<
@@ -205,30 +249,6 @@ bool CorrectorPool::getInputFrame(qint32& frameNumber,
         } else {
             qDebug().nospace() << "CorrectorPool::getInputFrame(): Source #" << sourceNo << " does not contain a usable frame";
         }
-
-        // If the field numbers are valid - get the rest of the required data
-        if (firstFieldNumber[sourceNo] != -1 && secondFieldNumber[sourceNo] != -1) {
-            // Fetch the input data (get the fields in TBC sequence order to save seeking)
-            if (firstFieldNumber[sourceNo] < secondFieldNumber[sourceNo]) {
-                firstFieldVideoData[sourceNo] = sourceVideos[sourceNo]->getVideoField(firstFieldNumber[sourceNo]);
-                secondFieldVideoData[sourceNo] = sourceVideos[sourceNo]->getVideoField(secondFieldNumber[sourceNo]);
-            } else {
-                secondFieldVideoData[sourceNo] = sourceVideos[sourceNo]->getVideoField(secondFieldNumber[sourceNo]);
-                firstFieldVideoData[sourceNo] = sourceVideos[sourceNo]->getVideoField(firstFieldNumber[sourceNo]);
-            }
-
-            firstFieldMetadata[sourceNo] = ldDecodeMetaData[sourceNo]->getField(firstFieldNumber[sourceNo]);
-            secondFieldMetadata[sourceNo] = ldDecodeMetaData[sourceNo]->getField(secondFieldNumber[sourceNo]);
-            videoParameters[sourceNo] = ldDecodeMetaData[sourceNo]->getVideoParameters();
-        }
-    }
-
-    // Figure out which of the available sources can be used to correct the current frame
-    availableSourcesForFrame.clear();
-    if (numberOfSources > 1) {
-        availableSourcesForFrame = getAvailableSourcesForFrame(currentVbiFrame);
-    } else {
-        availableSourcesForFrame.append(0);
     }
 
     // Set the other miscellaneous parameters
@@ -236,7 +256,10 @@ bool CorrectorPool::getInputFrame(qint32& frameNumber,
     _intraField = intraField;
     _overCorrect = overCorrect;
 
-    return true;
+    // Wait for the source reader to provide the field data. This doesn't need
+    // the input lock, so other threads can carry on meanwhile.
+    locker.unlock();
+    return sourceReader.getFrame(frameIndex, firstFieldVideoData, secondFieldVideoData);
 }
 
 // Put a corrected frame into the output stream.
@@ -246,6 +269,9 @@ bool CorrectorPool::getInputFrame(qint32& frameNumber,
 // frames that haven't yet been written; when a new frame comes in, we check
 // whether we can now write some of them out.
 //
+// In selective mode, the output already contains every field, so the frame's
+// fields are written straight back to their places in the file.
+//
 // Returns true on success, false on failure.
 bool CorrectorPool::setOutputFrame(qint32 frameNumber,
                                    SourceVideo::Data firstTargetFieldData, SourceVideo::Data secondTargetFieldData,
@@ -253,7 +279,9 @@ bool CorrectorPool::setOutputFrame(qint32 frameNumber,
                                    qint32 sameSourceConcealment, qint32 multiSourceConcealment,
                                    qint32 multiSourceCorrection, qint32 totalReplacementDistance)
 {
+    StageTimer timer("output");
     QMutexLocker locker(&outputMutex);
+    StageStats::count("frames");
 
     // Put the output frame into the map
     OutputFrame pendingFrame;
@@ -268,6 +296,25 @@ bool CorrectorPool::setOutputFrame(qint32 frameNumber,
     pendingFrame.multiSourceCorrection = multiSourceCorrection;
     pendingFrame.totalReplacementDistance = totalReplacementDistance;
 
+    if (selective) {
+        if (!rewriteOutputField(firstFieldSeqNo, firstTargetFieldData)
+            || !rewriteOutputField(secondFieldSeqNo, secondTargetFieldData)) {
+            // Could not write to target TBC file
+            qCritical() << "Writing fields to the output TBC file failed";
+            targetVideo.close();
+            return false;
+        }
+
+        reportOutputFrame(frameNumber, pendingFrame);
+
+        selectiveFrameCount++;
+        if (selectiveFrameCount % 100 == 0) {
+            qInfo() << "Processed and written" << selectiveFrameCount << "of" << inputFrameList.size() << "frames";
+        }
+
+        return true;
+    }
+
     pendingOutputFrames[frameNumber] = pendingFrame;
 
     // Write out as many frames as possible
@@ -294,27 +341,7 @@ bool CorrectorPool::setOutputFrame(qint32 frameNumber,
             return false;
         }
 
-        // Show debug
-        qreal avgReplacementDistance = 0;
-        if (outputFrame.sameSourceConcealment + outputFrame.multiSourceConcealment +  outputFrame.multiSourceCorrection > 0) {
-            avgReplacementDistance = static_cast<qreal>(outputFrame.totalReplacementDistance) /
-                            static_cast<qreal>(outputFrame.sameSourceConcealment + outputFrame.multiSourceConcealment +
-                                               outputFrame.multiSourceCorrection);
-            qDebug().nospace() << "Processed frame " << outputFrameNumber << " with " << outputFrame.sameSourceConcealment +
-                        outputFrame.multiSourceConcealment +
-                        outputFrame.multiSourceCorrection << " changes ("  <<
-                        outputFrame.sameSourceConcealment << ", " <<
-                        outputFrame.multiSourceConcealment << ", " <<
-                        outputFrame.multiSourceCorrection << " - avg dist. " <<
-                        avgReplacementDistance << ")";
-        } else {
-            qDebug() << "Processed frame" << outputFrameNumber << "- no dropouts";
-        }
-
-        // Tally the statistics
-        multiSourceConcealmentTotal += outputFrame.multiSourceConcealment;
-        multiSourceCorrectionTotal += outputFrame.multiSourceCorrection;
-        sameSourceConcealmentTotal += outputFrame.sameSourceConcealment;
+        reportOutputFrame(outputFrameNumber, outputFrame);
 
         if (outputFrameNumber % 100 == 0) {
             qInfo() << "Processed and written frame" << outputFrameNumber;
@@ -327,130 +354,172 @@ bool CorrectorPool::setOutputFrame(qint32 frameNumber,
     return true;
 }
 
-// Determine the minimum and maximum VBI frame numbers for all sources
+// Show debug information for a processed frame, and add it to the statistics
+void CorrectorPool::reportOutputFrame(qint32 frameNumber, const OutputFrame &outputFrame)
+{
+    // Show debug
+    qreal avgReplacementDistance = 0;
+    if (outputFrame.sameSourceConcealment + outputFrame.multiSourceConcealment +  outputFrame.multiSourceCorrection > 0) {
+        avgReplacementDistance = static_cast<qreal>(outputFrame.totalReplacementDistance) /
+                        static_cast<qreal>(outputFrame.sameSourceConcealment + outputFrame.multiSourceConcealment +
+                                           outputFrame.multiSourceCorrection);
+        qDebug().nospace() << "Processed frame " << frameNumber << " with " << outputFrame.sameSourceConcealment +
+                    outputFrame.multiSourceConcealment +
+                    outputFrame.multiSourceCorrection << " changes ("  <<
+                    outputFrame.sameSourceConcealment << ", " <<
+                    outputFrame.multiSourceConcealment << ", " <<
+                    outputFrame.multiSourceCorrection << " - avg dist. " <<
+                    avgReplacementDistance << ")";
+    } else {
+        qDebug() << "Processed frame" << frameNumber << "- no dropouts";
+    }
+
+    // Tally the statistics
+    multiSourceConcealmentTotal += outputFrame.multiSourceConcealment;
+    multiSourceCorrectionTotal += outputFrame.multiSourceCorrection;
+    sameSourceConcealmentTotal += outputFrame.sameSourceConcealment;
+}
+
+// Build the VBI frame maps for all sources
 // Expects sourceVideos[] and ldDecodeMetaData[] to be populated
-// Note: This function returns frame number even if the disc is CLV - conversion
-// from timecodes is performed automatically.
-bool CorrectorPool::setMinAndMaxVbiFrames()
+// Note: CLV time-codes are converted to frame numbers automatically.
+bool CorrectorPool::buildSourceFrameMaps()
 {
     // Determine the number of sources available
     qint32 numberOfSources = sourceVideos.size();
-
-    // Resize vectors
-    sourceDiscTypeCav.resize(numberOfSources);
-    sourceMaximumVbiFrame.resize(numberOfSources);
-    sourceMinimumVbiFrame.resize(numberOfSources);
+    sourceFrameMaps.resize(numberOfSources);
 
     for (qint32 sourceNumber = 0; sourceNumber < numberOfSources; sourceNumber++) {
         // Determine the disc type and max/min VBI frame numbers
-        VbiDecoder vbiDecoder;
-        qint32 cavCount = 0;
-        qint32 clvCount = 0;
-        qint32 cavMin = 1000000;
-        qint32 cavMax = 0;
-        qint32 clvMin = 1000000;
-        qint32 clvMax = 0;
-
-        sourceMinimumVbiFrame[sourceNumber] = 0;
-        sourceMaximumVbiFrame[sourceNumber] = 0;
-        sourceDiscTypeCav[sourceNumber] = false;
-
-        // Using sequential frame numbering starting from 1
-        for (qint32 seqFrame = 1; seqFrame <= ldDecodeMetaData[sourceNumber]->getNumberOfFrames(); seqFrame++) {
-            // Get the VBI data and then decode
-            QVector<qint32> vbi1 = ldDecodeMetaData[sourceNumber]->getFieldVbi(ldDecodeMetaData[sourceNumber]->getFirstFieldNumber(seqFrame)).vbiData;
-            QVector<qint32> vbi2 = ldDecodeMetaData[sourceNumber]->getFieldVbi(ldDecodeMetaData[sourceNumber]->getSecondFieldNumber(seqFrame)).vbiData;
-            VbiDecoder::Vbi vbi = vbiDecoder.decodeFrame(vbi1[0], vbi1[1], vbi1[2], vbi2[0], vbi2[1], vbi2[2]);
-
-            // Look for a complete, valid CAV picture number or CLV time-code
-            if (vbi.picNo > 0) {
-                cavCount++;
-
-                if (vbi.picNo < cavMin) cavMin = vbi.picNo;
-                if (vbi.picNo > cavMax) cavMax = vbi.picNo;
-            }
-
-            if (vbi.clvHr != -1 && vbi.clvMin != -1 &&
-                    vbi.clvSec != -1 && vbi.clvPicNo != -1) {
-                clvCount++;
-
-                LdDecodeMetaData::ClvTimecode timecode;
-                timecode.hours = vbi.clvHr;
-                timecode.minutes = vbi.clvMin;
-                timecode.seconds = vbi.clvSec;
-                timecode.pictureNumber = vbi.clvPicNo;
-                qint32 cvFrameNumber = ldDecodeMetaData[sourceNumber]->convertClvTimecodeToFrameNumber(timecode);
-
-                if (cvFrameNumber < clvMin) clvMin = cvFrameNumber;
-                if (cvFrameNumber > clvMax) clvMax = cvFrameNumber;
-            }
-        }
-        qDebug() << "CorrectorPool::setMinAndMaxVbiFrames(): Got" << cavCount << "CAV picture codes and" << clvCount << "CLV timecodes";
-
-        // If the metadata has no picture numbers or time-codes, we cannot use the source
-        if (cavCount == 0 && clvCount == 0) {
-            qDebug() << "CorrectorPool::setMinAndMaxVbiFrames(): Source does not seem to contain valid CAV picture numbers or CLV time-codes - cannot process";
+        if (!sourceFrameMaps[sourceNumber].build(*ldDecodeMetaData[sourceNumber])) {
+            qDebug() << "CorrectorPool::buildSourceFrameMaps(): Source does not seem to contain valid CAV picture numbers or CLV time-codes - cannot process";
             return false;
         }
 
-        // Determine disc type
-        if (cavCount > clvCount) {
-            sourceDiscTypeCav[sourceNumber] = true;
-            qDebug() << "CorrectorPool::setMinAndMaxVbiFrames(): Got" << cavCount << "valid CAV picture numbers - source disc type is CAV";
+        if (sourceFrameMaps[sourceNumber].isDiscCav()) {
             qInfo().nospace() << "Source #" << sourceNumber << " has a disc type of CAV (uses VBI frame numbers)";
-
-            sourceMaximumVbiFrame[sourceNumber] = cavMax;
-            sourceMinimumVbiFrame[sourceNumber] = cavMin;
         } else {
-            sourceDiscTypeCav[sourceNumber] = false;
-            qDebug() << "CorrectorPool::setMinAndMaxVbiFrames(): Got" << clvCount << "valid CLV picture numbers - source disc type is CLV";
             qInfo().nospace() << "Source #" << sourceNumber << " has a disc type of CLV (uses VBI time codes)";
-
-            sourceMaximumVbiFrame[sourceNumber] = clvMax;
-            sourceMinimumVbiFrame[sourceNumber] = clvMin;
         }
 
-        qInfo().nospace() << "Source #" << sourceNumber << " has a VBI frame number range of " << sourceMinimumVbiFrame[sourceNumber] << " to " <<
-            sourceMaximumVbiFrame[sourceNumber];
+        qInfo().nospace() << "Source #" << sourceNumber << " has a VBI frame number range of " << sourceFrameMaps[sourceNumber].getMinimumVbiFrame() << " to " <<
+            sourceFrameMaps[sourceNumber].getMaximumVbiFrame();
     }
 
     return true;
 }
 
-// Method to convert the first source sequential frame number to a VBI frame number
-qint32 CorrectorPool::convertSequentialFrameNumberToVbi(qint32 sequentialFrameNumber, qint32 sourceNumber)
-{
-    return (sourceMinimumVbiFrame[sourceNumber] - 1) + sequentialFrameNumber;
-}
-
-// Method to convert a VBI frame number to a sequential frame number
-qint32 CorrectorPool::convertVbiFrameNumberToSequential(qint32 vbiFrameNumber, qint32 sourceNumber)
-{
-    // Offset the VBI frame number to get the sequential source frame number
-    return vbiFrameNumber - sourceMinimumVbiFrame[sourceNumber] + 1;
-}
-
 // Method that returns a vector of the sources that contain data for the required VBI frame number
 QVector<qint32> CorrectorPool::getAvailableSourcesForFrame(qint32 vbiFrameNumber)
 {
     QVector<qint32> availableSourcesForFrame;
     for (qint32 sourceNo = 0; sourceNo < sourceVideos.size(); sourceNo++) {
-        if (vbiFrameNumber >= sourceMinimumVbiFrame[sourceNo] && vbiFrameNumber <= sourceMaximumVbiFrame[sourceNo]) {
-            // Get the field numbers for the frame
-            qint32 firstFieldNumber = ldDecodeMetaData[sourceNo]->getFirstFieldNumber(convertVbiFrameNumberToSequential(vbiFrameNumber, sourceNo));
-            qint32 secondFieldNumber = ldDecodeMetaData[sourceNo]->getSecondFieldNumber(convertVbiFrameNumberToSequential(vbiFrameNumber, sourceNo));
-
-            // Ensure the frame is not a padded field (i.e. missing)
-            if (!(ldDecodeMetaData[sourceNo]->getField(firstFieldNumber).pad &&
-                  ldDecodeMetaData[sourceNo]->getField(secondFieldNumber).pad)) {
-                availableSourcesForFrame.append(sourceNo);
-            }
+        if (sourceFrameMaps[sourceNo].containsVbiFrame(vbiFrameNumber)) {
+            availableSourcesForFrame.append(sourceNo);
         }
     }
 
     return availableSourcesForFrame;
 }
 
+// Method to determine which fields to use from each source for a sequential frame number
+MultiSourceReader::FrameFields CorrectorPool::getFrameFields(qint32 frameNumber)
+{
+    qint32 numberOfSources = sourceVideos.size();
+
+    MultiSourceReader::FrameFields frameFields;
+    frameFields.firstFieldNumber.fill(-1, numberOfSources);
+    frameFields.secondFieldNumber.fill(-1, numberOfSources);
+
+    // Get the current VBI frame number based on the first source
+    qint32 currentVbiFrame = -1;
+    if (numberOfSources > 1) currentVbiFrame = sourceFrameMaps[0].convertSequentialFrameNumberToVbi(frameNumber);
+    for (qint32 sourceNo = 0; sourceNo < numberOfSources; sourceNo++) {
+        if (sourceNo == 0) {
+            // No need to perform VBI frame number mapping on the first source
+            frameFields.firstFieldNumber[sourceNo] = ldDecodeMetaData[sourceNo]->getFirstFieldNumber(frameNumber);
+            frameFields.secondFieldNumber[sourceNo] = ldDecodeMetaData[sourceNo]->getSecondFieldNumber(frameNumber);
+        } else {
+            // Use VBI frame number mapping to get the same frame from the
+            // current additional source (if it has it)
+            const VbiFrameMap::Frame &frame = sourceFrameMaps[sourceNo].getVbiFrame(currentVbiFrame);
+            frameFields.firstFieldNumber[sourceNo] = frame.firstFieldNumber;
+            frameFields.secondFieldNumber[sourceNo] = frame.secondFieldNumber;
+        }
+    }
+
+    return frameFields;
+}
+
+// Method to determine whether a sequential frame number has drop outs in the first source
+bool CorrectorPool::frameHasDropOuts(qint32 frameNumber)
+{
+    qint32 firstFieldNumber = ldDecodeMetaData[0]->getFirstFieldNumber(frameNumber);
+    qint32 secondFieldNumber = ldDecodeMetaData[0]->getSecondFieldNumber(frameNumber);
+    if (firstFieldNumber == -1 || secondFieldNumber == -1) return false;
+
+    return !ldDecodeMetaData[0]->getField(firstFieldNumber).dropOuts.empty()
+           || !ldDecodeMetaData[0]->getField(secondFieldNumber).dropOuts.empty();
+}
+
+// Method to determine the quality of each source's copy of a sequential frame
+// number, and rank the sources that can be used to correct it
+CorrectorPool::FrameSources CorrectorPool::getFrameSources(qint32 frameNumber, const MultiSourceReader::FrameFields &frameFields)
+{
+    qint32 numberOfSources = sourceVideos.size();
+
+    FrameSources frameSources;
+    frameSources.quality.fill(-1, numberOfSources);
+
+    for (qint32 sourceNo = 0; sourceNo < numberOfSources; sourceNo++) {
+        if (frameFields.firstFieldNumber[sourceNo] == -1 || frameFields.secondFieldNumber[sourceNo] == -1) continue;
+
+        frameSources.quality[sourceNo] = getFrameQuality(ldDecodeMetaData[sourceNo]->getField(frameFields.firstFieldNumber[sourceNo]),
+                                                         ldDecodeMetaData[sourceNo]->getField(frameFields.secondFieldNumber[sourceNo]),
+                                                         ldDecodeMetaData[sourceNo]->getVideoParameters().fieldWidth);
+    }
+
+    // Figure out which of the available sources can be used to correct the frame
+    if (numberOfSources > 1) {
+        qint32 currentVbiFrame = sourceFrameMaps[0].convertSequentialFrameNumberToVbi(frameNumber);
+        frameSources.rankedSources = getAvailableSourcesForFrame(currentVbiFrame);
+    } else {
+        frameSources.rankedSources.append(0);
+    }
+
+    // Put the best sources first. The sort is stable, so sources of equal
+    // quality stay in source order.
+    std::stable_sort(frameSources.rankedSources.begin(), frameSources.rankedSources.end(),
+                     [&](qint32 a, qint32 b) { return frameSources.quality[a] > frameSources.quality[b]; });
+
+    return frameSources;
+}
+
+// Method to score the quality of a source's copy of a frame. This is based on
+// the frame average black SNR, reduced if the sync pulses were hard to detect
+// or the frame has a lot of drop outs.
+qreal CorrectorPool::getFrameQuality(const LdDecodeMetaData::Field &firstField, const LdDecodeMetaData::Field &secondField,
+                                     qint32 fieldWidth)
+{
+    qreal quality = (firstField.vitsMetrics.bPSNR + secondField.vitsMetrics.bPSNR) / 2.0;
+
+    // Scale by the sync confidence (a percentage; older metadata doesn't include it)
+    qint32 syncConf = qMin(firstField.syncConf, secondField.syncConf);
+    if (syncConf > 0) quality = quality * syncConf / 100.0;
+
+    // Subtract 1dB for each line's worth of drop outs
+    qint64 dropOutLength = 0;
+    for (qint32 i = 0; i < firstField.dropOuts.size(); i++) {
+        dropOutLength += firstField.dropOuts.endx(i) - firstField.dropOuts.startx(i);
+    }
+    for (qint32 i = 0; i < secondField.dropOuts.size(); i++) {
+        dropOutLength += secondField.dropOuts.endx(i) - secondField.dropOuts.startx(i);
+    }
+    if (fieldWidth > 0) quality -= static_cast<qreal>(dropOutLength) / fieldWidth;
+
+    return quality;
+}
+
 // Write a field to the output file.
 // Returns true on success, false on failure.
 bool CorrectorPool::writeOutputField(const SourceVideo::Data &fieldData)
@@ -458,6 +527,54 @@ bool CorrectorPool::writeOutputField(const SourceVideo::Data &fieldData)
     return targetVideo.write(reinterpret_cast<const char *>(fieldData.data()), 2 * fieldData.size());
 }
 
+// Write a field back to its place in the output file (for selective mode).
+// Returns true on success, false on failure.
+bool CorrectorPool::rewriteOutputField(qint32 fieldNumber, const SourceVideo::Data &fieldData)
+{
+    const qint64 fieldByteLength = 2 * static_cast<qint64>(fieldData.size());
+    if (!targetVideo.seek(fieldByteLength * (fieldNumber - 1))) return false;
+
+    return targetVideo.write(reinterpret_cast<const char *>(fieldData.data()), fieldByteLength) == fieldByteLength;
+}
+
+// Copy the input TBC file to the output TBC file (for selective mode),
+// replacing the output file if it already exists.
+// Where the OS supports it, the copy is done within the kernel (which lets
+// filesystems such as btrfs and XFS share the data rather than copying it).
+// Returns true on success, false on failure.
+bool CorrectorPool::copyInputVideo()
+{
+    QFile inputFile(inputFilename);
+    QFile outputFile(outputFilename);
+    if (!inputFile.open(QIODevice::ReadOnly | QIODevice::Unbuffered)) return false;
+    if (!outputFile.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Unbuffered)) return false;
+
+#ifdef Q_OS_LINUX
+    qint64 remaining = inputFile.size();
+    while (remaining > 0) {
+        ssize_t copied = copy_file_range(inputFile.handle(), nullptr, outputFile.handle(), nullptr,
+                                         static_cast<size_t>(remaining), 0);
+        if (copied <= 0) break;
+        remaining -= copied;
+    }
+    if (remaining == 0) return true;
+
+    // The kernel couldn't do it (e.g. an older kernel, or copying between
+    // filesystems) -- start again and copy normally
+    qDebug() << "CorrectorPool::copyInputVideo(): copy_file_range failed, copying normally";
+    if (!inputFile.seek(0) || !outputFile.resize(0) || !outputFile.seek(0)) return false;
+#endif
+
+    // Copy the file a block at a time
+    const qint64 blockSize = 16 * 1024 * 1024;
+    while (!inputFile.atEnd()) {
+        const QByteArray block = inputFile.read(blockSize);
+        if (block.isEmpty() || outputFile.write(block) != block.size()) return false;
+    }
+
+    return true;
+}
+
 // Getters for reporting
 qint32 CorrectorPool::getSameSourceConcealmentTotal()
 {
@@ -34,15 +34,17 @@
 
 #include "sourcevideo.h"
 #include "lddecodemetadata.h"
+#include "multisourcereader.h"
+#include "vbiframemap.h"
 #include "dropoutcorrect.h"
 
 class CorrectorPool : public QObject
 {
     Q_OBJECT
 public:
-    explicit CorrectorPool(QString _outputFilename, QString _outputJsonFilename,
-                           qint32 _maxThreads, QVector<LdDecodeMetaData *> &_ldDecodeMetaData, QVector<SourceVideo *> &_sourceVideos,
-                           bool _reverse, bool _intraField, bool _overCorrect, QObject *parent = nullptr);
+    explicit CorrectorPool(QString _inputFilename, QString _outputFilename, QString _outputJsonFilename,
+                           qint32 _startFrame, qint32 _length, qint32 _maxThreads, QVector<LdDecodeMetaData *> &_ldDecodeMetaData, QVector<SourceVideo *> &_sourceVideos,
+                           bool _reverse, bool _intraField, bool _overCorrect, bool _selective, QObject *parent = nullptr);
 
     bool process();
 
@@ -64,12 +66,16 @@ public:
     qint32 getMultiSourceCorrectionTotal();
 
 private:
+    QString inputFilename;
     QString outputFilename;
     QString outputJsonFilename;
+    qint32 startFrame;
+    qint32 length;
     qint32 maxThreads;
     bool reverse;
     bool intraField;
     bool overCorrect;
+    bool selective;
     QElapsedTimer totalTimer;
 
     // Atomic abort flag shared by worker threads; workers watch this, and shut
@@ -78,10 +84,22 @@ private:
 
     // Input stream information (all guarded by inputMutex while threads are running)
     QMutex inputMutex;
-    qint32 inputFrameNumber;
+    qint32 inputFrameIndex;
     qint32 lastFrameNumber;
     QVector<LdDecodeMetaData *> &ldDecodeMetaData;
     QVector<SourceVideo *> &sourceVideos;
+    QVector<qint32> inputFrameList;
+    QVector<MultiSourceReader::FrameFields> inputFrameFields;
+    MultiSourceReader sourceReader;
+
+    // The quality of each source's copy of a frame, and the sources that can
+    // be used to correct it in order of quality. These are worked out for
+    // every frame before processing starts.
+    struct FrameSources {
+        QVector<qreal> quality;             // One entry per source (-1 if the source doesn't have the frame)
+        QVector<qint32> rankedSources;      // Best quality first
+    };
+    QVector<FrameSources> inputFrameSources;
 
     // Output stream information (all guarded by outputMutex while threads are running)
     QMutex outputMutex;
@@ -103,21 +121,28 @@ private:
     QMap<qint32, OutputFrame> pendingOutputFrames;
     QFile targetVideo;
 
+    // Number of frames rewritten in selective mode
+    qint32 selectiveFrameCount;
+
     // Local source information
-    QVector<bool> sourceDiscTypeCav;
-    QVector<qint32> sourceMinimumVbiFrame;
-    QVector<qint32> sourceMaximumVbiFrame;
+    QVector<VbiFrameMap> sourceFrameMaps;
 
     // Reporting information
     qint32 sameSourceConcealmentTotal;
     qint32 multiSourceConcealmentTotal;
     qint32 multiSourceCorrectionTotal;
 
-    bool setMinAndMaxVbiFrames();
-    qint32 convertSequentialFrameNumberToVbi(qint32 sequentialFrameNumber, qint32 sourceNumber);
-    qint32 convertVbiFrameNumberToSequential(qint32 vbiFrameNumber, qint32 sourceNumber);
+    bool buildSourceFrameMaps();
     QVector<qint32> getAvailableSourcesForFrame(qint32 vbiFrameNumber);
+    MultiSourceReader::FrameFields getFrameFields(qint32 frameNumber);
+    bool frameHasDropOuts(qint32 frameNumber);
+    FrameSources getFrameSources(qint32 frameNumber, const MultiSourceReader::FrameFields &frameFields);
+    qreal getFrameQuality(const LdDecodeMetaData::Field &firstField, const LdDecodeMetaData::Field &secondField,
+                          qint32 fieldWidth);
+    void reportOutputFrame(qint32 frameNumber, const OutputFrame &outputFrame);
     bool writeOutputField(const SourceVideo::Data &fieldData);
+    bool rewriteOutputField(qint32 fieldNumber, const SourceVideo::Data &fieldData);
+    bool copyInputVideo();
 };
 
 #endif // CORRECTORPOOL_H
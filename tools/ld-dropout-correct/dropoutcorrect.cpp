@@ -26,6 +26,9 @@
 #include "dropoutcorrect.h"
 #include "correctorpool.h"
 #include "filters.h"
+#include "stagestats.h"
+
+#include <QtConcurrent/QtConcurrent>
 
 DropOutCorrect::DropOutCorrect(QAtomicInt& _abort, CorrectorPool& _correctorPool, QObject *parent)
     : QThread(parent), abort(_abort), correctorPool(_correctorPool)
@@ -59,6 +62,8 @@ void DropOutCorrect::run()
             break;
         }
 
+        StageTimer correctTimer("correct");
+
         // Reset statistics
         statistics.sameSourceConcealment = 0;
         statistics.multiSourceConcealment = 0;
@@ -103,54 +108,91 @@ void DropOutCorrect::run()
                     secondFieldDropouts[currentSource] = setDropOutLocations(populateDropoutsVector(secondFieldMetadata[currentSource], overCorrect));
             }
 
+            // Index the drop outs in each field by line, so searching for
+            // replacement lines only needs to examine one line's drop outs
+            QVector<DropOuts> firstFieldLineIndex(totalAvailableSources);
+            QVector<DropOuts> secondFieldLineIndex(totalAvailableSources);
+            for (qint32 i = 0; i < availableSourcesForFrame.size(); i++) {
+                qint32 currentSource = availableSourcesForFrame[i];
+                firstFieldLineIndex[currentSource] = buildLineIndex(firstFieldDropouts[currentSource]);
+                secondFieldLineIndex[currentSource] = buildLineIndex(secondFieldDropouts[currentSource]);
+            }
+
+            // Find the replacements for both fields. This only depends on the
+            // drop out locations (not the field data), so the second field's
+            // search can run in parallel with the first's.
+            QFuture<QVector<DropOutReplacement>> secondFieldFuture = QtConcurrent::run([&]() {
+                return findFieldReplacements(secondFieldDropouts, secondFieldLineIndex, firstFieldLineIndex,
+                                             false, intraField, availableSourcesForFrame, sourceFrameQuality);
+            });
+            QVector<DropOutReplacement> firstFieldReplacements =
+                    findFieldReplacements(firstFieldDropouts, firstFieldLineIndex, secondFieldLineIndex,
+                                          true, intraField, availableSourcesForFrame, sourceFrameQuality);
+            QVector<DropOutReplacement> secondFieldReplacements = secondFieldFuture.result();
+
             // Correct the first field
-            correctField(firstFieldDropouts, secondFieldDropouts, firstFieldData, secondFieldData, true, intraField, availableSourcesForFrame, sourceFrameQuality,
-                         statistics);
+            correctField(firstFieldDropouts, firstFieldReplacements, firstFieldData, secondFieldData, statistics);
 
             // Correct the second field
-            correctField(secondFieldDropouts, firstFieldDropouts, secondFieldData, firstFieldData, false, intraField, availableSourcesForFrame, sourceFrameQuality,
-                         statistics);
+            correctField(secondFieldDropouts, secondFieldReplacements, secondFieldData, firstFieldData, statistics);
         }
 
+        correctTimer.stop();
+
         // Return the processed fields
         correctorPool.setOutputFrame(frameNumber, firstFieldData[0], secondFieldData[0], firstFieldSeqNo[0], secondFieldSeqNo[0],
                 statistics.sameSourceConcealment, statistics.multiSourceConcealment, statistics.multiSourceCorrection ,statistics.totalReplacementDistance);
     }
 }
 
-// Correct dropouts within one field
-void DropOutCorrect::correctField(const QVector<QVector<DropOutLocation>> &thisFieldDropouts,
-                                  const QVector<QVector<DropOutLocation>> &otherFieldDropouts,
-                                  QVector<SourceVideo::Data> &thisFieldData, const QVector<SourceVideo::Data> &otherFieldData,
-                                  bool thisFieldIsFirst, bool intraField, const QVector<qint32> &availableSourcesForFrame,
-                                  const QVector<qreal> &sourceFrameQuality, Statistics &statistics)
+// Find the replacements for the dropouts within one field
+QVector<DropOutCorrect::DropOutReplacement> DropOutCorrect::findFieldReplacements(const QVector<QVector<DropOutLocation>> &thisFieldDropouts,
+                                                                                  const QVector<DropOuts> &thisFieldLineIndex,
+                                                                                  const QVector<DropOuts> &otherFieldLineIndex,
+                                                                                  bool thisFieldIsFirst, bool intraField,
+                                                                                  const QVector<qint32> &availableSourcesForFrame,
+                                                                                  const QVector<qreal> &sourceFrameQuality)
 {
+    QVector<DropOutReplacement> replacements(thisFieldDropouts[0].size());
+
     for (qint32 dropoutIndex = 0; dropoutIndex < thisFieldDropouts[0].size(); dropoutIndex++) {
-        Replacement replacement, chromaReplacement;
+        DropOutReplacement &dropOutReplacement = replacements[dropoutIndex];
 
         // Is the current dropout in the colour burst?
         if (thisFieldDropouts[0][dropoutIndex].location == Location::colourBurst) {
-            replacement = findReplacementLine(thisFieldDropouts, otherFieldDropouts,
-                                              dropoutIndex, thisFieldIsFirst, true,
-                                              true, intraField, availableSourcesForFrame,
-                                              sourceFrameQuality);
+            dropOutReplacement.replacement = findReplacementLine(thisFieldDropouts, thisFieldLineIndex, otherFieldLineIndex,
+                                                                 dropoutIndex, thisFieldIsFirst, true,
+                                                                 true, intraField, availableSourcesForFrame,
+                                                                 sourceFrameQuality);
         }
 
         // Is the current dropout in the visible video line?
         if (thisFieldDropouts[0][dropoutIndex].location == Location::visibleLine) {
             // Find separate replacements for luma and chroma
-            replacement = findReplacementLine(thisFieldDropouts, otherFieldDropouts,
-                                              dropoutIndex, thisFieldIsFirst, false,
-                                              false, intraField, availableSourcesForFrame,
-                                              sourceFrameQuality);
-            chromaReplacement = findReplacementLine(thisFieldDropouts, otherFieldDropouts,
-                                                    dropoutIndex, thisFieldIsFirst, true,
-                                                    false, intraField, availableSourcesForFrame,
-                                                    sourceFrameQuality);
+            dropOutReplacement.replacement = findReplacementLine(thisFieldDropouts, thisFieldLineIndex, otherFieldLineIndex,
+                                                                 dropoutIndex, thisFieldIsFirst, false,
+                                                                 false, intraField, availableSourcesForFrame,
+                                                                 sourceFrameQuality);
+            dropOutReplacement.chromaReplacement = findReplacementLine(thisFieldDropouts, thisFieldLineIndex, otherFieldLineIndex,
+                                                                       dropoutIndex, thisFieldIsFirst, true,
+                                                                       false, intraField, availableSourcesForFrame,
+                                                                       sourceFrameQuality);
         }
+    }
 
+    return replacements;
+}
+
+// Correct dropouts within one field
+void DropOutCorrect::correctField(const QVector<QVector<DropOutLocation>> &thisFieldDropouts,
+                                  const QVector<DropOutReplacement> &replacements,
+                                  QVector<SourceVideo::Data> &thisFieldData, const QVector<SourceVideo::Data> &otherFieldData,
+                                  Statistics &statistics)
+{
+    for (qint32 dropoutIndex = 0; dropoutIndex < thisFieldDropouts[0].size(); dropoutIndex++) {
         // Correct the data
-        correctDropOut(thisFieldDropouts[0][dropoutIndex], replacement, chromaReplacement, thisFieldData, otherFieldData, statistics);
+        correctDropOut(thisFieldDropouts[0][dropoutIndex], replacements[dropoutIndex].replacement,
+                       replacements[dropoutIndex].chromaReplacement, thisFieldData, otherFieldData, statistics);
     }
 }
 
@@ -249,11 +291,24 @@ QVector<DropOutCorrect::DropOutLocation> DropOutCorrect::setDropOutLocations(QVe
     return dropOuts;
 }
 
+// Build a line index for a field's drop out locations, for use by findPotentialReplacementLine
+DropOuts DropOutCorrect::buildLineIndex(const QVector<DropOutLocation> &dropOuts)
+{
+    DropOuts lineIndex;
+    for (const DropOutLocation &dropOut: dropOuts) {
+        lineIndex.append(dropOut.startx, dropOut.endx, dropOut.fieldLine);
+    }
+    lineIndex.sort();
+
+    return lineIndex;
+}
+
 // Find a replacement line to take replacement data from.  This method looks both up and down the field
 // for the nearest replacement line that doesn't contain a drop-out itself (to prevent copying bad data
 // over bad data).
 DropOutCorrect::Replacement DropOutCorrect::findReplacementLine(const QVector<QVector<DropOutLocation>> &thisFieldDropouts,
-                                                                const QVector<QVector<DropOutLocation>> &otherFieldDropouts,
+                                                                const QVector<DropOuts> &thisFieldLineIndex,
+                                                                const QVector<DropOuts> &otherFieldLineIndex,
                                                                 qint32 dropOutIndex, bool thisFieldIsFirst, bool matchChromaPhase,
                                                                 bool isColourBurst, bool intraField,
                                                                 const QVector<qint32> &availableSourcesForFrame,
@@ -310,67 +365,47 @@ DropOutCorrect::Replacement DropOutCorrect::findReplacementLine(const QVector<QV
         otherFieldOffset = -1;
     }
 
-    // Look for potential replacement lines
-    QVector<DropOutCorrect::Replacement> candidates;
-
-    for (qint32 i = 0; i < availableSourcesForFrame.size(); i++) {
-        qint32 currentSource = availableSourcesForFrame[i];
-
-        // Examine this field:
-
-        // Look up the field for a replacement
-        findPotentialReplacementLine(thisFieldDropouts, dropOutIndex,
-                                     thisFieldDropouts, true, 0, -stepAmount,
-                                     currentSource, sourceFrameQuality,
-                                     candidates);
-
-        // Look down the field for a replacement
-        findPotentialReplacementLine(thisFieldDropouts, dropOutIndex,
-                                     thisFieldDropouts, true, stepAmount, stepAmount,
-                                     currentSource, sourceFrameQuality,
-                                     candidates);
-
-        // Only check the other field for visible line replacements
-        if (!isColourBurst && !intraField) {
-            // Examine the other field:
-
-            // Look up the field for a replacement
-            findPotentialReplacementLine(thisFieldDropouts, dropOutIndex,
-                                         otherFieldDropouts, false, otherFieldOffset, -stepAmount,
-                                         currentSource, sourceFrameQuality,
-                                         candidates);
-
-            // Look down the field for a replacement
-            findPotentialReplacementLine(thisFieldDropouts, dropOutIndex,
-                                         otherFieldDropouts, false, otherFieldOffset + stepAmount, stepAmount,
-                                         currentSource, sourceFrameQuality,
-                                         candidates);
-        }
-    }
-
     qDebug() << (isColourBurst ? "Colourburst" : "Visible video") << "dropout on line"
              << thisFieldDropouts[0][dropOutIndex].fieldLine << "of" << (thisFieldIsFirst ? "first" : "second") << "field";
 
+    // Work out the output frame line number of the dropout, and the distance
+    // to it from a replacement line.
+    // The first field (in a .tbc, for both PAL and NTSC) contains the top frame line.
+    const qint32 dropoutFieldLine = thisFieldDropouts[0][dropOutIndex].fieldLine;
+    const qint32 dropoutFrameLine = (2 * dropoutFieldLine) + (thisFieldIsFirst ? 0 : 1);
+    auto frameLineDistance = [&](qint32 fieldLine, bool isSameField) {
+        const qint32 sourceFrameLine = (2 * fieldLine) + (isSameField ? (thisFieldIsFirst ? 0 : 1)
+                                                                      : (thisFieldIsFirst ? 1 : 0));
+        return qAbs(dropoutFrameLine - sourceFrameLine);
+    };
+
     // If no candidate is found, return no replacement
     Replacement replacement;
 
-    if (!candidates.empty()) {
-        // Find the candidate with the lowest spatial distance from the dropout
-        replacement.distance = 1000000;
+    // Find the candidate with the lowest spatial distance from the dropout,
+    // and then the highest quality
+    replacement.distance = 1000000;
+    replacement.quality = -1;
 
-        // Find the candidate with the highest quality
-        replacement.quality = -1;
+    // Look for potential replacement lines, and choose the best
+    QVector<DropOutCorrect::Replacement> candidates;
+    auto searchForReplacement = [&](const QVector<DropOuts> &sourceLineIndex, bool isSameField,
+                                    qint32 sourceOffset, qint32 searchStep, qint32 sourceNo) {
+        // Each search moves away from the dropout, so its starting line is the
+        // nearest it can find. The sources are searched best quality first,
+        // so a candidate at the same distance as the current choice can't win.
+        if (frameLineDistance(dropoutFieldLine + sourceOffset, isSameField) >= replacement.distance) return;
+
+        candidates.clear();
+        findPotentialReplacementLine(thisFieldDropouts, dropOutIndex,
+                                     sourceLineIndex, isSameField, sourceOffset, searchStep,
+                                     sourceNo, sourceFrameQuality,
+                                     candidates);
 
         for (const Replacement &candidate: candidates) {
-            // Work out the corresponding output frame line numbers.
-            // The first field (in a .tbc, for both PAL and NTSC) contains the top frame line.
-            const qint32 dropoutFrameLine = (2 * thisFieldDropouts[0][dropOutIndex].fieldLine) + (thisFieldIsFirst ? 0 : 1);
-            const qint32 sourceFrameLine = (2 * candidate.fieldLine) + (candidate.isSameField ? (thisFieldIsFirst ? 0 : 1)
-                                                                                              : (thisFieldIsFirst ? 1 : 0));
-
-            const qint32 distance = qAbs(dropoutFrameLine - sourceFrameLine);
+            const qint32 distance = frameLineDistance(candidate.fieldLine, candidate.isSameField);
             qDebug() << (candidate.isSameField ? "This" : "Other") << "field replacement candidate for line" <<
-                        thisFieldDropouts[0][dropOutIndex].fieldLine << "is line" <<
+                        dropoutFieldLine << "is line" <<
                         candidate.fieldLine << "distance" << distance << "of source" << candidate.sourceNumber <<
                         "with a quality of" << candidate.quality;
 
@@ -386,6 +421,33 @@ DropOutCorrect::Replacement DropOutCorrect::findReplacementLine(const QVector<QV
                 replacement.distance = distance;
             }
         }
+    };
+
+    // availableSourcesForFrame is ordered best quality first
+    for (qint32 i = 0; i < availableSourcesForFrame.size(); i++) {
+        qint32 currentSource = availableSourcesForFrame[i];
+
+        // Stop once we've found the same line in another source, as nothing can beat that
+        if (replacement.distance == 0) break;
+
+        // Examine this field:
+
+        // Look up the field for a replacement
+        searchForReplacement(thisFieldLineIndex, true, 0, -stepAmount, currentSource);
+
+        // Look down the field for a replacement
+        searchForReplacement(thisFieldLineIndex, true, stepAmount, stepAmount, currentSource);
+
+        // Only check the other field for visible line replacements
+        if (!isColourBurst && !intraField) {
+            // Examine the other field:
+
+            // Look up the field for a replacement
+            searchForReplacement(otherFieldLineIndex, false, otherFieldOffset, -stepAmount, currentSource);
+
+            // Look down the field for a replacement
+            searchForReplacement(otherFieldLineIndex, false, otherFieldOffset + stepAmount, stepAmount, currentSource);
+        }
     }
 
     if (replacement.fieldLine != -1) {
@@ -404,13 +466,15 @@ DropOutCorrect::Replacement DropOutCorrect::findReplacementLine(const QVector<QV
 // Given a dropout, scan through a source field for the nearest replacement line that doesn't have overlapping dropouts.
 // Adds a Replacement to candidates if one was found.
 void DropOutCorrect::findPotentialReplacementLine(const QVector<QVector<DropOutLocation>> &targetDropouts, qint32 targetIndex,
-                                                  const QVector<QVector<DropOutLocation>> &sourceDropouts, bool isSameField,
+                                                  const QVector<DropOuts> &sourceLineIndex, bool isSameField,
                                                   qint32 sourceOffset, qint32 stepAmount,
                                                   qint32 sourceNo, const QVector<qreal> &sourceFrameQuality,
                                                   QVector<Replacement> &candidates)
-{    
+{
+    const DropOutLocation &targetDropout = targetDropouts[0][targetIndex];
+
     // Calculate the start source line, applying sourceOffset to find a line with the right chroma phase
-    qint32 sourceLine = targetDropouts[0][targetIndex].fieldLine + sourceOffset;
+    qint32 sourceLine = targetDropout.fieldLine + sourceOffset;
 
     // Is the line within the active range?
     if (sourceLine < videoParameters[sourceNo].firstActiveFieldLine || sourceLine >= videoParameters[sourceNo].lastActiveFieldLine) {
@@ -421,32 +485,25 @@ void DropOutCorrect::findPotentialReplacementLine(const QVector<QVector<DropOutL
     // Hunt for a replacement
     while (sourceLine >= videoParameters[sourceNo].firstActiveFieldLine && sourceLine < videoParameters[sourceNo].lastActiveFieldLine) {
         // Is there a dropout that overlaps the one we're trying to replace?
-        bool hasOverlap = false;
-        for (qint32 sourceIndex = 0; sourceIndex < sourceDropouts[sourceNo].size(); sourceIndex++) {
-            if (sourceDropouts[sourceNo][sourceIndex].fieldLine == sourceLine &&
-                (targetDropouts[0][targetIndex].endx - sourceDropouts[sourceNo][sourceIndex].startx) >= 0 &&
-                (sourceDropouts[sourceNo][sourceIndex].endx - targetDropouts[0][targetIndex].startx) >= 0) {
-                // Overlap -- can't use this line
-                sourceLine += stepAmount;
-                hasOverlap = true;
-                break;
-            }
+        if (sourceLineIndex[sourceNo].overlaps(sourceLine, targetDropout.startx, targetDropout.endx)) {
+            // Overlap -- can't use this line
+            sourceLine += stepAmount;
+            continue;
         }
-        if (!hasOverlap) {
-            // No overlaps -- we can use this line
-            Replacement replacement;
-            replacement.isSameField = isSameField;
-            replacement.fieldLine = sourceLine;
 
-            // Set the source
-            replacement.sourceNumber = sourceNo;
+        // No overlaps -- we can use this line
+        Replacement replacement;
+        replacement.isSameField = isSameField;
+        replacement.fieldLine = sourceLine;
 
-            // Set the quality of the replacement
-            replacement.quality = sourceFrameQuality[sourceNo];
+        // Set the source
+        replacement.sourceNumber = sourceNo;
 
-            candidates.push_back(replacement);
-            return;
-        }
+        // Set the quality of the replacement
+        replacement.quality = sourceFrameQuality[sourceNo];
+
+        candidates.push_back(replacement);
+        return;
     }
 }
 
@@ -485,19 +542,16 @@ void DropOutCorrect::correctDropOut(const DropOutLocation &dropOut,
 
         Filters filters;
         QVector<quint16> lineBuf(videoParameters[0].fieldWidth);
-        auto filterLineBuf = [&] {
+        auto filterLine = [&](const quint16 *inputLine) {
             if (videoParameters[0].isSourcePal) {
-                filters.palLumaFirFilter(lineBuf.data(), lineBuf.size());
+                filters.palLumaFirFilter(inputLine, lineBuf.data(), lineBuf.size());
             } else {
-                filters.ntscLumaFirFilter(lineBuf.data(), lineBuf.size());
+                filters.ntscLumaFirFilter(inputLine, lineBuf.data(), lineBuf.size());
             }
         };
 
         // Extract LF from replacement
-        for (qint32 pixel = 0; pixel < videoParameters[0].fieldWidth; pixel++) {
-            lineBuf[pixel] = sourceLine[pixel];
-        }
-        filterLineBuf();
+        filterLine(sourceLine);
         for (qint32 pixel = dropOut.startx; pixel < dropOut.endx; pixel++) {
             targetLine[pixel] = lineBuf[pixel];
         }
@@ -506,10 +560,7 @@ void DropOutCorrect::correctDropOut(const DropOutLocation &dropOut,
         const quint16 *chromaLine = (chromaReplacement.isSameField ? thisFieldData[replacement.sourceNumber].data()
                                                                    : otherFieldData[replacement.sourceNumber].data())
                                     + ((chromaReplacement.fieldLine - 1) * videoParameters[0].fieldWidth);
-        for (qint32 pixel = 0; pixel < videoParameters[0].fieldWidth; pixel++) {
-            lineBuf[pixel] = chromaLine[pixel];
-        }
-        filterLineBuf();
+        filterLine(chromaLine);
         for (qint32 pixel = dropOut.startx; pixel < dropOut.endx; pixel++) {
             targetLine[pixel] += chromaLine[pixel] - lineBuf[pixel];
         }
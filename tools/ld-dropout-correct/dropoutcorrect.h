@@ -73,6 +73,13 @@ private:
         qint32 distance;
     };
 
+    // The replacements chosen for one dropout. chromaReplacement is only used
+    // for dropouts in the visible line.
+    struct DropOutReplacement {
+        Replacement replacement;
+        Replacement chromaReplacement;
+    };
+
     // Statistics
     struct Statistics {
         qint32 sameSourceConcealment;
@@ -87,20 +94,27 @@ private:
 
     QVector<LdDecodeMetaData::VideoParameters> videoParameters;
 
+    QVector<DropOutReplacement> findFieldReplacements(const QVector<QVector<DropOutLocation> > &thisFieldDropouts,
+                                                      const QVector<DropOuts> &thisFieldLineIndex,
+                                                      const QVector<DropOuts> &otherFieldLineIndex,
+                                                      bool thisFieldIsFirst, bool intraField,
+                                                      const QVector<qint32> &availableSourcesForFrame,
+                                                      const QVector<qreal> &sourceFrameQuality);
     void correctField(const QVector<QVector<DropOutLocation> > &thisFieldDropouts,
-                      const QVector<QVector<DropOutLocation> > &otherFieldDropouts,
+                      const QVector<DropOutReplacement> &replacements,
                       QVector<SourceVideo::Data> &thisFieldData, const QVector<SourceVideo::Data> &otherFieldData,
-                      bool thisFieldIsFirst, bool intraField, const QVector<qint32> &availableSourcesForFrame,
-                      const QVector<qreal> &sourceFrameQuality, Statistics &statistics);
+                      Statistics &statistics);
     QVector<DropOutLocation> populateDropoutsVector(LdDecodeMetaData::Field field, bool overCorrect);
     QVector<DropOutLocation> setDropOutLocations(QVector<DropOutLocation> dropOuts);
+    DropOuts buildLineIndex(const QVector<DropOutLocation> &dropOuts);
     Replacement findReplacementLine(const QVector<QVector<DropOutLocation>> &thisFieldDropouts,
-                                    const QVector<QVector<DropOutLocation>> &otherFieldDropouts,
+                                    const QVector<DropOuts> &thisFieldLineIndex,
+                                    const QVector<DropOuts> &otherFieldLineIndex,
                                     qint32 dropOutIndex, bool thisFieldIsFirst, bool matchChromaPhase,
                                     bool isColourBurst, bool intraField, const QVector<qint32> &availableSourcesForFrame,
                                     const QVector<qreal> &sourceFrameQuality);
     void findPotentialReplacementLine(const QVector<QVector<DropOutLocation>> &targetDropouts, qint32 targetIndex,
-                                      const QVector<QVector<DropOutLocation>> &sourceDropouts, bool isSameField,
+                                      const QVector<DropOuts> &sourceLineIndex, bool isSameField,
                                       qint32 sourceOffset, qint32 stepAmount,
                                       qint32 sourceNo, const QVector<qreal> &sourceFrameQuality,
                                       QVector<Replacement> &candidates);
@@ -1,4 +1,5 @@
 QT -= gui
+QT += concurrent
 
 CONFIG += c++11 console
 CONFIG -= app_bundle
@@ -20,9 +21,15 @@ SOURCES += \
     dropoutcorrect.cpp \
     ../library/tbc/filters.cpp \
     ../library/tbc/lddecodemetadata.cpp \
+    ../library/tbc/jsonreader.cpp \
+    ../library/tbc/jsonwriter.cpp \
     ../library/tbc/sourcevideo.cpp \
+    ../library/tbc/multisourcereader.cpp \
     ../library/tbc/vbidecoder.cpp \
+    ../library/tbc/vbiframemap.cpp \
     ../library/tbc/logging.cpp \
+    ../library/tbc/stagestats.cpp \
+    ../library/tbc/vbirange.cpp \
     ../library/tbc/dropouts.cpp
 
 HEADERS += \
@@ -31,9 +38,15 @@ HEADERS += \
     ../library/filter/firfilter.h \
     ../library/tbc/filters.h \
     ../library/tbc/lddecodemetadata.h \
+    ../library/tbc/jsonreader.h \
+    ../library/tbc/jsonwriter.h \
     ../library/tbc/sourcevideo.h \
+    ../library/tbc/multisourcereader.h \
     ../library/tbc/vbidecoder.h \
+    ../library/tbc/vbiframemap.h \
     ../library/tbc/logging.h \
+    ../library/tbc/stagestats.h \
+    ../library/tbc/vbirange.h \
     ../library/tbc/dropouts.h
 
 # Add external includes to the include path
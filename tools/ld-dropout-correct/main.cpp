@@ -30,6 +30,8 @@
 #include <QThread>
 
 #include "logging.h"
+#include "stagestats.h"
+#include "vbirange.h"
 #include "correctorpool.h"
 
 int main(int argc, char *argv[])
@@ -59,6 +61,9 @@ int main(int argc, char *argv[])
     // Add the standard debug options --debug and --quiet
     addStandardDebugOptions(parser);
 
+    // Add the standard statistics options --stats-json and --stats-interval
+    addStandardStatsOptions(parser);
+
     // Option to specify a different JSON input file
     QCommandLineOption inputJsonOption(QStringList() << "input-json",
                                        QCoreApplication::translate("main", "Specify the input JSON file for the first input file (default input.json)"),
@@ -86,6 +91,14 @@ int main(int argc, char *argv[])
                                        QCoreApplication::translate("main", "Force intrafield correction (default interfield)"));
     parser.addOption(setIntrafieldOption);
 
+    // Option to select selective mode (-s)
+    QCommandLineOption setSelectiveOption(QStringList() << "s" << "selective",
+                                       QCoreApplication::translate("main", "Copy the input TBC to the output, then only rewrite fields containing drop-outs"));
+    parser.addOption(setSelectiveOption);
+
+    // Add the standard VBI range options --vbi-start, --vbi-end and --chapter
+    addStandardVbiRangeOptions(parser);
+
     // Option to select the number of threads (-t)
     QCommandLineOption threadsOption(QStringList() << "t" << "threads",
                                         QCoreApplication::translate(
@@ -107,10 +120,14 @@ int main(int argc, char *argv[])
     // Standard logging options
     processStandardDebugOptions(parser);
 
+    // Standard statistics options
+    if (!processStandardStatsOptions(parser)) return -1;
+
     // Get the options from the parser
     bool reverse = parser.isSet(setReverseOption);
     bool intraField = parser.isSet(setIntrafieldOption);
     bool overCorrect = parser.isSet(setOverCorrectOption);
+    bool selective = parser.isSet(setSelectiveOption);
 
     // Get the arguments from the parser
     qint32 maxThreads = QThread::idealThreadCount();
@@ -167,6 +184,13 @@ int main(int argc, char *argv[])
         return -1;
     }
 
+    // Selective mode needs to copy the input file and seek within the output file
+    if (selective && (inputFilenames[0] == "-" || outputFilename == "-")) {
+        // Quit with error
+        qCritical("Selective mode cannot be used with piped input or output");
+        return -1;
+    }
+
     // Check that none of the input filenames are used as the output file
     for (qint32 i = 0; i < totalNumberOfInputFiles; i++) {
         if (inputFilenames[i] == outputFilename) {
@@ -247,6 +271,24 @@ int main(int argc, char *argv[])
         qInfo() << "Using over correction mode - dropout lengths will be extended to compensate for slow ramping start and end points";
     }
 
+    // Selective rewriting if required
+    if (selective) {
+        qInfo() << "Using selective mode - only fields containing dropouts will be rewritten in the output";
+    }
+
+    // Select the frames by VBI address if required (using the VBI of the primary source)
+    qint32 startFrame = -1;
+    qint32 length = -1;
+    if (!processStandardVbiRangeOptions(parser, *ldDecodeMetaData[0], startFrame, length)) {
+        return -1;
+    }
+
+    // The output must still contain every field, so a range relies on selective mode
+    if (startFrame != -1 && !selective) {
+        qCritical("A VBI range can only be used in selective mode (-s)");
+        return -1;
+    }
+
     // Show and open input source TBC files
     qDebug() << "main(): Opening source video files...";
     QVector<SourceVideo *> sourceVideos;
@@ -304,9 +346,9 @@ int main(int argc, char *argv[])
     // Perform the DOC process ----------------------------------------------------------------------------------------
     qInfo() << "Initial source checks are ok and sources are loaded";
     qint32 result = 0;
-    CorrectorPool correctorPool(outputFilename, outputJsonFilename, maxThreads,
+    CorrectorPool correctorPool(inputFilenames[0], outputFilename, outputJsonFilename, startFrame, length, maxThreads,
                                 ldDecodeMetaData, sourceVideos,
-                                reverse, intraField, overCorrect);
+                                reverse, intraField, overCorrect, selective);
     if (!correctorPool.process()) result = 1;
 
     // Report on the result of the correction process
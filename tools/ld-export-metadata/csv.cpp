@@ -101,27 +101,11 @@ bool writeVbiCsv(LdDecodeMetaData &metaData, const QString &fileName)
     outStream << "leadIn,leadOut,userCode,stopCode";
     outStream << '\n';
 
-    for (qint32 frameNumber = 1; frameNumber <= metaData.getNumberOfFrames(); frameNumber++) {
-        // Get the required field numbers
-        qint32 firstFieldNumber = metaData.getFirstFieldNumber(frameNumber);
-        qint32 secondFieldNumber = metaData.getSecondFieldNumber(frameNumber);
-
-        // Get the field metadata
-        LdDecodeMetaData::Field firstField = metaData.getField(firstFieldNumber);
-        LdDecodeMetaData::Field secondField = metaData.getField(secondFieldNumber);
-
-        qint32 vbi16_1, vbi17_1, vbi18_1;
-        qint32 vbi16_2, vbi17_2, vbi18_2;
-
-        vbi16_1 = firstField.vbi.vbiData[0];
-        vbi17_1 = firstField.vbi.vbiData[1];
-        vbi18_1 = firstField.vbi.vbiData[2];
-        vbi16_2 = secondField.vbi.vbiData[0];
-        vbi17_2 = secondField.vbi.vbiData[1];
-        vbi18_2 = secondField.vbi.vbiData[2];
-
-        VbiDecoder vbiDecoder;
-        VbiDecoder::Vbi vbi = vbiDecoder.decodeFrame(vbi16_1, vbi17_1, vbi18_1, vbi16_2, vbi17_2, vbi18_2);
+    // Get the decoded VBI for all the frames
+    const QVector<VbiDecoder::Vbi> &frameVbi = metaData.getFrameVbiTable();
+
+    for (qint32 frameNumber = 1; frameNumber <= frameVbi.size(); frameNumber++) {
+        const VbiDecoder::Vbi &vbi = frameVbi[frameNumber - 1];
 
         outStream << escapedString(QString::number(frameNumber)) << ",";
 
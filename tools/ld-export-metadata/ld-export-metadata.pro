@@ -19,6 +19,8 @@ SOURCES += \
     ffmetadata.cpp \
     main.cpp \
     ../library/tbc/lddecodemetadata.cpp \
+    ../library/tbc/jsonreader.cpp \
+    ../library/tbc/jsonwriter.cpp \
     ../library/tbc/vbidecoder.cpp \
     ../library/tbc/logging.cpp \
     ../library/tbc/dropouts.cpp
@@ -27,6 +29,8 @@ HEADERS += \
     csv.h \
     ffmetadata.h \
     ../library/tbc/lddecodemetadata.h \
+    ../library/tbc/jsonreader.h \
+    ../library/tbc/jsonwriter.h \
     ../library/tbc/vbidecoder.h \
     ../library/tbc/logging.h \
     ../library/tbc/dropouts.h
@@ -78,10 +78,15 @@ int main(int argc, char *argv[])
                                              QCoreApplication::translate("main", "file"));
     parser.addOption(writeFfmetadataOption);
 
+    QCommandLineOption writeJsonOption("json",
+                                       QCoreApplication::translate("main", "Write metadata as standard JSON (e.g. to compact an ld-decode journal)"),
+                                       QCoreApplication::translate("main", "file"));
+    parser.addOption(writeJsonOption);
+
     // -- Positional arguments --
 
     // Positional argument to specify input video file
-    parser.addPositionalArgument("input", QCoreApplication::translate("main", "Specify input JSON file"));
+    parser.addPositionalArgument("input", QCoreApplication::translate("main", "Specify input JSON file (or ld-decode .tbc.jsonl journal)"));
 
     // Process the command line options and arguments given by the user
     parser.process(a);
@@ -128,6 +133,13 @@ int main(int argc, char *argv[])
             return 1;
         }
     }
+    if (parser.isSet(writeJsonOption)) {
+        const QString &fileName = parser.value(writeJsonOption);
+        if (!metaData.write(fileName)) {
+            qCritical() << "Failed to write output file:" << fileName;
+            return 1;
+        }
+    }
 
     // Quit with success
     return 0;
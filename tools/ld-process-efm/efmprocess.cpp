@@ -24,6 +24,8 @@
 
 #include "efmprocess.h"
 
+#include "stagestats.h"
+
 EfmProcess::EfmProcess(QObject *parent) : QThread(parent)
 {
     // Thread control variables
@@ -208,22 +210,36 @@ void EfmProcess::run()
         qint32 lastPercent = 0;
         while(efmInputFileHandle->bytesAvailable() > 0 && !abort && !cancel) {
             // Get a buffer of EFM data
+            StageTimer timer("input");
             QByteArray inputEfmBuffer;
             inputEfmBuffer = readEfmData();
+            StageStats::count("efmBytes", inputEfmBuffer.size());
 
             // Perform processing
+            timer.restart("efmToF3Frames");
             QVector<F3Frame> initialF3Frames = efmToF3Frames.process(inputEfmBuffer, debug_efmToF3Frames);
+            timer.restart("syncF3Frames");
             QVector<F3Frame> syncedF3Frames = syncF3Frames.process(initialF3Frames, debug_syncF3Frames);
+            timer.restart("f3ToF2Frames");
             QVector<F2Frame> f2Frames = f3ToF2Frames.process(syncedF3Frames, debug_f3ToF2Frames, noTimeStamp);
+            timer.restart("f2ToF1Frames");
             QVector<F1Frame> f1Frames = f2ToF1Frames.process(f2Frames, debug_f2ToF1Frame, noTimeStamp);
+            StageStats::count("f1Frames", f1Frames.size());
 
             if (decodeAsAudio) {
-                audioOutputFileHandle->write(f1ToAudio.process(f1Frames, padInitialDiscTime, errorTreatment, concealType, debug_f1ToAudio));
+                timer.restart("f1ToAudio");
+                QByteArray audioData = f1ToAudio.process(f1Frames, padInitialDiscTime, errorTreatment, concealType, debug_f1ToAudio);
+                timer.restart("output");
+                audioOutputFileHandle->write(audioData);
             }
 
             if (decodeAsData) {
-                dataOutputFileHandle->write(f1ToData.process(f1Frames, debug_f1ToData));
+                timer.restart("f1ToData");
+                QByteArray sectorData = f1ToData.process(f1Frames, debug_f1ToData);
+                timer.restart("output");
+                dataOutputFileHandle->write(sectorData);
             }
+            timer.stop();
 
             // Report progress to parent
             qreal percent = 100 - (100.0 / static_cast<qreal>(initialInputFileSize)) * static_cast<qreal>(efmInputFileHandle->bytesAvailable());
@@ -46,7 +46,9 @@ SOURCES += \
         efmprocess.cpp \
         main.cpp \
         mainwindow.cpp \
-        ../library/tbc/logging.cpp
+        ../library/tbc/jsonwriter.cpp \
+        ../library/tbc/logging.cpp \
+        ../library/tbc/stagestats.cpp
 
 HEADERS += \
         Datatypes/audio.h \
@@ -80,7 +82,9 @@ HEADERS += \
         ezpwd/serialize_definitions \
         ezpwd/timeofday \
         mainwindow.h \
-        ../library/tbc/logging.h
+        ../library/tbc/jsonwriter.h \
+        ../library/tbc/logging.h \
+        ../library/tbc/stagestats.h
 
 FORMS += \
         aboutdialog.ui \
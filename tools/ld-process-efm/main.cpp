@@ -29,6 +29,7 @@
 #include <QCommandLineParser>
 
 #include "logging.h"
+#include "stagestats.h"
 
 int main(int argc, char *argv[])
 {
@@ -56,6 +57,9 @@ int main(int argc, char *argv[])
     // Add the standard debug options --debug and --quiet
     addStandardDebugOptions(parser);
 
+    // Add the standard statistics options --stats-json and --stats-interval
+    addStandardStatsOptions(parser);
+
     // Option to run in non-interactive mode (-n / --noninteractive)
     QCommandLineOption nonInteractiveOption(QStringList() << "n" << "noninteractive",
                                        QCoreApplication::translate("main", "Run in non-interactive mode"));
@@ -75,6 +79,9 @@ int main(int argc, char *argv[])
     // Standard logging options
     processStandardDebugOptions(parser);
 
+    // Standard statistics options
+    if (!processStandardStatsOptions(parser)) return 1;
+
     // Get the options from the parser
     bool isNonInteractiveOn = parser.isSet(nonInteractiveOption);
 
@@ -25,7 +25,7 @@
 #include "closedcaption.h"
 
 // Public method to read CEA-608 Closed Captioning data (NTSC only)
-ClosedCaption::CcData ClosedCaption::getData(const SourceVideo::Data &lineData, LdDecodeMetaData::VideoParameters videoParameters)
+ClosedCaption::CcData ClosedCaption::getData(const quint16 *lineData, qint32 lineLength, const LdDecodeMetaData::VideoParameters &videoParameters)
 {
     CcData ccData;
     ccData.byte0 = 0;
@@ -36,7 +36,7 @@ ClosedCaption::CcData ClosedCaption::getData(const SourceVideo::Data &lineData,
     qint32 zcPoint = ((videoParameters.white16bIre - videoParameters.black16bIre) / 4) + videoParameters.black16bIre;
 
     // Get the transition map for the line
-    QVector<bool> transitionMap = getTransitionMap(lineData, zcPoint);
+    transitionMap.build(lineData, lineLength, zcPoint);
 
     // Set the number of samples to the expected start of the start bit transition
     qint32 expectedStart = 262;
@@ -126,29 +126,3 @@ bool ClosedCaption::isEvenParity(uchar data)
 
     return true;
 }
-
-// Private method to get the map of transitions across the sample and reject noise
-QVector<bool> ClosedCaption::getTransitionMap(const SourceVideo::Data &lineData, qint32 zcPoint)
-{
-    // First read the data into a boolean array using debounce to remove transition noise
-    bool previousState = false;
-    bool currentState = false;
-    qint32 debounce = 0;
-    QVector<bool> transitionMap;
-
-    // Each value is 2 bytes (16-bit greyscale data)
-    for (qint32 xPoint = 0; xPoint < lineData.size(); xPoint++) {
-        if (lineData[xPoint] > zcPoint) currentState = true; else currentState = false;
-
-        if (currentState != previousState) debounce++;
-
-        if (debounce > 3) {
-            debounce = 0;
-            previousState = currentState;
-        }
-
-        transitionMap.append(previousState);
-    }
-
-    return transitionMap;
-}
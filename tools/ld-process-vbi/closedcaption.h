@@ -27,6 +27,7 @@
 
 #include "sourcevideo.h"
 #include "lddecodemetadata.h"
+#include "transitionmap.h"
 
 class ClosedCaption
 {
@@ -37,11 +38,13 @@ public:
         bool isValid;
     };
 
-    CcData getData(const SourceVideo::Data &lineData, LdDecodeMetaData::VideoParameters videoParameters);
+    CcData getData(const quint16 *lineData, qint32 lineLength, const LdDecodeMetaData::VideoParameters &videoParameters);
 
 private:
+    // Transition map buffer, reused for each line
+    TransitionMap transitionMap;
+
     bool isEvenParity(uchar data);
-    QVector<bool> getTransitionMap(const SourceVideo::Data &lineData, qint32 zcPoint);
 };
 
 #endif // CLOSEDCAPTION_H
@@ -24,10 +24,14 @@
 
 #include "decoderpool.h"
 
+#include "stagestats.h"
+
 DecoderPool::DecoderPool(QString _inputFilename, QString _outputJsonFilename,
-                         qint32 _maxThreads, LdDecodeMetaData &_ldDecodeMetaData)
+                         qint32 _maxThreads, LdDecodeMetaData &_ldDecodeMetaData,
+                         const VbiLineDecoder::Configuration &_configuration)
     : inputFilename(_inputFilename), outputJsonFilename(_outputJsonFilename),
-      maxThreads(_maxThreads), ldDecodeMetaData(_ldDecodeMetaData)
+      maxThreads(_maxThreads), configuration(_configuration), startFieldLine(-1), endFieldLine(-1),
+      ldDecodeMetaData(_ldDecodeMetaData)
 {
 }
 
@@ -38,6 +42,13 @@ bool DecoderPool::process()
     qInfo().noquote() << "Input TBC source dimensions are" << videoParameters.fieldWidth << "x" <<
                 videoParameters.fieldHeight;
 
+    // Work out which lines the analysers need, so only those are read from the input
+    if (!VbiLineDecoder::getFieldLineRange(configuration, videoParameters, startFieldLine, endFieldLine)) {
+        qCritical() << "None of the selected analysers apply to this source";
+        return false;
+    }
+    qInfo() << "Reading field lines" << startFieldLine << "to" << endFieldLine;
+
     // Open the source video
     if (!sourceVideo.open(inputFilename, videoParameters.fieldWidth * videoParameters.fieldHeight, videoParameters.fieldWidth)) {
         // Could not open source video file
@@ -96,6 +107,18 @@ bool DecoderPool::process()
     return true;
 }
 
+// Get the analysers to run
+const VbiLineDecoder::Configuration &DecoderPool::getConfiguration() const
+{
+    return configuration;
+}
+
+// Get the first field line in the input data returned by getInputField
+qint32 DecoderPool::getStartFieldLine() const
+{
+    return startFieldLine;
+}
+
 // Get the next field that needs processing from the input.
 //
 // Returns true if a field was returned, false if the end of the input has been
@@ -103,6 +126,7 @@ bool DecoderPool::process()
 bool DecoderPool::getInputField(qint32 &fieldNumber, SourceVideo::Data &fieldVideoData,
                                 LdDecodeMetaData::Field &fieldMetadata, LdDecodeMetaData::VideoParameters &videoParameters)
 {
+    StageTimer timer("input");
     QMutexLocker locker(&inputMutex);
 
     if (inputFieldNumber > lastFieldNumber) {
@@ -117,7 +141,7 @@ bool DecoderPool::getInputField(qint32 &fieldNumber, SourceVideo::Data &fieldVid
     qDebug() << "DecoderPool::process(): Processing field number" << fieldNumber;
 
     // Fetch the input data
-    fieldVideoData = sourceVideo.getVideoField(fieldNumber, VbiLineDecoder::startFieldLine, VbiLineDecoder::endFieldLine);
+    fieldVideoData = sourceVideo.getVideoField(fieldNumber, startFieldLine, endFieldLine);
     fieldMetadata = ldDecodeMetaData.getField(fieldNumber);
     videoParameters = ldDecodeMetaData.getVideoParameters();
 
@@ -129,11 +153,20 @@ bool DecoderPool::getInputField(qint32 &fieldNumber, SourceVideo::Data &fieldVid
 // Returns true on success, false on failure.
 bool DecoderPool::setOutputField(qint32 fieldNumber, LdDecodeMetaData::Field fieldMetadata)
 {
+    StageTimer timer("output");
     QMutexLocker locker(&outputMutex);
+    StageStats::count("fields");
 
-    // Save the field data to the metadata (only VBI and NTSC metadata is affected)
-    ldDecodeMetaData.updateFieldVbi(fieldMetadata.vbi, fieldNumber);
-    ldDecodeMetaData.updateFieldNtsc(fieldMetadata.ntsc, fieldNumber);
+    // Save the field data to the metadata (only the metadata from the selected analysers is affected)
+    if (configuration.vbi) {
+        ldDecodeMetaData.updateFieldVbi(fieldMetadata.vbi, fieldNumber);
+    }
+    if (configuration.fmCode || configuration.whiteFlag || configuration.closedCaption) {
+        ldDecodeMetaData.updateFieldNtsc(fieldMetadata.ntsc, fieldNumber);
+    }
+    if (configuration.snr) {
+        ldDecodeMetaData.updateFieldVitsMetrics(fieldMetadata.vitsMetrics, fieldNumber);
+    }
 
     return true;
 }
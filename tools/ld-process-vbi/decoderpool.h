@@ -39,10 +39,14 @@ class DecoderPool
 public:
     // Public methods
     explicit DecoderPool(QString _inputFilename, QString _outputJsonFilename,
-                        qint32 _maxThreads, LdDecodeMetaData &_ldDecodeMetaData);
+                        qint32 _maxThreads, LdDecodeMetaData &_ldDecodeMetaData,
+                        const VbiLineDecoder::Configuration &_configuration);
     bool process();
 
     // Member functions used by worker threads
+    const VbiLineDecoder::Configuration &getConfiguration() const;
+    qint32 getStartFieldLine() const;
+
     bool getInputField(qint32 &fieldNumber, SourceVideo::Data &fieldVideoData, LdDecodeMetaData::Field &fieldMetadata, LdDecodeMetaData::VideoParameters &videoParameters);
     bool setOutputField(qint32 fieldNumber, LdDecodeMetaData::Field fieldMetadata);
 
@@ -50,8 +54,13 @@ private:
     QString inputFilename;
     QString outputJsonFilename;
     qint32 maxThreads;
+    VbiLineDecoder::Configuration configuration;
     QElapsedTimer totalTimer;
 
+    // The range of field lines read from the input (inclusive)
+    qint32 startFieldLine;
+    qint32 endFieldLine;
+
     // Atomic abort flag shared by worker threads; workers watch this, and shut
     // down as soon as possible if it becomes true
     QAtomicInt abort;
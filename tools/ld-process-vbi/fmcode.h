@@ -27,6 +27,7 @@
 
 #include "sourcevideo.h"
 #include "lddecodemetadata.h"
+#include "transitionmap.h"
 
 class FmCode
 {
@@ -40,11 +41,13 @@ public:
         quint64 trailingDataRecognitionBits;
     };
 
-    FmCode::FmDecode fmDecoder(const SourceVideo::Data &lineData, LdDecodeMetaData::VideoParameters videoParameters);
+    FmCode::FmDecode fmDecoder(const quint16 *lineData, qint32 lineLength, const LdDecodeMetaData::VideoParameters &videoParameters);
 
 private:
+    // Transition map buffer, reused for each line
+    TransitionMap fmData;
+
     bool isEvenParity(quint64 data);
-    QVector<bool> getTransitionMap(const SourceVideo::Data &lineData, qint32 zcPoint);
 };
 
 #endif // FMCODE_H
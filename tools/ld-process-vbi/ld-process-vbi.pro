@@ -19,24 +19,34 @@ SOURCES += \
     decoderpool.cpp \
     main.cpp \
     fmcode.cpp \
+    snrmetrics.cpp \
+    transitionmap.cpp \
     vbilinedecoder.cpp \
     whiteflag.cpp \
     ../library/tbc/lddecodemetadata.cpp \
+    ../library/tbc/jsonreader.cpp \
+    ../library/tbc/jsonwriter.cpp \
     ../library/tbc/sourcevideo.cpp \
     ../library/tbc/vbidecoder.cpp \
     ../library/tbc/logging.cpp \
+    ../library/tbc/stagestats.cpp \
     ../library/tbc/dropouts.cpp
 
 HEADERS += \
     closedcaption.h \
     decoderpool.h \
     fmcode.h \
+    snrmetrics.h \
+    transitionmap.h \
     vbilinedecoder.h \
     whiteflag.h \
     ../library/tbc/lddecodemetadata.h \
+    ../library/tbc/jsonreader.h \
+    ../library/tbc/jsonwriter.h \
     ../library/tbc/sourcevideo.h \
     ../library/tbc/vbidecoder.h \
     ../library/tbc/logging.h \
+    ../library/tbc/stagestats.h \
     ../library/tbc/dropouts.h
 
 # Add external includes to the include path
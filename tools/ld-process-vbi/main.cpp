@@ -29,6 +29,7 @@
 #include <QThread>
 
 #include "logging.h"
+#include "stagestats.h"
 #include "decoderpool.h"
 
 int main(int argc, char *argv[])
@@ -57,6 +58,9 @@ int main(int argc, char *argv[])
     // Add the standard debug options --debug and --quiet
     addStandardDebugOptions(parser);
 
+    // Add the standard statistics options --stats-json and --stats-interval
+    addStandardStatsOptions(parser);
+
     // Option to specify a different JSON input file
     QCommandLineOption inputJsonOption(QStringList() << "input-json",
                                        QCoreApplication::translate("main", "Specify the input JSON file (default input.json)"),
@@ -80,6 +84,13 @@ int main(int argc, char *argv[])
                                         QCoreApplication::translate("main", "number"));
     parser.addOption(threadsOption);
 
+    // Option to select the analysers to run (-a)
+    QCommandLineOption analysersOption(QStringList() << "a" << "analysers",
+                                       QCoreApplication::translate("main", "Specify a comma-separated list of analysers to run, from: "
+                                                                           "vbi, fmcode, whiteflag, cc, snr (default vbi,fmcode,whiteflag,cc)"),
+                                       QCoreApplication::translate("main", "list"));
+    parser.addOption(analysersOption);
+
     // Positional argument to specify input TBC file
     parser.addPositionalArgument("input", QCoreApplication::translate("main", "Specify input TBC file"));
 
@@ -89,6 +100,9 @@ int main(int argc, char *argv[])
     // Standard logging options
     processStandardDebugOptions(parser);
 
+    // Standard statistics options
+    if (!processStandardStatsOptions(parser)) return -1;
+
     // Get the options from the parser
     bool noBackup = parser.isSet(showNoBackupOption);
 
@@ -103,6 +117,30 @@ int main(int argc, char *argv[])
         }
     }
 
+    VbiLineDecoder::Configuration configuration;
+    if (parser.isSet(analysersOption)) {
+        configuration.vbi = false;
+        configuration.fmCode = false;
+        configuration.whiteFlag = false;
+        configuration.closedCaption = false;
+        configuration.snr = false;
+
+        for (const QString &name : parser.value(analysersOption).split(",")) {
+            const QString analyser = name.trimmed().toLower();
+            if (analyser.isEmpty()) continue;
+            else if (analyser == "vbi") configuration.vbi = true;
+            else if (analyser == "fmcode") configuration.fmCode = true;
+            else if (analyser == "whiteflag") configuration.whiteFlag = true;
+            else if (analyser == "cc") configuration.closedCaption = true;
+            else if (analyser == "snr") configuration.snr = true;
+            else {
+                // Quit with error
+                qCritical() << "Unknown analyser" << analyser << "- valid analysers are vbi, fmcode, whiteflag, cc and snr";
+                return -1;
+            }
+        }
+    }
+
     // Get the arguments from the parser
     QString inputFilename;
     QStringList positionalArguments = parser.positionalArguments();
@@ -143,7 +181,7 @@ int main(int argc, char *argv[])
 
     // Perform the processing
     qInfo() << "Beginning VBI processing...";
-    DecoderPool decoderPool(inputFilename, outputJsonFilename, maxThreads, metaData);
+    DecoderPool decoderPool(inputFilename, outputJsonFilename, maxThreads, metaData, configuration);
     if (!decoderPool.process()) return 1;
 
     // Quit with success
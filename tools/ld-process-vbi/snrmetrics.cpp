@@ -0,0 +1,96 @@
+/************************************************************************
+
+    snrmetrics.cpp
+
+    ld-process-vbi - VBI and IEC NTSC specific processor for ld-decode
+    Copyright (C) 2026 agent
+
+    This file is part of ld-decode-tools.
+
+    ld-process-vbi is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+************************************************************************/
+
+
+#include "snrmetrics.h"
+
+#include <QtMath>
+
+// Public method to get the possible locations of the white reference.
+// These are the same locations that ld-decode tries, in the same order.
+QVector<SnrMetrics::Location> SnrMetrics::getWhiteLocations(const LdDecodeMetaData::VideoParameters &videoParameters)
+{
+    if (videoParameters.isSourcePal) return {{19, 12.0, 8.0}};
+    else return {{20, 14.0, 12.0}, {20, 52.0, 8.0}, {13, 13.0, 15.0}};
+}
+
+// Public method to get the location of the black reference
+SnrMetrics::Location SnrMetrics::getBlackLocation(const LdDecodeMetaData::VideoParameters &videoParameters)
+{
+    if (videoParameters.isSourcePal) return Location {22, 12.0, 50.0};
+    else return Location {1, 10.0, 20.0};
+}
+
+// Public method to measure the SNR metrics for a field
+void SnrMetrics::updateMetrics(const QVector<const quint16 *> &whiteLines, const quint16 *blackLine,
+                               const LdDecodeMetaData::VideoParameters &videoParameters,
+                               LdDecodeMetaData::VitsMetrics &vitsMetrics)
+{
+    double mean, stdDev;
+
+    // The white SNR is only valid if the section actually contains a white
+    // reference, so use the first location that does
+    const QVector<Location> whiteLocations = getWhiteLocations(videoParameters);
+    for (qint32 i = 0; i < whiteLocations.size() && i < whiteLines.size(); i++) {
+        if (getSectionIre(whiteLines[i], whiteLocations[i], videoParameters, mean, stdDev)
+                && mean >= 90.0 && mean <= 110.0 && stdDev > 0.0) {
+            vitsMetrics.wSNR = 20.0 * log10(100.0 / stdDev);
+            break;
+        }
+    }
+
+    if (getSectionIre(blackLine, getBlackLocation(videoParameters), videoParameters, mean, stdDev)
+            && stdDev > 0.0) {
+        vitsMetrics.bPSNR = 20.0 * log10(100.0 / stdDev);
+    }
+
+    vitsMetrics.inUse = true;
+}
+
+// Private method to get the mean and standard deviation of a section of a line, in IRE.
+// Returns false if the section is empty.
+bool SnrMetrics::getSectionIre(const quint16 *lineData, const Location &location,
+                               const LdDecodeMetaData::VideoParameters &videoParameters,
+                               double &mean, double &stdDev)
+{
+    const double samplesPerUsec = videoParameters.sampleRate / 1000000.0;
+    const qint32 start = qBound(0, static_cast<qint32>(location.startUsecs * samplesPerUsec), videoParameters.fieldWidth);
+    const qint32 end = qBound(start, start + static_cast<qint32>(location.lengthUsecs * samplesPerUsec), videoParameters.fieldWidth);
+    const qint32 length = end - start;
+    if (lineData == nullptr || length == 0) return false;
+
+    const double black = videoParameters.black16bIre;
+    const double ireScale = 100.0 / (videoParameters.white16bIre - videoParameters.black16bIre);
+
+    double sum = 0.0, sumSquares = 0.0;
+    for (qint32 x = start; x < end; x++) {
+        const double ire = (lineData[x] - black) * ireScale;
+        sum += ire;
+        sumSquares += ire * ire;
+    }
+
+    mean = sum / length;
+    stdDev = qSqrt(qMax(0.0, (sumSquares / length) - (mean * mean)));
+    return true;
+}
@@ -0,0 +1,67 @@
+/************************************************************************
+
+    snrmetrics.h
+
+    ld-process-vbi - VBI and IEC NTSC specific processor for ld-decode
+    Copyright (C) 2026 agent
+
+    This file is part of ld-decode-tools.
+
+    ld-process-vbi is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+************************************************************************/
+
+
+#ifndef SNRMETRICS_H
+#define SNRMETRICS_H
+
+#include <QVector>
+
+#include "lddecodemetadata.h"
+
+// Measure the signal-to-noise ratio of a field, in the same way as ld-decode
+// does when it produces the vitsMetrics metadata: the white SNR from a
+// section of a white reference (VITS) line, and the black PSNR from a
+// section of a line which should be blank.
+class SnrMetrics
+{
+public:
+    // The location of a measurement
+    struct Location {
+        qint32 fieldLine;   // Field line number (from 1)
+        double startUsecs;  // Start position, in microseconds from the start of the line
+        double lengthUsecs; // Length, in microseconds
+    };
+
+    // Get the locations to measure for a video system. There are several
+    // possible locations for the white reference, in order of preference.
+    static QVector<Location> getWhiteLocations(const LdDecodeMetaData::VideoParameters &videoParameters);
+    static Location getBlackLocation(const LdDecodeMetaData::VideoParameters &videoParameters);
+
+    // Measure the metrics, given pointers to the start of the lines for each
+    // of the white locations and the black line (the whole line, not just
+    // the active area), and update vitsMetrics with the results.
+    // The first white location that contains a white reference is used; if
+    // none do, or a line is missing, the existing value is left unchanged.
+    void updateMetrics(const QVector<const quint16 *> &whiteLines, const quint16 *blackLine,
+                       const LdDecodeMetaData::VideoParameters &videoParameters,
+                       LdDecodeMetaData::VitsMetrics &vitsMetrics);
+
+private:
+    bool getSectionIre(const quint16 *lineData, const Location &location,
+                       const LdDecodeMetaData::VideoParameters &videoParameters,
+                       double &mean, double &stdDev);
+};
+
+#endif // SNRMETRICS_H
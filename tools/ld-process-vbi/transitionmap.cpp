@@ -0,0 +1,68 @@
+/************************************************************************
+
+    transitionmap.cpp
+
+    ld-process-vbi - VBI and IEC NTSC specific processor for ld-decode
+    Copyright (C) 2026 agent
+
+    This file is part of ld-decode-tools.
+
+    ld-process-vbi is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+************************************************************************/
+
+
+#include "transitionmap.h"
+
+TransitionMap::TransitionMap()
+    : length(0)
+{
+}
+
+// Build the map of transitions across the line, using debounce to remove
+// transition noise
+void TransitionMap::build(const quint16 *lineData, qint32 lineLength, qint32 zcPoint)
+{
+    length = lineLength;
+
+    // This only reallocates if the buffer needs to grow
+    const qint32 numWords = (lineLength + 63) / 64;
+    if (bits.size() < numWords) bits.resize(numWords);
+
+    bool previousState = false;
+    qint32 debounce = 0;
+    quint64 word = 0;
+
+    for (qint32 xPoint = 0; xPoint < lineLength; xPoint++) {
+        const bool currentState = lineData[xPoint] > zcPoint;
+
+        if (currentState != previousState) debounce++;
+
+        if (debounce > 3) {
+            debounce = 0;
+            previousState = currentState;
+        }
+
+        if (previousState) word |= Q_UINT64_C(1) << (xPoint & 63);
+
+        // Store each word once it's full
+        if ((xPoint & 63) == 63) {
+            bits[xPoint >> 6] = word;
+            word = 0;
+        }
+    }
+
+    // Store the last partial word
+    if ((lineLength & 63) != 0) bits[lineLength >> 6] = word;
+}
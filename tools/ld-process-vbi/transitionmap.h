@@ -0,0 +1,62 @@
+/************************************************************************
+
+    transitionmap.h
+
+    ld-process-vbi - VBI and IEC NTSC specific processor for ld-decode
+    Copyright (C) 2026 agent
+
+    This file is part of ld-decode-tools.
+
+    ld-process-vbi is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+************************************************************************/
+
+
+#ifndef TRANSITIONMAP_H
+#define TRANSITIONMAP_H
+
+#include <QtGlobal>
+#include <QVector>
+
+// A map of whether each sample in a line is above or below a threshold, with
+// noise around the transitions removed. The map is stored packed into bits,
+// and reused for each line, so building it doesn't allocate memory once the
+// buffer is big enough.
+class TransitionMap
+{
+public:
+    TransitionMap();
+
+    // Build the map for a line of lineLength samples, comparing each sample
+    // with zcPoint
+    void build(const quint16 *lineData, qint32 lineLength, qint32 zcPoint);
+
+    // Return the number of samples in the map
+    qint32 size() const {
+        return length;
+    }
+
+    // Return true if the signal is above the threshold at sample x.
+    // Samples beyond the end of the line read as false.
+    bool operator[](qint32 x) const {
+        if (x < 0 || x >= length) return false;
+        return ((bits[x >> 6] >> (x & 63)) & 1) != 0;
+    }
+
+private:
+    qint32 length;
+    QVector<quint64> bits;
+};
+
+#endif // TRANSITIONMAP_H
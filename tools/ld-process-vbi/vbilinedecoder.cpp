@@ -24,16 +24,45 @@
 
 #include "vbilinedecoder.h"
 #include "decoderpool.h"
-
-// Definitions of static constexpr data members, for compatibility with
-// pre-C++17 compilers
-constexpr qint32 VbiLineDecoder::startFieldLine;
-constexpr qint32 VbiLineDecoder::endFieldLine;
+#include "stagestats.h"
 
 VbiLineDecoder::VbiLineDecoder(QAtomicInt& _abort, DecoderPool& _decoderPool, QObject *parent)
-    : QThread(parent), abort(_abort), decoderPool(_decoderPool)
+    : QThread(parent), abort(_abort), decoderPool(_decoderPool), startFieldLine(1)
+{
+
+}
+
+// Get the range of field lines needed by the analysers
+bool VbiLineDecoder::getFieldLineRange(const Configuration &configuration,
+                                       const LdDecodeMetaData::VideoParameters &videoParameters,
+                                       qint32 &startFieldLine, qint32 &endFieldLine)
 {
+    startFieldLine = videoParameters.fieldHeight + 1;
+    endFieldLine = 0;
+
+    auto addLines = [&](qint32 first, qint32 last) {
+        startFieldLine = qMin(startFieldLine, first);
+        endFieldLine = qMax(endFieldLine, last);
+    };
+
+    if (configuration.vbi) addLines(16, 18);
+
+    // The remaining VBI data is NTSC-only
+    if (!videoParameters.isSourcePal) {
+        if (configuration.fmCode) addLines(10, 10);
+        if (configuration.whiteFlag) addLines(11, 11);
+        if (configuration.closedCaption) addLines(21, 21);
+    }
+
+    if (configuration.snr) {
+        for (const SnrMetrics::Location &location : SnrMetrics::getWhiteLocations(videoParameters)) {
+            addLines(location.fieldLine, location.fieldLine);
+        }
+        const qint32 blackLine = SnrMetrics::getBlackLocation(videoParameters).fieldLine;
+        addLines(blackLine, blackLine);
+    }
 
+    return startFieldLine <= endFieldLine;
 }
 
 // Thread main processing method
@@ -46,6 +75,15 @@ void VbiLineDecoder::run()
     LdDecodeMetaData::Field fieldMetadata;
     LdDecodeMetaData::VideoParameters videoParameters;
 
+    // Decoders (which keep their buffers between fields)
+    FmCode fmCode;
+    WhiteFlag whiteFlag;
+    ClosedCaption closedCaption;
+    SnrMetrics snrMetrics;
+
+    const VbiLineDecoder::Configuration &configuration = decoderPool.getConfiguration();
+    startFieldLine = decoderPool.getStartFieldLine();
+
     while(!abort) {
         // Get the next field to process from the input file
         if (!decoderPool.getInputField(fieldNumber, sourceFieldData, fieldMetadata, videoParameters)) {
@@ -53,13 +91,10 @@ void VbiLineDecoder::run()
             break;
         }
 
-        FmCode fmCode;
-        FmCode::FmDecode fmDecode;
+        StageTimer decodeTimer("decode");
 
+        FmCode::FmDecode fmDecode;
         bool isWhiteFlag = false;
-        WhiteFlag whiteFlag;
-
-        ClosedCaption closedCaption;
         ClosedCaption::CcData ccData;
 
         if (fieldMetadata.isFirstField) qDebug() << "VbiDecoder::process(): Getting metadata for field" << fieldNumber << "(first)";
@@ -69,11 +104,15 @@ void VbiLineDecoder::run()
         qint32 zcPoint = videoParameters.white16bIre - videoParameters.black16bIre;
 
         // Get the VBI data from field lines 16-18
-        qDebug() << "VbiDecoder::process(): Getting field-lines for field" << fieldNumber;
-        for (qint32 i = 0; i < 3; i++) {
-            fieldMetadata.vbi.vbiData[i] = manchesterDecoder(getActiveVideoLine(sourceFieldData, i + 16 - startFieldLine, videoParameters),
-                                                             zcPoint, videoParameters);
-            if (fieldMetadata.vbi.vbiData[i] == 0) qDebug() << "VbiDecoder::process(): No VBI present on line" << i + 16;
+        if (configuration.vbi) {
+            qDebug() << "VbiDecoder::process(): Getting field-lines for field" << fieldNumber;
+            for (qint32 i = 0; i < 3; i++) {
+                fieldMetadata.vbi.vbiData[i] = manchesterDecoder(getActiveVideoLine(sourceFieldData, i + 16, videoParameters),
+                                                                 zcPoint, videoParameters);
+                if (fieldMetadata.vbi.vbiData[i] == 0) qDebug() << "VbiDecoder::process(): No VBI present on line" << i + 16;
+            }
+
+            fieldMetadata.vbi.inUse = true;
         }
 
         // Show the VBI data as hexadecimal (for every 1000th field)
@@ -84,40 +123,59 @@ void VbiLineDecoder::run()
         // Process NTSC specific data if source type is NTSC
         if (!videoParameters.isSourcePal) {
             // Get the 40-bit FM coded data from field line 10
-            fmDecode = fmCode.fmDecoder(getActiveVideoLine(sourceFieldData, 10 - startFieldLine, videoParameters), videoParameters);
+            if (configuration.fmCode) {
+                const LineView fmCodeLine = getActiveVideoLine(sourceFieldData, 10, videoParameters);
+                fmDecode = fmCode.fmDecoder(fmCodeLine.data, fmCodeLine.length, videoParameters);
+
+                if (fmDecode.receiverClockSyncBits != 0) {
+                    fieldMetadata.ntsc.isFmCodeDataValid = true;
+                    fieldMetadata.ntsc.fmCodeData = static_cast<qint32>(fmDecode.data);
+                    if (fmDecode.videoFieldIndicator == 1) fieldMetadata.ntsc.fieldFlag = true;
+                    else fieldMetadata.ntsc.fieldFlag = false;
+                } else {
+                    fieldMetadata.ntsc.isFmCodeDataValid = false;
+                    fieldMetadata.ntsc.fmCodeData = -1;
+                    fieldMetadata.ntsc.fieldFlag = false;
+                }
+                fieldMetadata.ntsc.inUse = true;
+            }
 
             // Get the white flag from field line 11
-            isWhiteFlag = whiteFlag.getWhiteFlag(getActiveVideoLine(sourceFieldData, 11 - startFieldLine, videoParameters), videoParameters);
+            if (configuration.whiteFlag) {
+                const LineView whiteFlagLine = getActiveVideoLine(sourceFieldData, 11, videoParameters);
+                isWhiteFlag = whiteFlag.getWhiteFlag(whiteFlagLine.data, whiteFlagLine.length, videoParameters);
 
-            // Get the closed captioning from field line 21
-            ccData = closedCaption.getData(getActiveVideoLine(sourceFieldData, 21 - startFieldLine, videoParameters), videoParameters);
-
-            // Update the metadata
-            if (fmDecode.receiverClockSyncBits != 0) {
-                fieldMetadata.ntsc.isFmCodeDataValid = true;
-                fieldMetadata.ntsc.fmCodeData = static_cast<qint32>(fmDecode.data);
-                if (fmDecode.videoFieldIndicator == 1) fieldMetadata.ntsc.fieldFlag = true;
-                else fieldMetadata.ntsc.fieldFlag = false;
-            } else {
-                fieldMetadata.ntsc.isFmCodeDataValid = false;
-                fieldMetadata.ntsc.fmCodeData = -1;
-                fieldMetadata.ntsc.fieldFlag = false;
+                fieldMetadata.ntsc.whiteFlag = isWhiteFlag;
+                fieldMetadata.ntsc.inUse = true;
             }
 
-            fieldMetadata.ntsc.whiteFlag = isWhiteFlag;
-            fieldMetadata.ntsc.inUse = true;
+            // Get the closed captioning from field line 21
+            if (configuration.closedCaption) {
+                const LineView ccLine = getActiveVideoLine(sourceFieldData, 21, videoParameters);
+                ccData = closedCaption.getData(ccLine.data, ccLine.length, videoParameters);
+
+                if (ccData.isValid) {
+                    fieldMetadata.ntsc.ccData0 = ccData.byte0;
+                    fieldMetadata.ntsc.ccData1 = ccData.byte1;
+                } else {
+                    fieldMetadata.ntsc.ccData0 = -1;
+                    fieldMetadata.ntsc.ccData1 = -1;
+                }
+                fieldMetadata.ntsc.inUse = true;
+            }
+        }
 
-            if (ccData.isValid) {
-                fieldMetadata.ntsc.ccData0 = ccData.byte0;
-                fieldMetadata.ntsc.ccData1 = ccData.byte1;
-            } else {
-                fieldMetadata.ntsc.ccData0 = -1;
-                fieldMetadata.ntsc.ccData1 = -1;
+        // Measure the black and white SNR
+        if (configuration.snr) {
+            QVector<const quint16 *> whiteLines;
+            for (const SnrMetrics::Location &location : SnrMetrics::getWhiteLocations(videoParameters)) {
+                whiteLines.append(getLine(sourceFieldData, location.fieldLine, videoParameters));
             }
+            const quint16 *blackLine = getLine(sourceFieldData, SnrMetrics::getBlackLocation(videoParameters).fieldLine, videoParameters);
+            snrMetrics.updateMetrics(whiteLines, blackLine, videoParameters, fieldMetadata.vitsMetrics);
         }
 
-        // Update the metadata for the field
-        fieldMetadata.vbi.inUse = true;
+        decodeTimer.stop();
 
         // Write the result to the output metadata
         if (!decoderPool.setOutputField(fieldNumber, fieldMetadata)) {
@@ -127,28 +185,46 @@ void VbiLineDecoder::run()
     }
 }
 
-// Private method to get a single scanline of greyscale data
-SourceVideo::Data VbiLineDecoder::getActiveVideoLine(const SourceVideo::Data &sourceField, qint32 fieldLine,
-                                                     LdDecodeMetaData::VideoParameters videoParameters)
+// Private method to get a view of the active video part of a single scanline of greyscale data
+// (without copying it)
+VbiLineDecoder::LineView VbiLineDecoder::getActiveVideoLine(const SourceVideo::Data &sourceField, qint32 fieldLine,
+                                                            const LdDecodeMetaData::VideoParameters &videoParameters)
+{
+    LineView line;
+    line.data = getLine(sourceField, fieldLine, videoParameters);
+    line.length = 0;
+
+    if (line.data != nullptr) {
+        line.data += videoParameters.activeVideoStart;
+        line.length = videoParameters.activeVideoEnd - videoParameters.activeVideoStart;
+    }
+
+    return line;
+}
+
+// Private method to get a pointer to the start of a field line (numbered from 1) in the input data,
+// or nullptr if the line isn't available
+const quint16 *VbiLineDecoder::getLine(const SourceVideo::Data &sourceField, qint32 fieldLine,
+                                       const LdDecodeMetaData::VideoParameters &videoParameters)
 {
     // Range-check the scan line
-    if (fieldLine < 0 || fieldLine >= videoParameters.fieldHeight) {
+    const qint32 inputLine = fieldLine - startFieldLine;
+    const qint32 startPointer = inputLine * videoParameters.fieldWidth;
+    if (inputLine < 0 || fieldLine > videoParameters.fieldHeight
+        || (startPointer + videoParameters.fieldWidth) > sourceField.size()) {
         qWarning() << "Cannot generate field-line data, line number is out of bounds! Scan line =" << fieldLine;
-        return SourceVideo::Data();
+        return nullptr;
     }
 
-    qint32 startPointer = (fieldLine * videoParameters.fieldWidth) + videoParameters.activeVideoStart;
-    qint32 length = videoParameters.activeVideoEnd - videoParameters.activeVideoStart;
-
-    return sourceField.mid(startPointer, length);
+    return sourceField.constData() + startPointer;
 }
 
 // Private method to read a 24-bit biphase coded signal (manchester code) from a field line
-qint32 VbiLineDecoder::manchesterDecoder(const SourceVideo::Data &lineData, qint32 zcPoint,
-                                         LdDecodeMetaData::VideoParameters videoParameters)
+qint32 VbiLineDecoder::manchesterDecoder(const LineView &line, qint32 zcPoint,
+                                         const LdDecodeMetaData::VideoParameters &videoParameters)
 {
     qint32 result = 0;
-    QVector<bool> manchesterData = getTransitionMap(lineData, zcPoint);
+    manchesterData.build(line.data, line.length, zcPoint);
 
     // Get the number of samples for 1.5us
     qreal fJumpSamples = (videoParameters.sampleRate / 1000000) * 1.5;
@@ -203,28 +279,3 @@ qint32 VbiLineDecoder::manchesterDecoder(const SourceVideo::Data &lineData, qint
 
     return result;
 }
-
-// Private method to get the map of transitions across the sample and reject noise
-QVector<bool> VbiLineDecoder::getTransitionMap(const SourceVideo::Data &lineData, qint32 zcPoint)
-{
-    // First read the data into a boolean array using debounce to remove transition noise
-    bool previousState = false;
-    bool currentState = false;
-    qint32 debounce = 0;
-    QVector<bool> manchesterData;
-
-    for (qint32 xPoint = 0; xPoint < lineData.size(); xPoint++) {
-        if (lineData[xPoint] > zcPoint) currentState = true; else currentState = false;
-
-        if (currentState != previousState) debounce++;
-
-        if (debounce > 3) {
-            debounce = 0;
-            previousState = currentState;
-        }
-
-        manchesterData.append(previousState);
-    }
-
-    return manchesterData;
-}
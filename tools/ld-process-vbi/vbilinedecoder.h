@@ -35,6 +35,8 @@
 #include "fmcode.h"
 #include "whiteflag.h"
 #include "closedcaption.h"
+#include "snrmetrics.h"
+#include "transitionmap.h"
 
 class DecoderPool;
 
@@ -42,11 +44,22 @@ class VbiLineDecoder : public QThread {
     Q_OBJECT
 
 public:
+    // The analysers to run on each field
+    struct Configuration {
+        bool vbi = true;            // Biphase-coded VBI on lines 16-18
+        bool fmCode = true;         // NTSC FM code on line 10
+        bool whiteFlag = true;      // NTSC white flag on line 11
+        bool closedCaption = true;  // NTSC closed captions on line 21
+        bool snr = false;           // Black and white SNR (vitsMetrics)
+    };
+
     explicit VbiLineDecoder(QAtomicInt& _abort, DecoderPool& _decoderPool, QObject *parent = nullptr);
 
-    // The range of field lines needed from the input file (inclusive)
-    static constexpr qint32 startFieldLine = 10;
-    static constexpr qint32 endFieldLine = 21;
+    // Get the range of field lines needed from the input file (inclusive) to
+    // run the given analysers. Returns false if no lines are needed.
+    static bool getFieldLineRange(const Configuration &configuration,
+                                  const LdDecodeMetaData::VideoParameters &videoParameters,
+                                  qint32 &startFieldLine, qint32 &endFieldLine);
 
 protected:
     void run() override;
@@ -59,11 +72,24 @@ private:
     // Temporary output buffer
     LdDecodeMetaData::Field outputData;
 
-    SourceVideo::Data getActiveVideoLine(const SourceVideo::Data& sourceFrame, qint32 scanLine,
-                                         LdDecodeMetaData::VideoParameters videoParameters);
-    qint32 manchesterDecoder(const SourceVideo::Data& lineData, qint32 zcPoint,
-                             LdDecodeMetaData::VideoParameters videoParameters);
-    QVector<bool> getTransitionMap(const SourceVideo::Data& lineData, qint32 zcPoint);
+    // The first field line in the input data
+    qint32 startFieldLine;
+
+    // Transition map buffer for the Manchester decoder, reused for each line
+    TransitionMap manchesterData;
+
+    // A view of the active video part of a line within a field's data
+    struct LineView {
+        const quint16 *data;
+        qint32 length;
+    };
+
+    LineView getActiveVideoLine(const SourceVideo::Data& sourceField, qint32 fieldLine,
+                                const LdDecodeMetaData::VideoParameters &videoParameters);
+    const quint16 *getLine(const SourceVideo::Data& sourceField, qint32 fieldLine,
+                           const LdDecodeMetaData::VideoParameters &videoParameters);
+    qint32 manchesterDecoder(const LineView &line, qint32 zcPoint,
+                             const LdDecodeMetaData::VideoParameters &videoParameters);
 };
 
 #endif // VBILINEDECODER_H
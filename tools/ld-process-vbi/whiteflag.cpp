@@ -25,20 +25,20 @@
 #include "whiteflag.h"
 
 // Public method to read the white flag status from a field-line
-bool WhiteFlag::getWhiteFlag(const SourceVideo::Data &lineData, LdDecodeMetaData::VideoParameters videoParameters)
+bool WhiteFlag::getWhiteFlag(const quint16 *lineData, qint32 lineLength, const LdDecodeMetaData::VideoParameters &videoParameters)
 {
     // Determine the 16-bit zero-crossing point
     qint32 zcPoint = videoParameters.white16bIre - videoParameters.black16bIre;
 
+    // The line data covers just the active video area
     qint32 whiteCount = 0;
-    for (qint32 x = videoParameters.activeVideoStart; x < videoParameters.activeVideoEnd; x++) {
+    for (qint32 x = 0; x < lineLength; x++) {
         if (lineData[x] > zcPoint) whiteCount++;
     }
 
     // Mark the line as a white flag if at least 50% of the data is above the zc point
-    if (whiteCount > ((videoParameters.activeVideoEnd - videoParameters.activeVideoStart) / 2)) {
-        qDebug() << "WhiteFlag::getWhiteFlag(): White-flag detected: White count was" << whiteCount << "out of" <<
-                    (videoParameters.activeVideoEnd - videoParameters.activeVideoStart);
+    if (whiteCount > (lineLength / 2)) {
+        qDebug() << "WhiteFlag::getWhiteFlag(): White-flag detected: White count was" << whiteCount << "out of" << lineLength;
         return true;
     }
 
@@ -31,7 +31,7 @@
 class WhiteFlag
 {
 public:
-    bool getWhiteFlag(const SourceVideo::Data &lineData, LdDecodeMetaData::VideoParameters videoParameters);
+    bool getWhiteFlag(const quint16 *lineData, qint32 lineLength, const LdDecodeMetaData::VideoParameters &videoParameters);
 };
 
 #endif // WHITEFLAG_H
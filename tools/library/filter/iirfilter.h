@@ -31,8 +31,15 @@
 #include <array>
 #include <vector>
 
+template <unsigned bOrder, unsigned aOrder, unsigned numChannels>
+class MultiChannelIIRFilter;
+
 // IIR or FIR filter
 // b is feedforward (input), a is feedback (output -- 1 for a FIR filter).
+//
+// The filter is implemented in transposed direct form II, so its state is
+// one array of partial sums, which are each updated once per sample rather
+// than shifting separate input and output histories along.
 template <unsigned bOrder, unsigned aOrder>
 class IIRFilter
 {
@@ -43,7 +50,10 @@ public:
         assert(_a.size() == aOrder);
         assert(_b.size() == bOrder);
 
-        // Normalise the coefficients against a[0]
+        // Normalise the coefficients against a[0], padding the shorter set
+        // with 0s
+        b.fill(0);
+        a.fill(0);
         for (unsigned i = 0; i < aOrder; i++) {
             a[i] = _a[i] / _a[0];
         }
@@ -59,36 +69,140 @@ public:
     // but note that it also copies the history of the filter.
     IIRFilter(const IIRFilter &) = default;
 
+    // Reset the filter's history, as if it had been fed val forever
     void clear(double val = 0) {
-        x.fill(val);
-        y.fill(val);
+        double sum = 0;
+        for (int i = static_cast<int>(ORDER) - 2; i >= 0; i--) {
+            sum += (b[i + 1] - a[i + 1]) * val;
+            z[i] = sum;
+        }
     }
 
     // Feed a new input value into the filter, returning the new output value
     double feed(double val) {
-        double y0 = b[0] * val;
-        for (int i = bOrder - 1; i >= 1; i--) {
-            x[i] = x[i - 1];
-            y0 += b[i] * x[i];
-        }
-        x[0] = val;
-        for (int i = aOrder - 1; i >= 1; i--) {
-            y[i] = y[i - 1];
-            y0 -= a[i] * y[i];
+        return step(val, z.data());
+    }
+
+    // Feed a block of numSamples input values from inputData into the
+    // filter, writing the output values into outputData.
+    // outputData may be the same as inputData.
+    template <typename InputSample, typename OutputSample>
+    void process(const InputSample *inputData, OutputSample *outputData, int numSamples) {
+        // Work on a local copy of the state, so the compiler can keep it
+        // in registers
+        std::array<double, STATE_SIZE> state = z;
+        for (int i = 0; i < numSamples; i++) {
+            outputData[i] = static_cast<OutputSample>(step(static_cast<double>(inputData[i]), state.data()));
         }
-        y[0] = y0;
-        return y[0];
+        z = state;
+    }
+
+    // Feed a container of input values into the filter, writing the output
+    // values into the same container
+    template <typename Container>
+    void process(Container &data) {
+        process(data.data(), data.data(), data.size());
     }
 
 private:
+    template <unsigned b2, unsigned a2, unsigned c2> friend class MultiChannelIIRFilter;
+
+    // Number of coefficients in the longer of the two sets
+    static constexpr unsigned ORDER = (bOrder > aOrder) ? bOrder : aOrder;
+    // Size of the state array (at least 1, to avoid zero-length arrays)
+    static constexpr unsigned STATE_SIZE = (ORDER > 1) ? (ORDER - 1) : 1;
+
+    // Compute one output value, updating state
+    double step(double val, double *state) const {
+        if (ORDER == 1) return b[0] * val;
+
+        const double y0 = (b[0] * val) + state[0];
+        for (unsigned i = 0; i + 2 < ORDER; i++) {
+            state[i] = state[i + 1] + (b[i + 1] * val) - (a[i + 1] * y0);
+        }
+        state[ORDER - 2] = (b[ORDER - 1] * val) - (a[ORDER - 1] * y0);
+        return y0;
+    }
+
     // Feedforward (input) coefficients
-    std::array<double, bOrder> b;
+    std::array<double, ORDER> b;
     // Feedback (output) coefficients
-    std::array<double, aOrder> a;
-    // History of input values
-    std::array<double, bOrder> x;
-    // History of output values
-    std::array<double, aOrder> y;
+    std::array<double, ORDER> a;
+    // Partial sums for future outputs
+    std::array<double, STATE_SIZE> z;
+};
+
+// A set of numChannels identical IIR filters, each with its own state, which
+// can be used to filter several independent signals (e.g. several lines of
+// video, or several audio channels) at once. The channels are processed
+// together, one sample at a time, so the compiler can vectorise across them.
+template <unsigned bOrder, unsigned aOrder, unsigned numChannels>
+class MultiChannelIIRFilter
+{
+public:
+    // Construct a filter using the coefficients of an existing IIRFilter.
+    // Each channel starts with a copy of filter's history.
+    MultiChannelIIRFilter(const IIRFilter<bOrder, aOrder> &filter)
+        : b(filter.b), a(filter.a)
+    {
+        for (unsigned i = 0; i < Filter::STATE_SIZE; i++) {
+            z[i].fill(filter.z[i]);
+        }
+    }
+
+    // Reset all channels' history, as if they had been fed val forever
+    void clear(double val = 0) {
+        double sum = 0;
+        for (int i = static_cast<int>(Filter::ORDER) - 2; i >= 0; i--) {
+            sum += (b[i + 1] - a[i + 1]) * val;
+            z[i].fill(sum);
+        }
+    }
+
+    // Feed numSamples input values for each channel into the filters.
+    // inputData[c] and outputData[c] point to the input and output values for
+    // channel c. The input and output for a channel may be the same.
+    template <typename InputSample, typename OutputSample>
+    void process(const InputSample *const *inputData, OutputSample *const *outputData, int numSamples) {
+        for (int i = 0; i < numSamples; i++) {
+            Channels val, y0;
+            for (unsigned c = 0; c < numChannels; c++) {
+                val[c] = static_cast<double>(inputData[c][i]);
+            }
+
+            if (Filter::ORDER == 1) {
+                for (unsigned c = 0; c < numChannels; c++) {
+                    y0[c] = b[0] * val[c];
+                }
+            } else {
+                for (unsigned c = 0; c < numChannels; c++) {
+                    y0[c] = (b[0] * val[c]) + z[0][c];
+                }
+                for (unsigned j = 0; j + 2 < Filter::ORDER; j++) {
+                    for (unsigned c = 0; c < numChannels; c++) {
+                        z[j][c] = z[j + 1][c] + (b[j + 1] * val[c]) - (a[j + 1] * y0[c]);
+                    }
+                }
+                for (unsigned c = 0; c < numChannels; c++) {
+                    z[Filter::ORDER - 2][c] = (b[Filter::ORDER - 1] * val[c]) - (a[Filter::ORDER - 1] * y0[c]);
+                }
+            }
+
+            for (unsigned c = 0; c < numChannels; c++) {
+                outputData[c][i] = static_cast<OutputSample>(y0[c]);
+            }
+        }
+    }
+
+private:
+    typedef IIRFilter<bOrder, aOrder> Filter;
+    typedef std::array<double, numChannels> Channels;
+
+    // Coefficients, as in IIRFilter
+    std::array<double, Filter::ORDER> b;
+    std::array<double, Filter::ORDER> a;
+    // Partial sums for future outputs, for each channel
+    std::array<Channels, Filter::STATE_SIZE> z;
 };
 
 #endif // IIRFILTER_H
@@ -38,6 +38,7 @@ using std::cerr;
 using std::fill;
 using std::string;
 using std::to_string;
+using std::tuple_size;
 using std::vector;
 
 #include "deemp.h"
@@ -117,32 +118,93 @@ void testIIRFilter(const char *name, FN& fn, FO& fo)
     }
 }
 
-// Test IIRFilter for the sets of coefficients used in the code
-void testIIRFilters()
+// Check that an IIRFilter's block processing matches SimpleFilter, with the
+// input split into two blocks so the state is carried between calls.
+template <typename FN, typename BSrc, typename ASrc>
+void testIIRProcess(const char *name, const FN &proto, const BSrc &b, const ASrc &a)
 {
-    auto f0(f_colorlpi);
-    SimpleFilter g0(c_colorlpi_b, c_colorlpi_a);
-    testIIRFilter("colorlpi", f0, g0);
+    cerr << "Testing IIRFilter::process: " << name << "\n";
+
+    auto fn(proto);
+    SimpleFilter fo(b, a);
+
+    vector<double> data;
+    for (int i = 0; i < 100; ++i) {
+        data.push_back(i - 40);
+    }
+    const vector<double> input = data;
 
-    auto f1(f_colorlpq);
-    SimpleFilter g1(c_colorlpq_b, c_colorlpq_a);
-    testIIRFilter("colorlpq", f1, g1);
+    fn.process(data.data(), data.data(), 37);
+    fn.process(data.data() + 37, data.data() + 37, data.size() - 37);
 
-    auto f2(f_nrc);
-    SimpleFilter g2(c_nrc_b, c_nrc_a);
-    testIIRFilter("nrc", f2, g2);
+    for (unsigned i = 0; i < input.size(); ++i) {
+        double out_o = fo.feed(input[i]);
+        if (fabs(data[i] - out_o) > 0.000001) {
+            cerr << "Mismatch on " << name << " at " << i << ": " << input[i] << " -> " << data[i] << ", " << out_o << "\n";
+            exit(1);
+        }
+    }
+}
 
-    auto f3(f_nr);
-    SimpleFilter g3(c_nr_b, c_nr_a);
-    testIIRFilter("nr", f3, g3);
+// Check that each channel of a MultiChannelIIRFilter matches SimpleFilter,
+// with a different input for each channel.
+template <unsigned bOrder, unsigned aOrder, typename BSrc, typename ASrc>
+void testMultiChannelIIRFilter(const char *name, const IIRFilter<bOrder, aOrder> &proto, const BSrc &b, const ASrc &a)
+{
+    cerr << "Testing MultiChannelIIRFilter: " << name << "\n";
+
+    const unsigned numChannels = 3;
+    MultiChannelIIRFilter<bOrder, aOrder, numChannels> fn(proto);
+
+    vector<double> input[numChannels];
+    vector<int16_t> output[numChannels];
+    const double *inputPtrs[numChannels];
+    int16_t *outputPtrs[numChannels];
+    for (unsigned c = 0; c < numChannels; ++c) {
+        for (int i = 0; i < 100; ++i) {
+            input[c].push_back((i - 40) * static_cast<int>(c + 1));
+        }
+        output[c].resize(input[c].size());
+        inputPtrs[c] = input[c].data();
+        outputPtrs[c] = output[c].data();
+    }
 
-    auto f4(f_a500_48k);
-    SimpleFilter g4(c_a500_48k_b, c_a500_48k_a);
-    testIIRFilter("a500_48k", f4, g4);
+    fn.process(inputPtrs, outputPtrs, 100);
 
-    auto f5(f_a40h_48k);
-    SimpleFilter g5(c_a40h_48k_b, c_a40h_48k_a);
-    testIIRFilter("a40h_48k", f5, g5);
+    for (unsigned c = 0; c < numChannels; ++c) {
+        SimpleFilter fo(b, a);
+        for (unsigned i = 0; i < input[c].size(); ++i) {
+            double out_o = fo.feed(input[c][i]);
+            if (fabs(output[c][i] - out_o) >= 1.000001) {
+                cerr << "Mismatch on " << name << " channel " << c << " at " << i << ": " << input[c][i] << " -> " << output[c][i] << ", " << out_o << "\n";
+                exit(1);
+            }
+        }
+    }
+}
+
+// Test IIRFilter with a set of coefficients
+template <unsigned bOrder, unsigned aOrder, typename BSrc, typename ASrc>
+void testIIRCoeffs(const char *name, const IIRFilter<bOrder, aOrder> &proto, const BSrc &b, const ASrc &a)
+{
+    auto fn(proto);
+    SimpleFilter fo(b, a);
+    testIIRFilter(name, fn, fo);
+
+    testIIRProcess(name, proto, b, a);
+    testMultiChannelIIRFilter(name, proto, b, a);
+}
+
+// Test IIRFilter for the sets of coefficients used in the code
+void testIIRFilters()
+{
+    testIIRCoeffs("colorlpi", f_colorlpi, c_colorlpi_b, c_colorlpi_a);
+    testIIRCoeffs("colorlpq", f_colorlpq, c_colorlpq_b, c_colorlpq_a);
+    testIIRCoeffs("nrc", f_nrc, c_nrc_b, c_nrc_a);
+    testIIRCoeffs("nr", f_nr, c_nr_b, c_nr_a);
+    testIIRCoeffs("a500_48k", f_a500_48k, c_a500_48k_b, c_a500_48k_a);
+    testIIRCoeffs("a40h_48k", f_a40h_48k, c_a40h_48k_b, c_a40h_48k_a);
+    testIIRCoeffs("audioin", f_audioin, c_audioin_b, c_audioin_a);
 }
 
 // Check that FIRFilter's output matches SimpleFilter in FIR mode.
@@ -175,11 +237,13 @@ void testFIRFilter(const string &name, const Input& input, const Output& output,
     }
 }
 
-// Test FIRFilter with a set of coefficients for various types
-template <typename Coeffs>
-void testFIRCoeffs(const string &name, const Coeffs &coeffs)
+// Test a FIR filter with a set of coefficients for various types.
+// epsilon is the tolerance for double output; integer output may be off by
+// one more than this, since the result is truncated.
+template <typename Filter, typename Coeffs>
+void testFIRCoeffs(const string &name, const Filter &f, const Coeffs &coeffs, double epsilon = 0.000001)
 {
-    const auto f = makeFIRFilter(coeffs);
+    const double intEpsilon = 1 + epsilon;
     vector<double> input, output;
 
     // Vectors with lengths from 0 to slightly more than the coefficients size.
@@ -188,11 +252,11 @@ void testFIRCoeffs(const string &name, const Coeffs &coeffs)
 
     for (int i = 0; i < static_cast<int>(coeffs.size()) + 3; i++) {
         f.apply(input, output);
-        testFIRFilter(name + " length " + to_string(i) + " separate", input, output, coeffs);
+        testFIRFilter(name + " length " + to_string(i) + " separate", input, output, coeffs, epsilon);
 
         output = input;
         f.apply(output);
-        testFIRFilter(name + " length " + to_string(i) + " in-place", input, output, coeffs);
+        testFIRFilter(name + " length " + to_string(i) + " in-place", input, output, coeffs, epsilon);
 
         input.push_back(i + 42);
         output.push_back(0);
@@ -208,11 +272,11 @@ void testFIRCoeffs(const string &name, const Coeffs &coeffs)
 
     fill(output.begin(), output.end(), 0);
     f.apply(input, output);
-    testFIRFilter(name + " double separate", input, output, coeffs);
+    testFIRFilter(name + " double separate", input, output, coeffs, epsilon);
 
     output = input;
     f.apply(output);
-    testFIRFilter(name + " double in-place", input, output, coeffs);
+    testFIRFilter(name + " double in-place", input, output, coeffs, epsilon);
 
     // int16_t vectors
 
@@ -224,37 +288,53 @@ void testFIRCoeffs(const string &name, const Coeffs &coeffs)
 
     fill(output16.begin(), output16.end(), 0);
     f.apply(input16, output16);
-    testFIRFilter(name + " int16_t separate", input16, output16, coeffs, 1);
+    testFIRFilter(name + " int16_t separate", input16, output16, coeffs, intEpsilon);
 
     output16 = input16;
     f.apply(output16);
-    testFIRFilter(name + " int16_t in-place", input16, output16, coeffs, 1);
+    testFIRFilter(name + " int16_t in-place", input16, output16, coeffs, intEpsilon);
 
     // Different types for input and output
 
     fill(output16.begin(), output16.end(), 0);
     f.apply(input, output16);
-    testFIRFilter(name + " double->int16_t", input, output16, coeffs, 1);
+    testFIRFilter(name + " double->int16_t", input, output16, coeffs, intEpsilon);
 
     fill(output.begin(), output.end(), 0);
     f.apply(input16, output);
-    testFIRFilter(name + " int16_t->double", input16, output, coeffs);
+    testFIRFilter(name + " int16_t->double", input16, output, coeffs, epsilon);
 }
 
-// Test FIRFilter
+// Test FIRFilter and SymmetricFIRFilter (in both double and float versions)
+// with a set of coefficients
+template <typename Coeffs>
+void testFIRFilterTypes(const string &name, const Coeffs &coeffs)
+{
+    testFIRCoeffs(name, makeFIRFilter(coeffs), coeffs);
+    testFIRCoeffs(name + " symmetric", makeSymmetricFIRFilter(coeffs), coeffs);
+
+    const SymmetricFIRFilter<float, tuple_size<Coeffs>::value> floatFilter(coeffs);
+    testFIRCoeffs(name + " symmetric float", floatFilter, coeffs, 0.0001);
+}
+
+// Test FIR filters
 void testFIRFilters()
 {
     const array<double, 1> one {1};
-    testFIRCoeffs("one", one);
+    testFIRFilterTypes("one", one);
 
     assert(c_nrc_a.size() == 1);
-    testFIRCoeffs("nrc", c_nrc_b);
+    testFIRFilterTypes("nrc", c_nrc_b);
 
     assert(c_nr_a.size() == 1);
-    testFIRCoeffs("nr", c_nr_b);
+    testFIRFilterTypes("nr", c_nr_b);
 
     assert(c_a500_44k_a.size() == 1);
-    testFIRCoeffs("a500_44k", c_a500_44k_b);
+    testFIRFilterTypes("a500_44k", c_a500_44k_b);
+
+    // Coefficients with the number of taps only known at run time
+    const vector<double> nrVector(c_nr_b.begin(), c_nr_b.end());
+    testFIRCoeffs("nr vector", makeFIRFilter(nrVector), nrVector);
 }
 
 int main()
@@ -24,6 +24,9 @@
 
 #include "dropouts.h"
 
+#include <algorithm>
+#include <numeric>
+
 DropOuts::DropOuts(const QVector<qint32> &startx, const QVector<qint32> &endx, const QVector<qint32> &fieldLine)
     : m_startx(startx), m_endx(endx), m_fieldLine(fieldLine)
 {
@@ -37,7 +40,9 @@ DropOuts& DropOuts::operator=(const DropOuts &inDropouts)
         // Copy the object's data
         m_startx = inDropouts.m_startx;
         m_endx = inDropouts.m_endx;
-        m_fieldLine = inDropouts.m_fieldLine;;
+        m_fieldLine = inDropouts.m_fieldLine;
+        m_lineIndex = inDropouts.m_lineIndex;
+        m_isIndexed = inDropouts.m_isIndexed;
     }
 
     return *this;
@@ -49,6 +54,7 @@ void DropOuts::append(const qint32 startx, const qint32 endx, const qint32 field
     m_startx.append(startx);
     m_endx.append(endx);
     m_fieldLine.append(fieldLine);
+    m_isIndexed = false;
 }
 
 // Return the size of the DropOuts record
@@ -63,6 +69,7 @@ void DropOuts::resize(qint32 size)
     m_startx.resize(size);
     m_endx.resize(size);
     m_fieldLine.resize(size);
+    m_isIndexed = false;
 }
 
 // Clear the DropOuts record
@@ -71,6 +78,7 @@ void DropOuts::clear()
     m_startx.clear();
     m_endx.clear();
     m_fieldLine.clear();
+    m_isIndexed = false;
 }
 
 // Return true if the dropouts object is empty
@@ -80,26 +88,33 @@ bool DropOuts::empty() const
 }
 
 // Get methods
-qint32 DropOuts::startx(qint32 index)
+qint32 DropOuts::startx(qint32 index) const
 {
     return m_startx[index];
 }
 
-qint32 DropOuts::endx(qint32 index)
+qint32 DropOuts::endx(qint32 index) const
 {
     return m_endx[index];
 }
 
-qint32 DropOuts::fieldLine(qint32 index)
+qint32 DropOuts::fieldLine(qint32 index) const
 {
     return m_fieldLine[index];
 }
 
+// Sort the dropouts by field line, then by startx, and index them by line so
+// that isDropout and overlaps only need to look at the dropouts on one line
+void DropOuts::sort()
+{
+    sortByLine();
+    buildLineIndex();
+}
+
 // Method to concatenate dropouts on the same line that are close together
 // (to cut down on the amount of generated dropout data when processing noisy/bad sources)
-
-// TODO: Sort the DOs by fieldLine otherwise this won't work correctly unless the
-// caller is aware of the restriction (used in ld-diffdod only at the moment)
+//
+// The dropouts are sorted first (see sort), so they can be given in any order.
 void DropOuts::concatenate()
 {
     qint32 sizeAtStart = m_startx.size();
@@ -110,30 +125,126 @@ void DropOuts::concatenate()
     // concatenated together
     qint32 minimumGap = 50;
 
-    // Start from dropout 1 as 0 has no previous dropout
-    qint32 i = 1;
-
-    while (i < m_startx.size()) {
-        // Is the current dropout on the same frame line as the last?
-        if (m_fieldLine[i - 1] == m_fieldLine[i]) {
-            if ((m_endx[i - 1] + minimumGap) > (m_startx[i])) {
-                // Concatenate
-                m_endx[i - 1] = m_endx[i];
-
-                // Remove the current dropout
-                m_startx.removeAt(i);
-                m_endx.removeAt(i);
-                m_fieldLine.removeAt(i);
-            }
-        }
+    sortByLine();
 
-        // Next dropout
-        i++;
+    // Merge each dropout into the last output dropout if it's on the same
+    // line and close enough; otherwise keep it as a new output dropout
+    qint32 output = 0;
+    for (qint32 i = 1; i < sizeAtStart; i++) {
+        if (m_fieldLine[output] == m_fieldLine[i] && (m_endx[output] + minimumGap) > m_startx[i]) {
+            // Concatenate
+            m_endx[output] = qMax(m_endx[output], m_endx[i]);
+        } else {
+            output++;
+            m_startx[output] = m_startx[i];
+            m_endx[output] = m_endx[i];
+            m_fieldLine[output] = m_fieldLine[i];
+        }
     }
+    if (sizeAtStart > 0) resize(output + 1);
+
+    buildLineIndex();
 
     qDebug() << "Concatenated dropouts: was" << sizeAtStart << "now" << m_startx.size() << "dropouts";
 }
 
+// Return true if the specified position is within a dropout (the field line
+// numbering is the same as in the dropout data)
+bool DropOuts::isDropout(qint32 fieldLine, qint32 x) const
+{
+    return overlaps(fieldLine, x, x);
+}
+
+// Return true if any dropout on the specified field line overlaps the range
+// x0 to x1 (inclusive, as with startx/endx)
+//
+// If the dropouts have been sorted, this only examines the dropouts on the
+// specified line; otherwise it has to check all of them.
+bool DropOuts::overlaps(qint32 fieldLine, qint32 x0, qint32 x1) const
+{
+    qint32 first = 0;
+    qint32 last = m_startx.size();
+
+    if (m_isIndexed) {
+        if (fieldLine < 0 || fieldLine >= m_lineIndex.size() - 1) return false;
+        first = m_lineIndex[fieldLine];
+        last = m_lineIndex[fieldLine + 1];
+    }
+
+    for (qint32 i = first; i < last; i++) {
+        if (m_fieldLine[i] != fieldLine) continue;
+
+        if (m_startx[i] > x1) {
+            // When sorted, no later dropout on this line can overlap
+            if (m_isIndexed) break;
+            continue;
+        }
+
+        if (m_endx[i] >= x0) return true;
+    }
+
+    return false;
+}
+
+// Sort the dropouts by field line, then by startx
+void DropOuts::sortByLine()
+{
+    const qint32 count = m_startx.size();
+
+    // Sort a list of indexes, then rearrange the vectors to match
+    QVector<qint32> order(count);
+    std::iota(order.begin(), order.end(), 0);
+
+    auto lessThan = [&](qint32 a, qint32 b) {
+        if (m_fieldLine[a] != m_fieldLine[b]) return m_fieldLine[a] < m_fieldLine[b];
+        return m_startx[a] < m_startx[b];
+    };
+
+    // Dropouts are usually generated in order, so avoid rearranging if possible
+    if (std::is_sorted(order.begin(), order.end(), lessThan)) return;
+    std::stable_sort(order.begin(), order.end(), lessThan);
+
+    QVector<qint32> startx(count), endx(count), fieldLine(count);
+    for (qint32 i = 0; i < count; i++) {
+        startx[i] = m_startx[order[i]];
+        endx[i] = m_endx[order[i]];
+        fieldLine[i] = m_fieldLine[order[i]];
+    }
+
+    m_startx.swap(startx);
+    m_endx.swap(endx);
+    m_fieldLine.swap(fieldLine);
+}
+
+// Build the index of the first dropout on each line (the dropouts must
+// already be sorted by line)
+void DropOuts::buildLineIndex()
+{
+    const qint32 count = m_startx.size();
+    m_lineIndex.clear();
+    m_isIndexed = false;
+
+    if (count == 0) {
+        m_isIndexed = true;
+        return;
+    }
+
+    // Lines should never be negative, but if they are, leave the dropouts
+    // unindexed rather than giving wrong answers
+    if (m_fieldLine.first() < 0) return;
+
+    // m_lineIndex[line] is the index of the first dropout on that line or later
+    const qint32 maxLine = m_fieldLine.last();
+    m_lineIndex.resize(maxLine + 2);
+    qint32 i = 0;
+    for (qint32 line = 0; line <= maxLine + 1; line++) {
+        while (i < count && m_fieldLine[i] < line) i++;
+        m_lineIndex[line] = i;
+    }
+
+    m_isIndexed = true;
+}
+
 // Custom debug streaming operator
 QDebug operator<<(QDebug dbg, DropOuts &dropOuts)
 {
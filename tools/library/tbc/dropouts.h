@@ -28,6 +28,7 @@
 #include <QDebug>
 #include <QtGlobal>
 #include <QMetaType>
+#include <QVector>
 
 class DropOuts
 {
@@ -43,17 +44,29 @@ public:
     qint32 size() const;
     void resize(qint32 size);
     void clear();
+    void sort();
     void concatenate();
     bool empty() const;
 
-    qint32 startx(qint32 index);
-    qint32 endx(qint32 index);
-    qint32 fieldLine(qint32 index);
+    qint32 startx(qint32 index) const;
+    qint32 endx(qint32 index) const;
+    qint32 fieldLine(qint32 index) const;
+
+    bool isDropout(qint32 fieldLine, qint32 x) const;
+    bool overlaps(qint32 fieldLine, qint32 x0, qint32 x1) const;
 
 private:
     QVector<qint32> m_startx;
     QVector<qint32> m_endx;
     QVector<qint32> m_fieldLine;
+
+    // Index of the first dropout on each field line (valid only when the
+    // dropouts are sorted; see sort)
+    QVector<qint32> m_lineIndex;
+    bool m_isIndexed = false;
+
+    void sortByLine();
+    void buildLineIndex();
 };
 
 #endif // DROPOUTS_H
@@ -36,7 +36,7 @@ static constexpr std::array<double, 5> palLumaFilterCoeffs {
     0.03283437,  0.23959832,  0.45513461,  0.23959832,  0.03283437
 };
 
-static constexpr auto palLumaFilter = makeFIRFilter(palLumaFilterCoeffs);
+static constexpr auto palLumaFilter = makeSymmetricFIRFilter(palLumaFilterCoeffs);
 
 // NTSC - Filter at Fsc/2 (Fsc = 3579545 (/2 = 1,789,772.5), sample rate = 14,318,180)
 // 1.8 MHz LPF - 5 Taps
@@ -45,7 +45,7 @@ static constexpr auto palLumaFilter = makeFIRFilter(palLumaFilterCoeffs);
 static constexpr std::array<double, 5> ntscLumaFilterCoeffs {
     0.03275786,  0.23955702,  0.45537024,  0.23955702,  0.03275786
 };
-static constexpr auto ntscLumaFilter = makeFIRFilter(ntscLumaFilterCoeffs);
+static constexpr auto ntscLumaFilter = makeSymmetricFIRFilter(ntscLumaFilterCoeffs);
 
 // Public methods ----------------------------------------------------------------------------------------------------
 
@@ -54,14 +54,7 @@ static constexpr auto ntscLumaFilter = makeFIRFilter(ntscLumaFilterCoeffs);
 // the same array
 void Filters::palLumaFirFilter(quint16 *data, qint32 dataPoints)
 {
-    // Filter into a temporary buffer
-    QVector<quint16> tmp(dataPoints);
-    palLumaFilter.apply(data, tmp.data(), dataPoints);
-
-    // Copy the result over the original array
-    for (qint32 i = 0; i < dataPoints; i++) {
-        data[i] = tmp[i];
-    }
+    palLumaFilter.apply(data, data, dataPoints);
 }
 
 // Apply a FIR filter to remove PAL chroma leaving just luma
@@ -72,19 +65,29 @@ void Filters::palLumaFirFilter(QVector<qint32> &data)
     palLumaFilter.apply(data);
 }
 
+// Apply a FIR filter to remove PAL chroma leaving just luma
+// Accepts quint16 greyscale data and returns the filtered data into
+// outputData, which must be at least dataPoints long
+void Filters::palLumaFirFilter(const quint16 *inputData, quint16 *outputData, qint32 dataPoints)
+{
+    palLumaFilter.apply(inputData, outputData, dataPoints);
+}
+
+// Apply a FIR filter to remove PAL chroma leaving just luma
+// Accepts qint32 greyscale data and returns the filtered data into
+// outputData, which is resized to match
+void Filters::palLumaFirFilter(const QVector<qint32> &inputData, QVector<qint32> &outputData)
+{
+    outputData.resize(inputData.size());
+    palLumaFilter.apply(inputData, outputData);
+}
+
 // Apply a FIR filter to remove NTSC chroma leaving just luma
 // Accepts quint16 greyscale data and returns the filtered data into
 // the same array
 void Filters::ntscLumaFirFilter(quint16 *data, qint32 dataPoints)
 {
-    // Filter into a temporary buffer
-    QVector<quint16> tmp(dataPoints);
-    ntscLumaFilter.apply(data, tmp.data(), dataPoints);
-
-    // Copy the result over the original array
-    for (qint32 i = 0; i < dataPoints; i++) {
-        data[i] = tmp[i];
-    }
+    ntscLumaFilter.apply(data, data, dataPoints);
 }
 
 // Apply a FIR filter to remove NTSC chroma leaving just luma
@@ -94,3 +97,20 @@ void Filters::ntscLumaFirFilter(QVector<qint32> &data)
 {
     ntscLumaFilter.apply(data);
 }
+
+// Apply a FIR filter to remove NTSC chroma leaving just luma
+// Accepts quint16 greyscale data and returns the filtered data into
+// outputData, which must be at least dataPoints long
+void Filters::ntscLumaFirFilter(const quint16 *inputData, quint16 *outputData, qint32 dataPoints)
+{
+    ntscLumaFilter.apply(inputData, outputData, dataPoints);
+}
+
+// Apply a FIR filter to remove NTSC chroma leaving just luma
+// Accepts qint32 greyscale data and returns the filtered data into
+// outputData, which is resized to match
+void Filters::ntscLumaFirFilter(const QVector<qint32> &inputData, QVector<qint32> &outputData)
+{
+    outputData.resize(inputData.size());
+    ntscLumaFilter.apply(inputData, outputData);
+}
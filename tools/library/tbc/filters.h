@@ -31,11 +31,21 @@
 class Filters
 {
 public:
+    // In-place filters (these don't allocate any memory)
     void palLumaFirFilter(quint16 *data, qint32 dataPoints);
     void palLumaFirFilter(QVector<qint32> &data);
 
     void ntscLumaFirFilter(quint16 *data, qint32 dataPoints);
     void ntscLumaFirFilter(QVector<qint32> &data);
+
+    // Filters from one buffer into another, which the caller can reuse between calls.
+    // The input is filtered as a single run of samples, so a whole field can be
+    // filtered in one call rather than line by line.
+    void palLumaFirFilter(const quint16 *inputData, quint16 *outputData, qint32 dataPoints);
+    void palLumaFirFilter(const QVector<qint32> &inputData, QVector<qint32> &outputData);
+
+    void ntscLumaFirFilter(const quint16 *inputData, quint16 *outputData, qint32 dataPoints);
+    void ntscLumaFirFilter(const QVector<qint32> &inputData, QVector<qint32> &outputData);
 };
 
 #endif // FILTERS_H
@@ -0,0 +1,400 @@
+/************************************************************************
+
+    jsonreader.cpp
+
+    ld-decode-tools TBC library
+    Copyright (C) 2026 agent
+
+    This file is part of ld-decode-tools.
+
+    ld-decode-tools is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+************************************************************************/
+
+#include "jsonreader.h"
+
+#include <cmath>
+#include <limits>
+
+// Amount of input to read at a time
+static constexpr qint64 BUFFER_SIZE = 1024 * 1024;
+
+JsonReader::JsonReader(QIODevice &_input)
+    : input(_input), bufferPos(0), inputPos(0), rawOutput(nullptr)
+{
+}
+
+void JsonReader::read(qint32 &value)
+{
+    qint64 value64;
+    read(value64);
+    value = static_cast<qint32>(value64);
+}
+
+void JsonReader::read(qint64 &value)
+{
+    value = 0;
+    if (!readNumberToken()) return;
+
+    // Most integers are written without a fractional part or exponent, but
+    // some writers (e.g. Python with numpy values) produce "123.0"
+    bool ok;
+    if (token.contains('.') || token.contains('e') || token.contains('E')) {
+        double doubleValue = token.toDouble(&ok);
+        if (ok && std::isfinite(doubleValue)) value = static_cast<qint64>(std::llround(doubleValue));
+    } else {
+        value = token.toLongLong(&ok);
+    }
+
+    if (!ok) setError("invalid integer " + QString::fromLatin1(token));
+}
+
+void JsonReader::read(double &value)
+{
+    value = 0;
+
+    // Python's json module writes non-finite values as bare words
+    skipWhitespace();
+    switch (peek()) {
+    case 'N':
+        if (readLiteral("NaN")) value = std::numeric_limits<double>::quiet_NaN();
+        return;
+    case 'I':
+        if (readLiteral("Infinity")) value = std::numeric_limits<double>::infinity();
+        return;
+    default:
+        break;
+    }
+
+    if (!readNumberToken()) return;
+
+    if (token == "-Infinity") {
+        value = -std::numeric_limits<double>::infinity();
+        return;
+    }
+
+    // Note: QByteArray::toDouble isn't affected by the C locale
+    bool ok;
+    value = token.toDouble(&ok);
+    if (!ok) setError("invalid number " + QString::fromLatin1(token));
+}
+
+void JsonReader::read(bool &value)
+{
+    value = false;
+
+    skipWhitespace();
+    switch (peek()) {
+    case 't':
+        if (readLiteral("true")) value = true;
+        break;
+    case 'f':
+        readLiteral("false");
+        break;
+    case 'n':
+        readLiteral("null");
+        break;
+    default:
+        setError("expected true or false");
+        break;
+    }
+}
+
+void JsonReader::read(QString &value)
+{
+    value.clear();
+
+    skipWhitespace();
+    if (peek() == 'n') {
+        readLiteral("null");
+        return;
+    }
+
+    readStringToken(token);
+    value = QString::fromUtf8(token);
+}
+
+void JsonReader::discard()
+{
+    skipWhitespace();
+    switch (peek()) {
+    case '{': {
+        beginObject();
+        QByteArray name;
+        while (readMember(name)) discard();
+        break;
+    }
+    case '[':
+        beginArray();
+        while (readElement()) discard();
+        break;
+    case '"':
+        readStringToken(token);
+        break;
+    case 't':
+    case 'f': {
+        bool boolValue;
+        read(boolValue);
+        break;
+    }
+    default: {
+        // Numbers, null and the non-finite words
+        double doubleValue;
+        read(doubleValue);
+        break;
+    }
+    }
+}
+
+void JsonReader::readRaw(QByteArray &json)
+{
+    json.resize(0);
+
+    // Record the characters that discard consumes
+    skipWhitespace();
+    rawOutput = &json;
+    discard();
+    rawOutput = nullptr;
+
+    if (hasError()) json.resize(0);
+}
+
+void JsonReader::beginObject()
+{
+    if (expect('{')) firstItem.append(true);
+}
+
+bool JsonReader::readMember(QByteArray &name)
+{
+    if (hasError() || firstItem.isEmpty()) return false;
+
+    skipWhitespace();
+    if (peek() == '}') {
+        get();
+        firstItem.removeLast();
+        return false;
+    }
+
+    if (firstItem.last()) firstItem.last() = false;
+    else if (!expect(',')) return false;
+
+    skipWhitespace();
+    readStringToken(name);
+    if (!expect(':')) return false;
+
+    return !hasError();
+}
+
+void JsonReader::beginArray()
+{
+    if (expect('[')) firstItem.append(true);
+}
+
+bool JsonReader::readElement()
+{
+    if (hasError() || firstItem.isEmpty()) return false;
+
+    skipWhitespace();
+    if (peek() == ']') {
+        get();
+        firstItem.removeLast();
+        return false;
+    }
+
+    if (firstItem.last()) firstItem.last() = false;
+    else if (!expect(',')) return false;
+
+    return !hasError();
+}
+
+bool JsonReader::hasError() const
+{
+    return !error.isEmpty();
+}
+
+QString JsonReader::errorMessage() const
+{
+    return error;
+}
+
+// Return the next character of input without consuming it, or -1 at the end
+// of the input (or after an error)
+qint32 JsonReader::peek()
+{
+    if (bufferPos == buffer.size() && !fillBuffer()) return -1;
+    return static_cast<quint8>(buffer[bufferPos]);
+}
+
+// Return and consume the next character of input, or -1 at the end
+qint32 JsonReader::get()
+{
+    qint32 c = peek();
+    if (c != -1) {
+        bufferPos++;
+        if (rawOutput != nullptr) rawOutput->append(static_cast<char>(c));
+    }
+    return c;
+}
+
+// Read the next block of input into the buffer
+bool JsonReader::fillBuffer()
+{
+    if (hasError()) return false;
+
+    inputPos += buffer.size();
+    buffer = input.read(BUFFER_SIZE);
+    bufferPos = 0;
+
+    return !buffer.isEmpty();
+}
+
+void JsonReader::skipWhitespace()
+{
+    while (true) {
+        qint32 c = peek();
+        if (c != ' ' && c != '\t' && c != '\n' && c != '\r') break;
+        get();
+    }
+}
+
+// Consume the given character, which must be next after any whitespace
+bool JsonReader::expect(char c)
+{
+    skipWhitespace();
+    if (get() != c) {
+        setError(QString("expected '%1'").arg(c));
+        return false;
+    }
+
+    return true;
+}
+
+// Record an error, if one hasn't been recorded already
+void JsonReader::setError(const QString &message)
+{
+    if (hasError()) return;
+
+    error = QString("%1 at byte %2").arg(message).arg(inputPos + bufferPos);
+
+    // Stop reading any more input
+    buffer.clear();
+    bufferPos = 0;
+}
+
+// Read a number into token. Returns false (and sets the value to 0) if the
+// value was null instead.
+bool JsonReader::readNumberToken()
+{
+    token.resize(0);
+
+    skipWhitespace();
+    if (peek() == 'n') {
+        readLiteral("null");
+        return false;
+    }
+
+    while (true) {
+        qint32 c = peek();
+        if (!((c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E')) break;
+        token.append(static_cast<char>(get()));
+    }
+
+    // Allow -Infinity; the caller will deal with it
+    if (token == "-" && peek() == 'I') {
+        if (readLiteral("Infinity")) token = "-Infinity";
+        return !hasError();
+    }
+
+    if (token.isEmpty()) {
+        setError("expected a number");
+        return false;
+    }
+
+    return !hasError();
+}
+
+// Read a quoted string into value, decoding escape sequences into UTF-8
+void JsonReader::readStringToken(QByteArray &value)
+{
+    value.resize(0);
+    if (!expect('"')) return;
+
+    while (true) {
+        qint32 c = get();
+        if (c == -1) {
+            setError("unterminated string");
+            return;
+        } else if (c == '"') {
+            return;
+        } else if (c != '\\') {
+            value.append(static_cast<char>(c));
+            continue;
+        }
+
+        // Escape sequence
+        c = get();
+        switch (c) {
+        case '"':
+        case '\\':
+        case '/':
+            value.append(static_cast<char>(c));
+            break;
+        case 'b':
+            value.append('\b');
+            break;
+        case 'f':
+            value.append('\f');
+            break;
+        case 'n':
+            value.append('\n');
+            break;
+        case 'r':
+            value.append('\r');
+            break;
+        case 't':
+            value.append('\t');
+            break;
+        case 'u': {
+            QByteArray hex;
+            for (qint32 i = 0; i < 4; i++) hex.append(static_cast<char>(get()));
+            bool ok;
+            ushort codeUnit = hex.toUShort(&ok, 16);
+            if (!ok) {
+                setError("invalid \\u escape in string");
+                return;
+            }
+
+            // Note: Surrogate pairs aren't combined; metadata doesn't contain them
+            value.append(QString(QChar(codeUnit)).toUtf8());
+            break;
+        }
+        default:
+            setError("invalid escape in string");
+            return;
+        }
+    }
+}
+
+// Consume the given literal word, which must be next
+bool JsonReader::readLiteral(const char *literal)
+{
+    for (const char *p = literal; *p != '\0'; p++) {
+        if (get() != *p) {
+            setError(QString("expected %1").arg(literal));
+            return false;
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,110 @@
+/************************************************************************
+
+    jsonreader.h
+
+    ld-decode-tools TBC library
+    Copyright (C) 2026 agent
+
+    This file is part of ld-decode-tools.
+
+    ld-decode-tools is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+************************************************************************/
+
+#ifndef JSONREADER_H
+#define JSONREADER_H
+
+#include <QByteArray>
+#include <QIODevice>
+#include <QString>
+#include <QVector>
+
+// A streaming reader for JSON documents.
+//
+// Rather than building a tree representing the whole document, this reads
+// values one at a time from the input as the caller asks for them, so the
+// caller can decode the document straight into its own data structures.
+// For example, to read an object:
+//
+//     reader.beginObject();
+//     QByteArray member;
+//     while (reader.readMember(member)) {
+//         if (member == "count") reader.read(count);
+//         else reader.discard();
+//     }
+//
+// If the input isn't valid JSON (or doesn't have the structure the caller
+// expects), the reader records the first error and all further reads fail
+// harmlessly, so the caller only needs to check hasError() at the end.
+class JsonReader
+{
+public:
+    JsonReader(QIODevice &_input);
+
+    // Read a value of the given type. null is read as 0/false/empty, and
+    // numbers with a fractional part are rounded when read as integers.
+    void read(qint32 &value);
+    void read(qint64 &value);
+    void read(double &value);
+    void read(bool &value);
+    void read(QString &value);
+
+    // Skip over a value of any type
+    void discard();
+
+    // Read a value of any type as JSON text, without decoding it (so it can
+    // be written out again unchanged with JsonWriter::writeRaw)
+    void readRaw(QByteArray &json);
+
+    // Read an object. Call beginObject, then call readMember until it returns
+    // false; each time it returns true, read the member's value.
+    void beginObject();
+    bool readMember(QByteArray &name);
+
+    // Read an array. Call beginArray, then call readElement until it returns
+    // false; each time it returns true, read the element's value.
+    void beginArray();
+    bool readElement();
+
+    bool hasError() const;
+    QString errorMessage() const;
+
+private:
+    QIODevice &input;
+    QByteArray buffer;
+    qint32 bufferPos;
+    qint64 inputPos;
+
+    // For each object/array being read, whether we're still on the first item
+    QVector<bool> firstItem;
+
+    QByteArray token;
+    QString error;
+
+    // If not null, characters consumed from the input are appended to this
+    QByteArray *rawOutput;
+
+    qint32 peek();
+    qint32 get();
+    bool fillBuffer();
+    void skipWhitespace();
+    bool expect(char c);
+    void setError(const QString &message);
+
+    bool readNumberToken();
+    void readStringToken(QByteArray &value);
+    bool readLiteral(const char *literal);
+};
+
+#endif // JSONREADER_H
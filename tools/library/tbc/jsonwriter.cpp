@@ -0,0 +1,175 @@
+/************************************************************************
+
+    jsonwriter.cpp
+
+    ld-decode-tools TBC library
+    Copyright (C) 2026 agent
+
+    This file is part of ld-decode-tools.
+
+    ld-decode-tools is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+************************************************************************/
+
+#include "jsonwriter.h"
+
+#include <cmath>
+#include <QLocale>
+
+JsonWriter::JsonWriter(QByteArray &_output)
+    : output(_output), afterMember(false)
+{
+    // Values written at the top level are treated as a sequence
+    firstItem.append(true);
+}
+
+void JsonWriter::write(qint32 value)
+{
+    beginValue();
+    output.append(QByteArray::number(value));
+}
+
+void JsonWriter::write(qint64 value)
+{
+    beginValue();
+    output.append(QByteArray::number(value));
+}
+
+void JsonWriter::write(double value)
+{
+    beginValue();
+
+    if (std::isnan(value)) {
+        output.append("NaN");
+    } else if (std::isinf(value)) {
+        output.append(value > 0 ? "Infinity" : "-Infinity");
+    } else {
+        // Use the shortest representation that reads back as the same value
+        output.append(QByteArray::number(value, 'g', QLocale::FloatingPointShortest));
+    }
+}
+
+void JsonWriter::write(bool value)
+{
+    beginValue();
+    output.append(value ? "true" : "false");
+}
+
+void JsonWriter::write(const QString &value)
+{
+    beginValue();
+    output.append('"');
+
+    const QByteArray utf8 = value.toUtf8();
+    for (char c: utf8) {
+        switch (c) {
+        case '"':
+            output.append("\\\"");
+            break;
+        case '\\':
+            output.append("\\\\");
+            break;
+        case '\b':
+            output.append("\\b");
+            break;
+        case '\f':
+            output.append("\\f");
+            break;
+        case '\n':
+            output.append("\\n");
+            break;
+        case '\r':
+            output.append("\\r");
+            break;
+        case '\t':
+            output.append("\\t");
+            break;
+        default:
+            if (static_cast<quint8>(c) < 0x20) {
+                output.append(QString("\\u%1").arg(static_cast<qint32>(static_cast<quint8>(c)), 4, 16, QChar('0')).toLatin1());
+            } else {
+                output.append(c);
+            }
+            break;
+        }
+    }
+
+    output.append('"');
+}
+
+void JsonWriter::beginObject()
+{
+    beginValue();
+    output.append('{');
+    firstItem.append(true);
+}
+
+void JsonWriter::writeMember(const char *name)
+{
+    if (firstItem.last()) firstItem.last() = false;
+    else output.append(',');
+
+    output.append('"');
+    output.append(name);
+    output.append("\":");
+    afterMember = true;
+}
+
+void JsonWriter::endObject()
+{
+    output.append('}');
+    firstItem.removeLast();
+}
+
+void JsonWriter::beginArray()
+{
+    beginValue();
+    output.append('[');
+    firstItem.append(true);
+}
+
+void JsonWriter::endArray()
+{
+    output.append(']');
+    firstItem.removeLast();
+}
+
+void JsonWriter::writeRaw(const QByteArray &json)
+{
+    beginValue();
+    output.append(json);
+}
+
+void JsonWriter::writeRawMembers(const QByteArray &members)
+{
+    if (members.isEmpty()) return;
+
+    if (firstItem.last()) firstItem.last() = false;
+    else output.append(',');
+
+    output.append(members);
+}
+
+// Write the separator needed before a value, if any
+void JsonWriter::beginValue()
+{
+    if (afterMember) {
+        // This is a member's value
+        afterMember = false;
+    } else {
+        // This is an array element (or a top-level value)
+        if (firstItem.last()) firstItem.last() = false;
+        else output.append(',');
+    }
+}
@@ -0,0 +1,93 @@
+/************************************************************************
+
+    jsonwriter.h
+
+    ld-decode-tools TBC library
+    Copyright (C) 2026 agent
+
+    This file is part of ld-decode-tools.
+
+    ld-decode-tools is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+************************************************************************/
+
+#ifndef JSONWRITER_H
+#define JSONWRITER_H
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+
+// A streaming writer for JSON documents.
+//
+// This is the counterpart to JsonReader: rather than building a tree
+// representing the whole document, the caller writes values one at a time,
+// and the writer appends them to a byte array. Separators between members
+// and elements are inserted automatically. For example:
+//
+//     writer.beginObject();
+//     writer.writeMember("count");
+//     writer.write(count);
+//     writer.endObject();
+//
+// The output is compact (no whitespace). Non-finite numbers are written as
+// NaN/Infinity/-Infinity, as Python's json module does.
+//
+// Several values written at the top level are separated by commas, like the
+// elements of an array. This allows a long array to be rendered in pieces by
+// separate writers, and the pieces inserted into the document with writeRaw.
+class JsonWriter
+{
+public:
+    JsonWriter(QByteArray &_output);
+
+    // Write a value of the given type
+    void write(qint32 value);
+    void write(qint64 value);
+    void write(double value);
+    void write(bool value);
+    void write(const QString &value);
+
+    // Write an object. Call beginObject, then for each member call
+    // writeMember followed by a write of the member's value, then endObject.
+    void beginObject();
+    void writeMember(const char *name);
+    void endObject();
+
+    // Write an array. Call beginArray, then write each element, then endArray.
+    void beginArray();
+    void endArray();
+
+    // Write text that is already valid JSON as the next value (or a sequence
+    // of values rendered by another writer)
+    void writeRaw(const QByteArray &json);
+
+    // Write members of the current object that are already valid JSON, in
+    // the form "name":value,"name":value (which may be empty)
+    void writeRawMembers(const QByteArray &members);
+
+private:
+    QByteArray &output;
+
+    // For the top level and each object/array being written, whether we're
+    // still on the first item
+    QVector<bool> firstItem;
+
+    // Whether a member name has just been written
+    bool afterMember;
+
+    void beginValue();
+};
+
+#endif // JSONWRITER_H
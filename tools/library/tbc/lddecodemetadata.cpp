@@ -23,28 +23,63 @@
 ************************************************************************/
 
 #include "lddecodemetadata.h"
+#include "jsonreader.h"
+#include "jsonwriter.h"
+
+#include <QBuffer>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QThread>
+
+#include <algorithm>
+#include <cstring>
 
 LdDecodeMetaData::LdDecodeMetaData()
 {
     // Set defaults
+    isVideoParametersValid = false;
+    isPcmAudioParametersValid = false;
     isFirstFieldFirst = false;
+    isFrameVbiValid = false;
+    isSeekIndexValid = false;
 }
 
 // This method opens the JSON metadata file and reads the content into the
 // metadata structure read for use
+//
+// If a valid sidecar index file exists alongside the JSON file, the metadata
+// is read from that instead (which is much faster). Sidecars are written by
+// write(), so tools that only read the metadata never create files.
+//
+// While ld-decode is running, it writes its metadata to a journal file rather
+// than the JSON file (which is only written at the end). If the JSON file does
+// not exist but the journal does, or a journal is given explicitly, the
+// journal is read instead.
 bool LdDecodeMetaData::read(QString fileName)
 {
-    // Open the JSON file
-    qDebug() << "LdDecodeMetaData::read(): Loading JSON file" << fileName;
-    if (!json.loadFile(fileName)) {
-        qCritical() << "JSON wax library error:" << json.errorMsg();
-        qCritical("Opening JSON file failed: JSON file cannot be opened/does not exist");
-
-        return false;
-    }
+    QString journalFileName = getJournalFileName(fileName);
 
     // Default to the standard still-frame field order (of first field first)
     isFirstFieldFirst = true;
+    invalidateFrameVbi();
+
+    if (fileName.endsWith(".jsonl") || (!QFileInfo::exists(fileName) && QFileInfo::exists(journalFileName))) {
+        qDebug() << "LdDecodeMetaData::read(): Loading journal file" << journalFileName;
+        if (!readJournal(journalFileName)) {
+            qCritical("Opening JSON journal file failed");
+            return false;
+        }
+    } else if (readSidecar(fileName)) {
+        qDebug() << "LdDecodeMetaData::read(): Loaded metadata from sidecar index for" << fileName;
+    } else {
+        // Open the JSON file
+        qDebug() << "LdDecodeMetaData::read(): Loading JSON file" << fileName;
+        if (!readJson(fileName)) {
+            qCritical("Opening JSON file failed: JSON file cannot be opened/does not exist");
+            return false;
+        }
+    }
 
     return true;
 }
@@ -54,44 +89,1038 @@ bool LdDecodeMetaData::write(QString fileName)
 {
     // Write the JSON object
     qDebug() << "LdDecodeMetaData::write(): Writing JSON metadata to:" << fileName;
-    if (!json.saveAs(fileName, JsonWax::Compact)) {
+    if (!writeJson(fileName)) {
         qCritical("Writing JSON metadata file failed!");
         return false;
     }
 
+    // Update the sidecar index to match the new JSON file (this is optional,
+    // so failure is not an error)
+    if (!writeSidecar(fileName)) {
+        qWarning() << "Could not write the sidecar index for" << fileName << "- reading it will be slower";
+    }
+
     return true;
 }
 
-// This method returns the videoParameters metadata
-LdDecodeMetaData::VideoParameters LdDecodeMetaData::getVideoParameters()
+// Read the value of an object member that the tools don't use, appending it
+// to otherMembers (see lddecodemetadata.h)
+static void readOtherMember(JsonReader &reader, const QByteArray &name, QByteArray &otherMembers)
+{
+    if (!otherMembers.isEmpty()) otherMembers.append(',');
+
+    JsonWriter writer(otherMembers);
+    writer.write(QString::fromUtf8(name));
+    otherMembers.append(':');
+
+    QByteArray value;
+    reader.readRaw(value);
+    otherMembers.append(value);
+}
+
+// Read the metadata from a JSON file into the metadata structure
+//
+// The JSON is decoded as it's read, directly into the typed structures, so
+// there's no intermediate representation of the whole document in memory.
+bool LdDecodeMetaData::readJson(QString fileName)
+{
+    QFile jsonFile(fileName);
+    if (!jsonFile.open(QIODevice::ReadOnly)) {
+        qCritical() << "LdDecodeMetaData::readJson(): Cannot open" << fileName;
+        return false;
+    }
+
+    // Not every writer includes all of the parameters (e.g. ld-decode doesn't
+    // write isSubcarrierLocked or isMapped), so missing ones are 0/false
+    isVideoParametersValid = false;
+    isPcmAudioParametersValid = false;
+    metaData.videoParameters = VideoParameters();
+    metaData.pcmAudioParameters = PcmAudioParameters();
+    metaData.fields.clear();
+    metaData.otherMembers.clear();
+
+    JsonReader reader(jsonFile);
+    QByteArray member;
+
+    reader.beginObject();
+    while (reader.readMember(member)) {
+        if (member == "videoParameters") readVideoParameters(reader, metaData.videoParameters, isVideoParametersValid);
+        else if (member == "pcmAudioParameters") readPcmAudioParameters(reader, metaData.pcmAudioParameters, isPcmAudioParametersValid);
+        else if (member == "fields") readFields(reader, metaData.fields);
+        else readOtherMember(reader, member, metaData.otherMembers);
+    }
+
+    if (reader.hasError()) {
+        qCritical() << "LdDecodeMetaData::readJson(): JSON file is invalid:" << reader.errorMessage();
+        metaData.fields.clear();
+        return false;
+    }
+
+    return true;
+}
+
+// Get the journal file name for a JSON file name
+QString LdDecodeMetaData::getJournalFileName(QString fileName)
+{
+    if (fileName.endsWith(".json")) return fileName + "l";
+    return fileName;
+}
+
+// Read the metadata from an ld-decode journal file
+//
+// The journal is a sequence of JSON objects, one per line. Each may contain
+// "videoParameters" and "pcmAudioParameters" objects (which update the values
+// given by earlier lines), and/or a "field" object (which is appended to the
+// fields). If the journal is still being written, the last line may be
+// incomplete; it's ignored.
+bool LdDecodeMetaData::readJournal(QString fileName)
+{
+    QFile journalFile(fileName);
+    if (!journalFile.open(QIODevice::ReadOnly)) {
+        qCritical() << "LdDecodeMetaData::readJournal(): Cannot open" << fileName;
+        return false;
+    }
+
+    isVideoParametersValid = false;
+    isPcmAudioParametersValid = false;
+    metaData.videoParameters = VideoParameters();
+    metaData.pcmAudioParameters = PcmAudioParameters();
+    metaData.fields.clear();
+    metaData.otherMembers.clear();
+
+    QByteArray member;
+    qint32 lineNumber = 0;
+    while (!journalFile.atEnd()) {
+        QByteArray line = journalFile.readLine();
+        lineNumber++;
+
+        if (!line.endsWith('\n')) {
+            qWarning() << "LdDecodeMetaData::readJournal(): Ignoring incomplete line" << lineNumber << "at the end of the journal";
+            break;
+        }
+
+        QBuffer lineBuffer(&line);
+        lineBuffer.open(QIODevice::ReadOnly);
+        JsonReader reader(lineBuffer);
+
+        reader.beginObject();
+        while (reader.readMember(member)) {
+            if (member == "videoParameters") readVideoParameters(reader, metaData.videoParameters, isVideoParametersValid);
+            else if (member == "pcmAudioParameters") readPcmAudioParameters(reader, metaData.pcmAudioParameters, isPcmAudioParametersValid);
+            else if (member == "field") {
+                metaData.fields.append(Field());
+                readField(reader, metaData.fields.last());
+            } else {
+                reader.discard();
+            }
+        }
+
+        if (reader.hasError()) {
+            qCritical() << "LdDecodeMetaData::readJournal(): Line" << lineNumber << "of the journal is invalid:" << reader.errorMessage();
+            metaData.fields.clear();
+            return false;
+        }
+    }
+
+    // The journal doesn't keep track of the number of fields
+    metaData.videoParameters.numberOfSequentialFields = metaData.fields.size();
+
+    return true;
+}
+
+// Read the videoParameters object
+//
+// (In a journal, each videoParameters object replaces the previous one's
+// other members.)
+void LdDecodeMetaData::readVideoParameters(JsonReader &reader, VideoParameters &videoParameters, bool &isValid)
+{
+    QByteArray member;
+    videoParameters.otherMembers.clear();
+
+    reader.beginObject();
+    while (reader.readMember(member)) {
+        isValid = true;
+
+        if (member == "numberOfSequentialFields") reader.read(videoParameters.numberOfSequentialFields);
+        else if (member == "isSourcePal") reader.read(videoParameters.isSourcePal);
+        else if (member == "isSubcarrierLocked") reader.read(videoParameters.isSubcarrierLocked);
+        else if (member == "colourBurstStart") reader.read(videoParameters.colourBurstStart);
+        else if (member == "colourBurstEnd") reader.read(videoParameters.colourBurstEnd);
+        else if (member == "activeVideoStart") reader.read(videoParameters.activeVideoStart);
+        else if (member == "activeVideoEnd") reader.read(videoParameters.activeVideoEnd);
+        else if (member == "white16bIre") reader.read(videoParameters.white16bIre);
+        else if (member == "black16bIre") reader.read(videoParameters.black16bIre);
+        else if (member == "fieldWidth") reader.read(videoParameters.fieldWidth);
+        else if (member == "fieldHeight") reader.read(videoParameters.fieldHeight);
+        else if (member == "sampleRate") reader.read(videoParameters.sampleRate);
+        else if (member == "fsc") reader.read(videoParameters.fsc);
+        else if (member == "isMapped") reader.read(videoParameters.isMapped);
+        else readOtherMember(reader, member, videoParameters.otherMembers);
+    }
+}
+
+// Read the pcmAudioParameters object
+void LdDecodeMetaData::readPcmAudioParameters(JsonReader &reader, PcmAudioParameters &pcmAudioParameters, bool &isValid)
+{
+    QByteArray member;
+    pcmAudioParameters.otherMembers.clear();
+
+    reader.beginObject();
+    while (reader.readMember(member)) {
+        isValid = true;
+
+        if (member == "sampleRate") reader.read(pcmAudioParameters.sampleRate);
+        else if (member == "isLittleEndian") reader.read(pcmAudioParameters.isLittleEndian);
+        else if (member == "isSigned") reader.read(pcmAudioParameters.isSigned);
+        else if (member == "bits") reader.read(pcmAudioParameters.bits);
+        else readOtherMember(reader, member, pcmAudioParameters.otherMembers);
+    }
+}
+
+// Read the fields array
+void LdDecodeMetaData::readFields(JsonReader &reader, QVector<Field> &fields)
+{
+    reader.beginArray();
+    while (reader.readElement()) {
+        fields.append(Field());
+        readField(reader, fields.last());
+    }
+}
+
+// Read a field object
+void LdDecodeMetaData::readField(JsonReader &reader, Field &field)
+{
+    QByteArray member, subMember;
+    QVector<qint32> startx, endx, fieldLine;
+
+    reader.beginObject();
+    while (reader.readMember(member)) {
+        if (member == "seqNo") reader.read(field.seqNo);
+        else if (member == "isFirstField") reader.read(field.isFirstField);
+        else if (member == "syncConf") reader.read(field.syncConf);
+        else if (member == "medianBurstIRE") reader.read(field.medianBurstIRE);
+        else if (member == "fieldPhaseID") reader.read(field.fieldPhaseID);
+        else if (member == "audioSamples") reader.read(field.audioSamples);
+        else if (member == "diskLoc") reader.read(field.diskLoc);
+        else if (member == "fileLoc") reader.read(field.fileLoc);
+        else if (member == "decodeFaults") reader.read(field.decodeFaults);
+        else if (member == "pad") reader.read(field.pad);
+        else if (member == "vitsMetrics") {
+            reader.beginObject();
+            while (reader.readMember(subMember)) {
+                field.vitsMetrics.inUse = true;
+
+                if (subMember == "wSNR") reader.read(field.vitsMetrics.wSNR);
+                else if (subMember == "bPSNR") reader.read(field.vitsMetrics.bPSNR);
+                else readOtherMember(reader, subMember, field.vitsMetrics.otherMembers);
+            }
+        } else if (member == "vbi") {
+            reader.beginObject();
+            while (reader.readMember(subMember)) {
+                field.vbi.inUse = true;
+
+                if (subMember == "vbiData") {
+                    reader.beginArray();
+                    while (reader.readElement()) {
+                        qint32 value;
+                        reader.read(value);
+                        field.vbi.vbiData.append(value);
+                    }
+                } else {
+                    readOtherMember(reader, subMember, field.vbi.otherMembers);
+                }
+            }
+        } else if (member == "ntsc") {
+            reader.beginObject();
+            while (reader.readMember(subMember)) {
+                field.ntsc.inUse = true;
+
+                if (subMember == "isFmCodeDataValid") reader.read(field.ntsc.isFmCodeDataValid);
+                else if (subMember == "fmCodeData") reader.read(field.ntsc.fmCodeData);
+                else if (subMember == "fieldFlag") reader.read(field.ntsc.fieldFlag);
+                else if (subMember == "whiteFlag") reader.read(field.ntsc.whiteFlag);
+                else if (subMember == "ccData0") reader.read(field.ntsc.ccData0);
+                else if (subMember == "ccData1") reader.read(field.ntsc.ccData1);
+                else readOtherMember(reader, subMember, field.ntsc.otherMembers);
+            }
+        } else if (member == "dropOuts") {
+            startx.clear();
+            endx.clear();
+            fieldLine.clear();
+
+            reader.beginObject();
+            while (reader.readMember(subMember)) {
+                QVector<qint32> *values = nullptr;
+                if (subMember == "startx") values = &startx;
+                else if (subMember == "endx") values = &endx;
+                else if (subMember == "fieldLine") values = &fieldLine;
+
+                if (values == nullptr) {
+                    reader.discard();
+                    continue;
+                }
+
+                reader.beginArray();
+                while (reader.readElement()) {
+                    qint32 value;
+                    reader.read(value);
+                    values->append(value);
+                }
+            }
+
+            // Ensure that all three arrays are the same size
+            if (startx.size() != endx.size() || startx.size() != fieldLine.size()) {
+                qCritical("JSON file is invalid: Dropouts object is illegal");
+                const qint32 size = qMin(startx.size(), qMin(endx.size(), fieldLine.size()));
+                startx.resize(size);
+                endx.resize(size);
+                fieldLine.resize(size);
+            }
+
+            field.dropOuts = DropOuts(startx, endx, fieldLine);
+        } else {
+            readOtherMember(reader, member, field.otherMembers);
+        }
+    }
+
+    // Ensure there are always three VBI values, to prevent assert issues downstream
+    field.vbi.vbiData.resize(3);
+}
+
+// JSON writing
+//
+// The fields make up nearly all of a JSON file, so they're rendered in
+// parallel: each thread renders a range of fields into its own buffer, and
+// the buffers are written out in order as they become ready. Object members
+// are written in alphabetical order, matching the files previously written
+// using JsonWax, followed by any members the tools don't use.
+
+namespace {
+    // Minimum number of fields for each rendering thread
+    const qint32 MIN_FIELDS_PER_THREAD = 2000;
+
+    void writeVideoParameters(JsonWriter &writer, const LdDecodeMetaData::VideoParameters &videoParameters)
+    {
+        writer.beginObject();
+        writer.writeMember("activeVideoEnd");
+        writer.write(videoParameters.activeVideoEnd);
+        writer.writeMember("activeVideoStart");
+        writer.write(videoParameters.activeVideoStart);
+        writer.writeMember("black16bIre");
+        writer.write(videoParameters.black16bIre);
+        writer.writeMember("colourBurstEnd");
+        writer.write(videoParameters.colourBurstEnd);
+        writer.writeMember("colourBurstStart");
+        writer.write(videoParameters.colourBurstStart);
+        writer.writeMember("fieldHeight");
+        writer.write(videoParameters.fieldHeight);
+        writer.writeMember("fieldWidth");
+        writer.write(videoParameters.fieldWidth);
+        writer.writeMember("fsc");
+        writer.write(videoParameters.fsc);
+        writer.writeMember("isMapped");
+        writer.write(videoParameters.isMapped);
+        writer.writeMember("isSourcePal");
+        writer.write(videoParameters.isSourcePal);
+        writer.writeMember("isSubcarrierLocked");
+        writer.write(videoParameters.isSubcarrierLocked);
+        writer.writeMember("numberOfSequentialFields");
+        writer.write(videoParameters.numberOfSequentialFields);
+        writer.writeMember("sampleRate");
+        writer.write(videoParameters.sampleRate);
+        writer.writeMember("white16bIre");
+        writer.write(videoParameters.white16bIre);
+        writer.writeRawMembers(videoParameters.otherMembers);
+        writer.endObject();
+    }
+
+    void writePcmAudioParameters(JsonWriter &writer, const LdDecodeMetaData::PcmAudioParameters &pcmAudioParameters)
+    {
+        writer.beginObject();
+        writer.writeMember("bits");
+        writer.write(pcmAudioParameters.bits);
+        writer.writeMember("isLittleEndian");
+        writer.write(pcmAudioParameters.isLittleEndian);
+        writer.writeMember("isSigned");
+        writer.write(pcmAudioParameters.isSigned);
+        writer.writeMember("sampleRate");
+        writer.write(pcmAudioParameters.sampleRate);
+        writer.writeRawMembers(pcmAudioParameters.otherMembers);
+        writer.endObject();
+    }
+
+    void writeDropOutColumn(JsonWriter &writer, const DropOuts &dropOuts, qint32 (DropOuts::*getter)(qint32) const)
+    {
+        writer.beginArray();
+        for (qint32 i = 0; i < dropOuts.size(); i++) writer.write((dropOuts.*getter)(i));
+        writer.endArray();
+    }
+
+    void writeField(JsonWriter &writer, const LdDecodeMetaData::Field &field)
+    {
+        writer.beginObject();
+
+        writer.writeMember("audioSamples");
+        writer.write(field.audioSamples);
+
+        if (field.decodeFaults != -1) {
+            writer.writeMember("decodeFaults");
+            writer.write(field.decodeFaults);
+        }
+
+        if (field.diskLoc != -1) {
+            writer.writeMember("diskLoc");
+            writer.write(field.diskLoc);
+        }
+
+        if (field.dropOuts.size() > 0) {
+            writer.writeMember("dropOuts");
+            writer.beginObject();
+            writer.writeMember("endx");
+            writeDropOutColumn(writer, field.dropOuts, &DropOuts::endx);
+            writer.writeMember("fieldLine");
+            writeDropOutColumn(writer, field.dropOuts, &DropOuts::fieldLine);
+            writer.writeMember("startx");
+            writeDropOutColumn(writer, field.dropOuts, &DropOuts::startx);
+            writer.endObject();
+        }
+
+        writer.writeMember("fieldPhaseID");
+        writer.write(field.fieldPhaseID);
+
+        if (field.fileLoc != -1) {
+            writer.writeMember("fileLoc");
+            writer.write(field.fileLoc);
+        }
+
+        writer.writeMember("isFirstField");
+        writer.write(field.isFirstField);
+        writer.writeMember("medianBurstIRE");
+        writer.write(field.medianBurstIRE);
+
+        if (field.ntsc.inUse) {
+            writer.writeMember("ntsc");
+            writer.beginObject();
+            writer.writeMember("ccData0");
+            writer.write(field.ntsc.ccData0);
+            writer.writeMember("ccData1");
+            writer.write(field.ntsc.ccData1);
+            writer.writeMember("fieldFlag");
+            writer.write(field.ntsc.fieldFlag);
+            writer.writeMember("fmCodeData");
+            writer.write(field.ntsc.fmCodeData);
+            writer.writeMember("isFmCodeDataValid");
+            writer.write(field.ntsc.isFmCodeDataValid);
+            writer.writeMember("whiteFlag");
+            writer.write(field.ntsc.whiteFlag);
+            writer.writeRawMembers(field.ntsc.otherMembers);
+            writer.endObject();
+        }
+
+        writer.writeMember("pad");
+        writer.write(field.pad);
+        writer.writeMember("seqNo");
+        writer.write(field.seqNo);
+        writer.writeMember("syncConf");
+        writer.write(field.syncConf);
+
+        if (field.vbi.inUse) {
+            writer.writeMember("vbi");
+            writer.beginObject();
+            writer.writeMember("vbiData");
+            writer.beginArray();
+            for (qint32 i = 0; i < 3; i++) writer.write(field.vbi.vbiData.value(i));
+            writer.endArray();
+            writer.writeRawMembers(field.vbi.otherMembers);
+            writer.endObject();
+        }
+
+        if (field.vitsMetrics.inUse) {
+            writer.writeMember("vitsMetrics");
+            writer.beginObject();
+            writer.writeMember("bPSNR");
+            writer.write(field.vitsMetrics.bPSNR);
+            writer.writeMember("wSNR");
+            writer.write(field.vitsMetrics.wSNR);
+            writer.writeRawMembers(field.vitsMetrics.otherMembers);
+            writer.endObject();
+        }
+
+        writer.writeRawMembers(field.otherMembers);
+        writer.endObject();
+    }
+
+    // Thread that renders a range of fields as a sequence of JSON values
+    class FieldWriterThread : public QThread
+    {
+    public:
+        FieldWriterThread(const QVector<LdDecodeMetaData::Field> &_fields, qint32 _startField, qint32 _endField)
+            : fields(_fields), startField(_startField), endField(_endField)
+        {
+        }
+
+        QByteArray output;
+
+    protected:
+        void run() override
+        {
+            JsonWriter writer(output);
+            for (qint32 fieldNumber = startField; fieldNumber < endField; fieldNumber++) {
+                writeField(writer, fields[fieldNumber]);
+            }
+        }
+
+    private:
+        const QVector<LdDecodeMetaData::Field> &fields;
+        qint32 startField;
+        qint32 endField;
+    };
+}
+
+// Write the metadata structure to a JSON file
+//
+// The file is written under a temporary name, and renamed into place once
+// it's complete, so an existing file is never left half-written.
+bool LdDecodeMetaData::writeJson(QString fileName)
 {
-    VideoParameters videoParameters;
+    const QVector<Field> &fields = metaData.fields;
+
+    QSaveFile jsonFile(fileName);
+    if (!jsonFile.open(QIODevice::WriteOnly)) {
+        qCritical() << "LdDecodeMetaData::writeJson(): Cannot open" << fileName;
+        return false;
+    }
 
-    // Read the video paramters
-    if (json.size({"videoParameters"}) > 0) {
-        videoParameters.numberOfSequentialFields = json.value({"videoParameters", "numberOfSequentialFields"}).toInt();
-        videoParameters.isSourcePal = json.value({"videoParameters", "isSourcePal"}).toBool();
-        videoParameters.isSubcarrierLocked = json.value({"videoParameters", "isSubcarrierLocked"}).toBool();
+    // Start rendering the fields
+    const qint32 numberOfThreads = qBound(1, fields.size() / MIN_FIELDS_PER_THREAD, QThread::idealThreadCount());
+    QVector<FieldWriterThread *> threads(numberOfThreads);
+    for (qint32 i = 0; i < numberOfThreads; i++) {
+        const qint32 startField = static_cast<qint32>((static_cast<qint64>(fields.size()) * i) / numberOfThreads);
+        const qint32 endField = static_cast<qint32>((static_cast<qint64>(fields.size()) * (i + 1)) / numberOfThreads);
+        threads[i] = new FieldWriterThread(fields, startField, endField);
+        threads[i]->start();
+    }
 
-        videoParameters.colourBurstStart = json.value({"videoParameters", "colourBurstStart"}).toInt();
-        videoParameters.colourBurstEnd = json.value({"videoParameters", "colourBurstEnd"}).toInt();
-        videoParameters.activeVideoStart = json.value({"videoParameters", "activeVideoStart"}).toInt();
-        videoParameters.activeVideoEnd = json.value({"videoParameters", "activeVideoEnd"}).toInt();
+    QByteArray buffer;
+    JsonWriter writer(buffer);
+    writer.beginObject();
 
-        videoParameters.white16bIre = json.value({"videoParameters", "white16bIre"}).toInt();
-        videoParameters.black16bIre = json.value({"videoParameters", "black16bIre"}).toInt();
+    // Write the fields
+    if (!fields.isEmpty()) {
+        writer.writeMember("fields");
+        writer.beginArray();
 
-        videoParameters.fieldWidth = json.value({"videoParameters", "fieldWidth"}).toInt();
-        videoParameters.fieldHeight = json.value({"videoParameters", "fieldHeight"}).toInt();
-        videoParameters.sampleRate = json.value({"videoParameters", "sampleRate"}).toInt();
-        videoParameters.fsc = json.value({"videoParameters", "fsc"}).toInt();
+        for (qint32 i = 0; i < numberOfThreads; i++) {
+            threads[i]->wait();
+            writer.writeRaw(threads[i]->output);
+            delete threads[i];
 
-        videoParameters.isMapped = json.value({"videoParameters", "isMapped"}).toBool();
+            jsonFile.write(buffer);
+            buffer.clear();
+        }
+
+        writer.endArray();
     } else {
+        for (qint32 i = 0; i < numberOfThreads; i++) {
+            threads[i]->wait();
+            delete threads[i];
+        }
+    }
+
+    // Write the PCM audio parameters
+    if (isPcmAudioParametersValid) {
+        writer.writeMember("pcmAudioParameters");
+        writePcmAudioParameters(writer, metaData.pcmAudioParameters);
+    }
+
+    // Write the video parameters
+    if (isVideoParametersValid) {
+        writer.writeMember("videoParameters");
+        writeVideoParameters(writer, metaData.videoParameters);
+    }
+
+    // Write any other members
+    writer.writeRawMembers(metaData.otherMembers);
+
+    writer.endObject();
+    jsonFile.write(buffer);
+
+    return jsonFile.commit();
+}
+
+// Sidecar index files
+//
+// Parsing a large JSON file is slow, so when the metadata is written to a JSON
+// file, it is also saved in a binary "sidecar" file alongside it (e.g.
+// "capture.tbc.idx" for "capture.tbc.json"). The sidecar
+// records the size and modification time of the JSON file it was made from,
+// and is only used while these still match. It is purely a cache, written in
+// the machine's native byte order; if anything about it doesn't look right,
+// it's ignored and rebuilt from the JSON.
+//
+// The sidecar consists of a header followed by the per-field metadata stored
+// as columns (arrays with one entry per field), each padded to a multiple of
+// 8 bytes so the columns can be used in place once the file is memory-mapped.
+// The dropouts for all fields are stored in a single packed table, with a
+// column of offsets giving the position of each field's first dropout.
+//
+// Members of the JSON objects that the tools don't use are kept as JSON text;
+// this is stored in another packed table, with a column of offsets giving the
+// position of each field's text for the field and its vitsMetrics, vbi and
+// ntsc objects. The text for the top-level object, videoParameters and
+// pcmAudioParameters follows.
+//
+// The sidecar also holds the VBI seek index, if it had been built and the
+// metadata was using the standard field order when it was written, so tools
+// can seek by picture number or chapter without decoding the VBI. (The index
+// isn't built just to write the sidecar.)
+
+namespace {
+    // "TBCIDX01" when read as little-endian; also detects a byte order mismatch
+    const quint64 SIDECAR_MAGIC = 0x3130584449434254ULL;
+    const quint32 SIDECAR_VERSION = 4;
+
+    struct SidecarHeader {
+        quint64 magic;
+        quint32 version;
+        qint32 numberOfFields;
+        qint64 jsonSize;
+        qint64 jsonModified;
+        qint64 numberOfDropOuts;
+        qint64 otherMembersSize;
+        qint64 otherDocumentMembersSizes[3];
+        qint32 isVideoParametersValid;
+        qint32 isPcmAudioParametersValid;
+        qint32 videoParameters[14];
+        qint32 pcmAudioParameters[4];
+        qint32 hasSeekIndex;
+        qint32 numberOfPictureNumbers;
+        qint32 numberOfClvTimecodes;
+        qint32 numberOfChapterStarts;
+    };
+
+    // Bits in the per-field flags column
+    enum SidecarFieldFlags : qint32 {
+        FLAG_IS_FIRST_FIELD = 1 << 0,
+        FLAG_PAD = 1 << 1,
+        FLAG_VITS_IN_USE = 1 << 2,
+        FLAG_VBI_IN_USE = 1 << 3,
+        FLAG_NTSC_IN_USE = 1 << 4,
+        FLAG_NTSC_FM_CODE_VALID = 1 << 5,
+        FLAG_NTSC_FIELD_FLAG = 1 << 6,
+        FLAG_NTSC_WHITE_FLAG = 1 << 7,
+    };
+
+    // Number of otherMembers entries outside the fields (the top-level
+    // object, then videoParameters and pcmAudioParameters)
+    const qint32 OTHER_DOCUMENT_MEMBERS = 3;
+
+    QByteArray *getOtherDocumentMembers(LdDecodeMetaData::MetaData &metaData, qint32 index)
+    {
+        switch (index) {
+        case 0: return &metaData.otherMembers;
+        case 1: return &metaData.videoParameters.otherMembers;
+        default: return &metaData.pcmAudioParameters.otherMembers;
+        }
+    }
+
+    // Number of otherMembers entries for each field (the field itself, then
+    // its vitsMetrics, vbi and ntsc objects)
+    const qint32 OTHER_MEMBERS_PER_FIELD = 4;
+
+    QByteArray *getOtherMembers(LdDecodeMetaData::Field &field, qint32 index)
+    {
+        switch (index) {
+        case 0: return &field.otherMembers;
+        case 1: return &field.vitsMetrics.otherMembers;
+        case 2: return &field.vbi.otherMembers;
+        default: return &field.ntsc.otherMembers;
+        }
+    }
+
+    // Append raw data to a sidecar buffer, padding it to a multiple of 8 bytes
+    void appendSidecarData(QByteArray &buffer, const void *data, qint64 size)
+    {
+        buffer.append(static_cast<const char *>(data), static_cast<int>(size));
+        while (buffer.size() % 8 != 0) buffer.append('\0');
+    }
+
+    template <typename T>
+    void appendSidecarColumn(QByteArray &buffer, const QVector<T> &column)
+    {
+        appendSidecarData(buffer, column.constData(), column.size() * static_cast<qint64>(sizeof(T)));
+    }
+
+    // Read columns in sequence from a memory-mapped sidecar, checking bounds
+    class SidecarReader {
+    public:
+        SidecarReader(const uchar *_data, qint64 _size) : data(_data), size(_size), position(0), ok(true) {}
+
+        template <typename T>
+        const T *column(qint64 count) {
+            const qint64 bytes = count * static_cast<qint64>(sizeof(T));
+            if (!ok || count < 0 || position + bytes > size) {
+                ok = false;
+                return nullptr;
+            }
+
+            const T *result = reinterpret_cast<const T *>(data + position);
+            position += (bytes + 7) & ~7LL;
+            return result;
+        }
+
+        bool isOk() const { return ok; }
+
+    private:
+        const uchar *data;
+        qint64 size;
+        qint64 position;
+        bool ok;
+    };
+}
+
+// Get the sidecar index file name for a JSON file name
+QString LdDecodeMetaData::getSidecarFileName(QString fileName)
+{
+    if (fileName.endsWith(".json")) fileName.chop(5);
+    return fileName + ".idx";
+}
+
+// Read the metadata from the sidecar index file for a JSON file, if it's valid
+bool LdDecodeMetaData::readSidecar(QString fileName)
+{
+    QFileInfo jsonInfo(fileName);
+    if (!jsonInfo.exists()) return false;
+
+    QFile sidecarFile(getSidecarFileName(fileName));
+    if (!sidecarFile.exists() || !sidecarFile.open(QIODevice::ReadOnly)) return false;
+
+    const qint64 sidecarSize = sidecarFile.size();
+    const uchar *sidecarData = sidecarFile.map(0, sidecarSize);
+    if (sidecarData == nullptr) return false;
+
+    SidecarReader reader(sidecarData, sidecarSize);
+
+    // Check that the sidecar matches the JSON file
+    const SidecarHeader *header = reader.column<SidecarHeader>(1);
+    if (header == nullptr || header->magic != SIDECAR_MAGIC || header->version != SIDECAR_VERSION
+            || header->jsonSize != jsonInfo.size()
+            || header->jsonModified != jsonInfo.lastModified().toMSecsSinceEpoch()) {
+        qDebug() << "LdDecodeMetaData::readSidecar(): Sidecar index is out of date or invalid; ignoring it";
+        return false;
+    }
+
+    const qint32 numberOfFields = header->numberOfFields;
+    const qint64 numberOfDropOuts = header->numberOfDropOuts;
+
+    // Locate the columns
+    const qint32 *seqNo = reader.column<qint32>(numberOfFields);
+    const qint32 *flags = reader.column<qint32>(numberOfFields);
+    const qint32 *syncConf = reader.column<qint32>(numberOfFields);
+    const qint32 *fieldPhaseID = reader.column<qint32>(numberOfFields);
+    const qint32 *audioSamples = reader.column<qint32>(numberOfFields);
+    const qint32 *decodeFaults = reader.column<qint32>(numberOfFields);
+    const double *medianBurstIRE = reader.column<double>(numberOfFields);
+    const double *diskLoc = reader.column<double>(numberOfFields);
+    const qint64 *fileLoc = reader.column<qint64>(numberOfFields);
+    const double *wSNR = reader.column<double>(numberOfFields);
+    const double *bPSNR = reader.column<double>(numberOfFields);
+    const qint32 *vbiData = reader.column<qint32>(numberOfFields * 3LL);
+    const qint32 *fmCodeData = reader.column<qint32>(numberOfFields);
+    const qint32 *ccData0 = reader.column<qint32>(numberOfFields);
+    const qint32 *ccData1 = reader.column<qint32>(numberOfFields);
+    const qint64 *dropOutOffsets = reader.column<qint64>(numberOfFields + 1LL);
+    const qint32 *dropOutStartx = reader.column<qint32>(numberOfDropOuts);
+    const qint32 *dropOutEndx = reader.column<qint32>(numberOfDropOuts);
+    const qint32 *dropOutFieldLine = reader.column<qint32>(numberOfDropOuts);
+    const qint64 *otherMembersOffsets = reader.column<qint64>((numberOfFields * static_cast<qint64>(OTHER_MEMBERS_PER_FIELD)) + 1);
+    const char *otherMembersData = reader.column<char>(header->otherMembersSize);
+    const char *otherDocumentMembersData[OTHER_DOCUMENT_MEMBERS];
+    for (qint32 i = 0; i < OTHER_DOCUMENT_MEMBERS; i++) {
+        otherDocumentMembersData[i] = reader.column<char>(header->otherDocumentMembersSizes[i]);
+    }
+    const SeekIndexEntry *pictureNumbers = reader.column<SeekIndexEntry>(header->numberOfPictureNumbers);
+    const SeekIndexEntry *clvTimecodes = reader.column<SeekIndexEntry>(header->numberOfClvTimecodes);
+    const SeekIndexEntry *chapters = reader.column<SeekIndexEntry>(header->numberOfChapterStarts);
+
+    if (!reader.isOk()) {
+        qDebug() << "LdDecodeMetaData::readSidecar(): Sidecar index is truncated; ignoring it";
+        return false;
+    }
+
+    // Unpack the video and PCM audio parameters
+    isVideoParametersValid = header->isVideoParametersValid != 0;
+    VideoParameters &videoParameters = metaData.videoParameters;
+    videoParameters.numberOfSequentialFields = header->videoParameters[0];
+    videoParameters.isSourcePal = header->videoParameters[1] != 0;
+    videoParameters.isSubcarrierLocked = header->videoParameters[2] != 0;
+    videoParameters.colourBurstStart = header->videoParameters[3];
+    videoParameters.colourBurstEnd = header->videoParameters[4];
+    videoParameters.activeVideoStart = header->videoParameters[5];
+    videoParameters.activeVideoEnd = header->videoParameters[6];
+    videoParameters.white16bIre = header->videoParameters[7];
+    videoParameters.black16bIre = header->videoParameters[8];
+    videoParameters.fieldWidth = header->videoParameters[9];
+    videoParameters.fieldHeight = header->videoParameters[10];
+    videoParameters.sampleRate = header->videoParameters[11];
+    videoParameters.fsc = header->videoParameters[12];
+    videoParameters.isMapped = header->videoParameters[13] != 0;
+
+    isPcmAudioParametersValid = header->isPcmAudioParametersValid != 0;
+    PcmAudioParameters &pcmAudioParameters = metaData.pcmAudioParameters;
+    pcmAudioParameters.sampleRate = header->pcmAudioParameters[0];
+    pcmAudioParameters.isLittleEndian = header->pcmAudioParameters[1] != 0;
+    pcmAudioParameters.isSigned = header->pcmAudioParameters[2] != 0;
+    pcmAudioParameters.bits = header->pcmAudioParameters[3];
+
+    // Unpack the fields
+    metaData.fields.clear();
+    metaData.fields.resize(numberOfFields);
+    for (qint32 i = 0; i < numberOfFields; i++) {
+        Field &field = metaData.fields[i];
+
+        field.seqNo = seqNo[i];
+        field.isFirstField = (flags[i] & FLAG_IS_FIRST_FIELD) != 0;
+        field.syncConf = syncConf[i];
+        field.medianBurstIRE = medianBurstIRE[i];
+        field.fieldPhaseID = fieldPhaseID[i];
+        field.audioSamples = audioSamples[i];
+        field.diskLoc = diskLoc[i];
+        field.fileLoc = fileLoc[i];
+        field.decodeFaults = decodeFaults[i];
+        field.pad = (flags[i] & FLAG_PAD) != 0;
+
+        field.vitsMetrics.inUse = (flags[i] & FLAG_VITS_IN_USE) != 0;
+        field.vitsMetrics.wSNR = wSNR[i];
+        field.vitsMetrics.bPSNR = bPSNR[i];
+
+        field.vbi.inUse = (flags[i] & FLAG_VBI_IN_USE) != 0;
+        field.vbi.vbiData = { vbiData[(i * 3) + 0], vbiData[(i * 3) + 1], vbiData[(i * 3) + 2] };
+
+        field.ntsc.inUse = (flags[i] & FLAG_NTSC_IN_USE) != 0;
+        field.ntsc.isFmCodeDataValid = (flags[i] & FLAG_NTSC_FM_CODE_VALID) != 0;
+        field.ntsc.fmCodeData = fmCodeData[i];
+        field.ntsc.fieldFlag = (flags[i] & FLAG_NTSC_FIELD_FLAG) != 0;
+        field.ntsc.whiteFlag = (flags[i] & FLAG_NTSC_WHITE_FLAG) != 0;
+        field.ntsc.ccData0 = ccData0[i];
+        field.ntsc.ccData1 = ccData1[i];
+
+        const qint64 firstDropOut = dropOutOffsets[i];
+        const qint64 lastDropOut = dropOutOffsets[i + 1];
+        if (firstDropOut < 0 || lastDropOut < firstDropOut || lastDropOut > numberOfDropOuts) {
+            qDebug() << "LdDecodeMetaData::readSidecar(): Sidecar index has invalid dropout offsets; ignoring it";
+            metaData.fields.clear();
+            return false;
+        }
+
+        const qint32 count = static_cast<qint32>(lastDropOut - firstDropOut);
+        if (count > 0) {
+            QVector<qint32> startx(count), endx(count), fieldLine(count);
+            std::copy(dropOutStartx + firstDropOut, dropOutStartx + lastDropOut, startx.begin());
+            std::copy(dropOutEndx + firstDropOut, dropOutEndx + lastDropOut, endx.begin());
+            std::copy(dropOutFieldLine + firstDropOut, dropOutFieldLine + lastDropOut, fieldLine.begin());
+            field.dropOuts = DropOuts(startx, endx, fieldLine);
+        }
+
+        for (qint32 j = 0; j < OTHER_MEMBERS_PER_FIELD; j++) {
+            const qint64 start = otherMembersOffsets[(i * OTHER_MEMBERS_PER_FIELD) + j];
+            const qint64 end = otherMembersOffsets[(i * OTHER_MEMBERS_PER_FIELD) + j + 1];
+            if (start < 0 || end < start || end > header->otherMembersSize) {
+                qDebug() << "LdDecodeMetaData::readSidecar(): Sidecar index has invalid offsets; ignoring it";
+                metaData.fields.clear();
+                return false;
+            }
+
+            if (end > start) *getOtherMembers(field, j) = QByteArray(otherMembersData + start, static_cast<int>(end - start));
+        }
+    }
+
+    for (qint32 i = 0; i < OTHER_DOCUMENT_MEMBERS; i++) {
+        *getOtherDocumentMembers(metaData, i) = QByteArray(otherDocumentMembersData[i],
+                                                           static_cast<int>(header->otherDocumentMembersSizes[i]));
+    }
+
+    // Unpack the seek index
+    if (header->hasSeekIndex != 0) {
+        pictureNumberIndex = QVector<SeekIndexEntry>(header->numberOfPictureNumbers);
+        std::copy(pictureNumbers, pictureNumbers + header->numberOfPictureNumbers, pictureNumberIndex.begin());
+        clvTimecodeIndex = QVector<SeekIndexEntry>(header->numberOfClvTimecodes);
+        std::copy(clvTimecodes, clvTimecodes + header->numberOfClvTimecodes, clvTimecodeIndex.begin());
+        chapterStarts = QVector<SeekIndexEntry>(header->numberOfChapterStarts);
+        std::copy(chapters, chapters + header->numberOfChapterStarts, chapterStarts.begin());
+        isSeekIndexValid = true;
+    }
+
+    return true;
+}
+
+// Write the sidecar index file for a JSON file
+bool LdDecodeMetaData::writeSidecar(QString fileName)
+{
+    QFileInfo jsonInfo(fileName);
+    if (!jsonInfo.exists()) return false;
+
+    const qint32 numberOfFields = metaData.fields.size();
+
+    // Build the columns
+    QVector<qint32> seqNo(numberOfFields), flags(numberOfFields), syncConf(numberOfFields);
+    QVector<qint32> fieldPhaseID(numberOfFields), audioSamples(numberOfFields), decodeFaults(numberOfFields);
+    QVector<double> medianBurstIRE(numberOfFields), diskLoc(numberOfFields);
+    QVector<qint64> fileLoc(numberOfFields);
+    QVector<double> wSNR(numberOfFields), bPSNR(numberOfFields);
+    QVector<qint32> vbiData(numberOfFields * 3);
+    QVector<qint32> fmCodeData(numberOfFields), ccData0(numberOfFields), ccData1(numberOfFields);
+    QVector<qint64> dropOutOffsets(numberOfFields + 1);
+    QVector<qint32> dropOutStartx, dropOutEndx, dropOutFieldLine;
+    QVector<qint64> otherMembersOffsets((numberOfFields * OTHER_MEMBERS_PER_FIELD) + 1);
+    QByteArray otherMembersData;
+
+    for (qint32 i = 0; i < numberOfFields; i++) {
+        Field &field = metaData.fields[i];
+
+        seqNo[i] = field.seqNo;
+        flags[i] = (field.isFirstField ? FLAG_IS_FIRST_FIELD : 0)
+                | (field.pad ? FLAG_PAD : 0)
+                | (field.vitsMetrics.inUse ? FLAG_VITS_IN_USE : 0)
+                | (field.vbi.inUse ? FLAG_VBI_IN_USE : 0)
+                | (field.ntsc.inUse ? FLAG_NTSC_IN_USE : 0)
+                | (field.ntsc.isFmCodeDataValid ? FLAG_NTSC_FM_CODE_VALID : 0)
+                | (field.ntsc.fieldFlag ? FLAG_NTSC_FIELD_FLAG : 0)
+                | (field.ntsc.whiteFlag ? FLAG_NTSC_WHITE_FLAG : 0);
+        syncConf[i] = field.syncConf;
+        fieldPhaseID[i] = field.fieldPhaseID;
+        audioSamples[i] = field.audioSamples;
+        decodeFaults[i] = field.decodeFaults;
+        medianBurstIRE[i] = field.medianBurstIRE;
+        diskLoc[i] = field.diskLoc;
+        fileLoc[i] = field.fileLoc;
+        wSNR[i] = field.vitsMetrics.wSNR;
+        bPSNR[i] = field.vitsMetrics.bPSNR;
+        for (qint32 j = 0; j < 3; j++) vbiData[(i * 3) + j] = field.vbi.vbiData.value(j);
+        fmCodeData[i] = field.ntsc.fmCodeData;
+        ccData0[i] = field.ntsc.ccData0;
+        ccData1[i] = field.ntsc.ccData1;
+
+        dropOutOffsets[i] = dropOutStartx.size();
+        for (qint32 j = 0; j < field.dropOuts.size(); j++) {
+            dropOutStartx.append(field.dropOuts.startx(j));
+            dropOutEndx.append(field.dropOuts.endx(j));
+            dropOutFieldLine.append(field.dropOuts.fieldLine(j));
+        }
+
+        for (qint32 j = 0; j < OTHER_MEMBERS_PER_FIELD; j++) {
+            otherMembersOffsets[(i * OTHER_MEMBERS_PER_FIELD) + j] = otherMembersData.size();
+            otherMembersData.append(*getOtherMembers(field, j));
+        }
+    }
+    dropOutOffsets[numberOfFields] = dropOutStartx.size();
+    otherMembersOffsets[numberOfFields * OTHER_MEMBERS_PER_FIELD] = otherMembersData.size();
+
+    // The seek index depends on the field order, so only save it for the
+    // standard order (which is what the reader will be using)
+    const bool hasSeekIndex = isFirstFieldFirst && isSeekIndexValid;
+    const QVector<SeekIndexEntry> emptyIndex;
+
+    // Build the header
+    SidecarHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = SIDECAR_MAGIC;
+    header.version = SIDECAR_VERSION;
+    header.numberOfFields = numberOfFields;
+    header.jsonSize = jsonInfo.size();
+    header.jsonModified = jsonInfo.lastModified().toMSecsSinceEpoch();
+    header.numberOfDropOuts = dropOutStartx.size();
+    header.otherMembersSize = otherMembersData.size();
+    for (qint32 i = 0; i < OTHER_DOCUMENT_MEMBERS; i++) {
+        header.otherDocumentMembersSizes[i] = getOtherDocumentMembers(metaData, i)->size();
+    }
+
+    const VideoParameters &videoParameters = metaData.videoParameters;
+    header.isVideoParametersValid = isVideoParametersValid ? 1 : 0;
+    if (isVideoParametersValid) {
+        header.videoParameters[0] = videoParameters.numberOfSequentialFields;
+        header.videoParameters[1] = videoParameters.isSourcePal ? 1 : 0;
+        header.videoParameters[2] = videoParameters.isSubcarrierLocked ? 1 : 0;
+        header.videoParameters[3] = videoParameters.colourBurstStart;
+        header.videoParameters[4] = videoParameters.colourBurstEnd;
+        header.videoParameters[5] = videoParameters.activeVideoStart;
+        header.videoParameters[6] = videoParameters.activeVideoEnd;
+        header.videoParameters[7] = videoParameters.white16bIre;
+        header.videoParameters[8] = videoParameters.black16bIre;
+        header.videoParameters[9] = videoParameters.fieldWidth;
+        header.videoParameters[10] = videoParameters.fieldHeight;
+        header.videoParameters[11] = videoParameters.sampleRate;
+        header.videoParameters[12] = videoParameters.fsc;
+        header.videoParameters[13] = videoParameters.isMapped ? 1 : 0;
+    }
+
+    const PcmAudioParameters &pcmAudioParameters = metaData.pcmAudioParameters;
+    header.isPcmAudioParametersValid = isPcmAudioParametersValid ? 1 : 0;
+    if (isPcmAudioParametersValid) {
+        header.pcmAudioParameters[0] = pcmAudioParameters.sampleRate;
+        header.pcmAudioParameters[1] = pcmAudioParameters.isLittleEndian ? 1 : 0;
+        header.pcmAudioParameters[2] = pcmAudioParameters.isSigned ? 1 : 0;
+        header.pcmAudioParameters[3] = pcmAudioParameters.bits;
+    }
+
+    header.hasSeekIndex = hasSeekIndex ? 1 : 0;
+    header.numberOfPictureNumbers = hasSeekIndex ? pictureNumberIndex.size() : 0;
+    header.numberOfClvTimecodes = hasSeekIndex ? clvTimecodeIndex.size() : 0;
+    header.numberOfChapterStarts = hasSeekIndex ? chapterStarts.size() : 0;
+
+    // Assemble the file
+    QByteArray buffer;
+    appendSidecarData(buffer, &header, sizeof(header));
+    appendSidecarColumn(buffer, seqNo);
+    appendSidecarColumn(buffer, flags);
+    appendSidecarColumn(buffer, syncConf);
+    appendSidecarColumn(buffer, fieldPhaseID);
+    appendSidecarColumn(buffer, audioSamples);
+    appendSidecarColumn(buffer, decodeFaults);
+    appendSidecarColumn(buffer, medianBurstIRE);
+    appendSidecarColumn(buffer, diskLoc);
+    appendSidecarColumn(buffer, fileLoc);
+    appendSidecarColumn(buffer, wSNR);
+    appendSidecarColumn(buffer, bPSNR);
+    appendSidecarColumn(buffer, vbiData);
+    appendSidecarColumn(buffer, fmCodeData);
+    appendSidecarColumn(buffer, ccData0);
+    appendSidecarColumn(buffer, ccData1);
+    appendSidecarColumn(buffer, dropOutOffsets);
+    appendSidecarColumn(buffer, dropOutStartx);
+    appendSidecarColumn(buffer, dropOutEndx);
+    appendSidecarColumn(buffer, dropOutFieldLine);
+    appendSidecarColumn(buffer, otherMembersOffsets);
+    appendSidecarData(buffer, otherMembersData.constData(), otherMembersData.size());
+    for (qint32 i = 0; i < OTHER_DOCUMENT_MEMBERS; i++) {
+        const QByteArray *otherDocumentMembers = getOtherDocumentMembers(metaData, i);
+        appendSidecarData(buffer, otherDocumentMembers->constData(), otherDocumentMembers->size());
+    }
+    appendSidecarColumn(buffer, hasSeekIndex ? pictureNumberIndex : emptyIndex);
+    appendSidecarColumn(buffer, hasSeekIndex ? clvTimecodeIndex : emptyIndex);
+    appendSidecarColumn(buffer, hasSeekIndex ? chapterStarts : emptyIndex);
+
+    // Write it (atomically, so a partially-written sidecar is never seen)
+    QSaveFile sidecarFile(getSidecarFileName(fileName));
+    if (!sidecarFile.open(QIODevice::WriteOnly) || sidecarFile.write(buffer) != buffer.size()
+            || !sidecarFile.commit()) {
+        qDebug() << "LdDecodeMetaData::writeSidecar(): Could not write sidecar index" << sidecarFile.fileName();
+        return false;
+    }
+
+    return true;
+}
+
+// This method returns the videoParameters metadata
+LdDecodeMetaData::VideoParameters LdDecodeMetaData::getVideoParameters()
+{
+    if (!isVideoParametersValid) {
         qCritical("JSON file invalid: videoParameters object is not defined");
-        return videoParameters;
+        return metaData.videoParameters;
     }
 
+    VideoParameters videoParameters = metaData.videoParameters;
+
     // Add in the active field line range psuedo-metadata
     if (videoParameters.isSourcePal) {
         // PAL
@@ -119,218 +1148,129 @@ LdDecodeMetaData::VideoParameters LdDecodeMetaData::getVideoParameters()
 // This method sets the videoParameters metadata
 void LdDecodeMetaData::setVideoParameters (LdDecodeMetaData::VideoParameters _videoParameters)
 {
-    // Write the video parameters
-    json.setValue({"videoParameters", "numberOfSequentialFields"}, getNumberOfFields());
-    json.setValue({"videoParameters", "isSourcePal"}, _videoParameters.isSourcePal);
-    json.setValue({"videoParameters", "isSubcarrierLocked"}, _videoParameters.isSubcarrierLocked);
-
-    json.setValue({"videoParameters", "colourBurstStart"}, _videoParameters.colourBurstStart);
-    json.setValue({"videoParameters", "colourBurstEnd"}, _videoParameters.colourBurstEnd);
-    json.setValue({"videoParameters", "activeVideoStart"}, _videoParameters.activeVideoStart);
-    json.setValue({"videoParameters", "activeVideoEnd"}, _videoParameters.activeVideoEnd);
-
-    json.setValue({"videoParameters", "white16bIre"}, _videoParameters.white16bIre);
-    json.setValue({"videoParameters", "black16bIre"}, _videoParameters.black16bIre);
+    metaData.videoParameters = _videoParameters;
+    metaData.videoParameters.numberOfSequentialFields = getNumberOfFields();
+    isVideoParametersValid = true;
 
-    json.setValue({"videoParameters", "fieldWidth"}, _videoParameters.fieldWidth);
-    json.setValue({"videoParameters", "fieldHeight"}, _videoParameters.fieldHeight);
-    json.setValue({"videoParameters", "sampleRate"}, _videoParameters.sampleRate);
-    json.setValue({"videoParameters", "fsc"}, _videoParameters.fsc);
-
-    json.setValue({"videoParameters", "isMapped"}, _videoParameters.isMapped);
+    // The frame VBI depends on the video system, so discard the cached copy
+    invalidateFrameVbi();
 }
 
 // This method returns the pcmAudioParameters metadata
 LdDecodeMetaData::PcmAudioParameters LdDecodeMetaData::getPcmAudioParameters()
 {
-    PcmAudioParameters pcmAudioParameters;
-
-    if (json.size({"pcmAudioParameters"}) > 0) {
-        // Read the PCM audio data
-        pcmAudioParameters.sampleRate = json.value({"pcmAudioParameters", "sampleRate"}).toInt();
-        pcmAudioParameters.isLittleEndian = json.value({"pcmAudioParameters", "isLittleEndian"}).toBool();
-        pcmAudioParameters.isSigned = json.value({"pcmAudioParameters", "isSigned"}).toBool();
-        pcmAudioParameters.bits = json.value({"pcmAudioParameters", "bits"}).toInt();
-    } else {
+    if (!isPcmAudioParametersValid) {
         qCritical("JSON file invalid: pcmAudioParameters is not defined");
-        return pcmAudioParameters;
     }
 
-    return pcmAudioParameters;
+    return metaData.pcmAudioParameters;
 }
 
 // This method sets the pcmAudioParameters metadata
 void LdDecodeMetaData::setPcmAudioParameters(LdDecodeMetaData::PcmAudioParameters _pcmAudioParam)
 {
-    json.setValue({"pcmAudioParameters", "sampleRate"}, _pcmAudioParam.sampleRate);
-    json.setValue({"pcmAudioParameters", "isLittleEndian"}, _pcmAudioParam.isLittleEndian);
-    json.setValue({"pcmAudioParameters", "isSigned"}, _pcmAudioParam.isSigned);
-    json.setValue({"pcmAudioParameters", "bits"}, _pcmAudioParam.bits);
+    metaData.pcmAudioParameters = _pcmAudioParam;
+    isPcmAudioParametersValid = true;
 }
 
-// This method gets the metadata for the specified sequential field number (indexed from 1 (not 0!))
-LdDecodeMetaData::Field LdDecodeMetaData::getField(qint32 sequentialFieldNumber)
+// Return a pointer to the metadata for the specified sequential field number
+// (indexed from 1), or nullptr if it's out of bounds. If forUpdate is true,
+// fields beyond the end of the metadata are created as needed.
+LdDecodeMetaData::Field *LdDecodeMetaData::getFieldPointer(qint32 sequentialFieldNumber, bool forUpdate,
+                                                           const char *caller)
 {
-    Field field;
     qint32 fieldNumber = sequentialFieldNumber - 1;
+    qint32 numberOfFields = metaData.fields.size();
 
-    if (fieldNumber >= getNumberOfFields() || fieldNumber < 0) {
-        qCritical() << "LdDecodeMetaData::getField(): Requested field number" << sequentialFieldNumber << "out of bounds!";
+    if (fieldNumber < 0 || (!forUpdate && fieldNumber >= numberOfFields)) {
+        qCritical() << caller << "Requested field number" << sequentialFieldNumber << "out of bounds!";
+        return nullptr;
     }
 
-    // Primary field values
-    field.seqNo = json.value({"fields", fieldNumber, "seqNo"}).toInt();
-    field.isFirstField = json.value({"fields", fieldNumber, "isFirstField"}).toBool();
-    field.syncConf = json.value({"fields", fieldNumber, "syncConf"}).toInt();
-    field.medianBurstIRE = json.value({"fields", fieldNumber, "medianBurstIRE"}).toDouble();
-    field.fieldPhaseID = json.value({"fields", fieldNumber, "fieldPhaseID"}).toInt();
-    field.audioSamples = json.value({"fields", fieldNumber, "audioSamples"}).toInt();
-
-    // VITS metrics values
-    field.vitsMetrics = getFieldVitsMetrics(sequentialFieldNumber);
-
-    // VBI values
-    field.vbi = getFieldVbi(sequentialFieldNumber);
+    if (fieldNumber >= numberOfFields) {
+        if (fieldNumber > numberOfFields) {
+            qCritical() << caller << "Requested field number" << sequentialFieldNumber << "is beyond the end of the metadata";
+        }
 
-    // NTSC values
-    field.ntsc = getFieldNtsc(sequentialFieldNumber);
+        // Add empty fields up to the requested field
+        metaData.fields.resize(fieldNumber + 1);
+        for (qint32 i = numberOfFields; i <= fieldNumber; i++) metaData.fields[i].vbi.vbiData.resize(3);
+    }
 
-    // dropOuts values
-    field.dropOuts = getFieldDropOuts(sequentialFieldNumber);
+    return &metaData.fields[fieldNumber];
+}
 
-    // Padding flag
-    field.pad = json.value({"fields", fieldNumber, "pad"}).toBool();
+// This method gets the metadata for the specified sequential field number (indexed from 1 (not 0!))
+LdDecodeMetaData::Field LdDecodeMetaData::getField(qint32 sequentialFieldNumber)
+{
+    Field *field = getFieldPointer(sequentialFieldNumber, false, "LdDecodeMetaData::getField():");
+    if (field == nullptr) {
+        Field emptyField;
+        emptyField.vbi.vbiData.resize(3);
+        return emptyField;
+    }
 
-    return field;
+    return *field;
 }
 
 // This method gets the VITS metrics metadata for the specified sequential field number
 LdDecodeMetaData::VitsMetrics LdDecodeMetaData::getFieldVitsMetrics(qint32 sequentialFieldNumber)
 {
-    VitsMetrics vitsMetrics;
-    qint32 fieldNumber = sequentialFieldNumber - 1;
-
-    if (fieldNumber >= getNumberOfFields() || fieldNumber < 0) {
-        qCritical() << "LdDecodeMetaData::getFieldVitsMetrics(): Requested field number" << sequentialFieldNumber << "out of bounds!";
-    }
-
-    if (json.size({"fields", fieldNumber, "vitsMetrics"}) > 0) {
-        vitsMetrics.inUse = true;
-        vitsMetrics.wSNR = json.value({"fields", fieldNumber, "vitsMetrics", "wSNR"}).toReal();
-        vitsMetrics.bPSNR = json.value({"fields", fieldNumber, "vitsMetrics", "bPSNR"}).toReal();
-    } else {
-        // Mark VITS metrics as undefined
-        vitsMetrics.inUse = false;
-    }
+    Field *field = getFieldPointer(sequentialFieldNumber, false, "LdDecodeMetaData::getFieldVitsMetrics():");
+    if (field == nullptr) return VitsMetrics();
 
-    return vitsMetrics;
+    return field->vitsMetrics;
 }
 
 // This method gets the VBI metadata for the specified sequential field number
 LdDecodeMetaData::Vbi LdDecodeMetaData::getFieldVbi(qint32 sequentialFieldNumber)
 {
-    Vbi vbi;
-    qint32 fieldNumber = sequentialFieldNumber - 1;
-
-    if (fieldNumber >= getNumberOfFields() || fieldNumber < 0) {
-        qCritical() << "LdDecodeMetaData::getFieldVbi(): Requested field number" << sequentialFieldNumber << "out of bounds!";
-    }
-
-    if (json.size({"fields", fieldNumber, "vbi"}) > 0) {
-        // Mark VBI as in use
-        vbi.inUse = true;
-
-        vbi.vbiData.append(json.value({"fields", fieldNumber, "vbi", "vbiData", 0}).toInt()); // Line 16
-        vbi.vbiData.append(json.value({"fields", fieldNumber, "vbi", "vbiData", 1}).toInt()); // Line 17
-        vbi.vbiData.append(json.value({"fields", fieldNumber, "vbi", "vbiData", 2}).toInt()); // Line 18
-    } else {
-        // Mark VBI as undefined
-        vbi.inUse = false;
-
+    Field *field = getFieldPointer(sequentialFieldNumber, false, "LdDecodeMetaData::getFieldVbi():");
+    if (field == nullptr) {
         // Resize the VBI data fields to prevent assert issues downstream
+        Vbi vbi;
         vbi.vbiData.resize(3);
+        return vbi;
     }
 
-    return vbi;
+    return field->vbi;
 }
 
 // This method gets the NTSC metadata for the specified sequential field number
 LdDecodeMetaData::Ntsc LdDecodeMetaData::getFieldNtsc(qint32 sequentialFieldNumber)
 {
-    Ntsc ntsc;
-    qint32 fieldNumber = sequentialFieldNumber - 1;
-
-    if (fieldNumber >= getNumberOfFields() || fieldNumber < 0) {
-        qCritical() << "LdDecodeMetaData::getFieldNtsc(): Requested field number" << sequentialFieldNumber << "out of bounds!";
-    }
+    Field *field = getFieldPointer(sequentialFieldNumber, false, "LdDecodeMetaData::getFieldNtsc():");
+    if (field == nullptr) return Ntsc();
 
-    if (json.size({"fields", fieldNumber, "ntsc"}) > 0) {
-        // Mark as in use
-        ntsc.inUse = true;
-
-        ntsc.isFmCodeDataValid = json.value({"fields", fieldNumber, "ntsc", "isFmCodeDataValid"}).toBool();
-        ntsc.fmCodeData = json.value({"fields", fieldNumber, "ntsc", "fmCodeData"}).toInt();
-        ntsc.fieldFlag = json.value({"fields", fieldNumber, "ntsc", "fieldFlag"}).toBool();
-        ntsc.whiteFlag = json.value({"fields", fieldNumber, "ntsc", "whiteFlag"}).toBool();
-        ntsc.ccData0 = json.value({"fields", fieldNumber, "ntsc", "ccData0"}).toInt();
-        ntsc.ccData1 = json.value({"fields", fieldNumber, "ntsc", "ccData1"}).toInt();
-    } else {
-        // Mark ntscSpecific as undefined
-        ntsc.inUse = false;
-    }
-
-    return ntsc;
+    return field->ntsc;
 }
 
 // This method gets the drop-out metadata for the specified sequential field number
 DropOuts LdDecodeMetaData::getFieldDropOuts(qint32 sequentialFieldNumber)
 {
-    DropOuts dropOuts;
-    qint32 fieldNumber = sequentialFieldNumber - 1;
+    Field *field = getFieldPointer(sequentialFieldNumber, false, "LdDecodeMetaData::getFieldDropOuts():");
+    if (field == nullptr) return DropOuts();
 
-    if (fieldNumber >= getNumberOfFields() || fieldNumber < 0) {
-        qCritical() << "LdDecodeMetaData::getFieldDropOuts(): Requested field number" << sequentialFieldNumber << "out of bounds!";
-    }
-
-    // Get the JSON array sizes
-    qint32 startxSize = json.size({"fields", fieldNumber, "dropOuts", "startx"});
-    qint32 endxSize = json.size({"fields", fieldNumber, "dropOuts", "endx"});
-    qint32 fieldLinesSize = json.size({"fields", fieldNumber, "dropOuts", "fieldLines"});
-
-    // Ensure that all three objects are the same size
-    if (startxSize != endxSize && startxSize != fieldLinesSize) {
-        qCritical("JSON file is invalid: Dropouts object is illegal");
-    }
-
-    if (startxSize > 0) {
-        for (qint32 doCounter = 0; doCounter < startxSize; doCounter++) {
-            dropOuts.append(json.value({"fields", fieldNumber, "dropOuts", "startx", doCounter}).toInt(),
-                            json.value({"fields", fieldNumber, "dropOuts", "endx", doCounter}).toInt(),
-                            json.value({"fields", fieldNumber, "dropOuts", "fieldLine", doCounter}).toInt());
-        }
-    } else {
-        dropOuts.clear();
-    }
-
-    return dropOuts;
+    return field->dropOuts;
 }
 
 // This method sets the field metadata for a field
 void LdDecodeMetaData::updateField(LdDecodeMetaData::Field _field, qint32 sequentialFieldNumber)
 {
-    if (sequentialFieldNumber < 1) {
-        qCritical() << "LdDecodeMetaData::updateFieldVitsMetrics(): Requested field number" << sequentialFieldNumber << "out of bounds!";
-    }
-
-    qint32 fieldNumber = sequentialFieldNumber - 1;
-
-    // Write the field data
-    json.setValue({"fields", fieldNumber, "seqNo"}, sequentialFieldNumber);
-    json.setValue({"fields", fieldNumber, "isFirstField"}, _field.isFirstField);
-    json.setValue({"fields", fieldNumber, "syncConf"}, _field.syncConf);
-    json.setValue({"fields", fieldNumber, "medianBurstIRE"}, _field.medianBurstIRE);
-    json.setValue({"fields", fieldNumber, "fieldPhaseID"}, _field.fieldPhaseID);
-    json.setValue({"fields", fieldNumber, "audioSamples"}, _field.audioSamples);
+    Field *field = getFieldPointer(sequentialFieldNumber, true, "LdDecodeMetaData::updateField():");
+    if (field == nullptr) return;
+    invalidateFrameVbi();
+
+    // Write the primary field data
+    field->seqNo = sequentialFieldNumber;
+    field->isFirstField = _field.isFirstField;
+    field->syncConf = _field.syncConf;
+    field->medianBurstIRE = _field.medianBurstIRE;
+    field->fieldPhaseID = _field.fieldPhaseID;
+    field->audioSamples = _field.audioSamples;
+    field->diskLoc = _field.diskLoc;
+    field->fileLoc = _field.fileLoc;
+    field->decodeFaults = _field.decodeFaults;
 
     // Write the VITS metrics data if in use
     updateFieldVitsMetrics(_field.vitsMetrics, sequentialFieldNumber);
@@ -345,32 +1285,23 @@ void LdDecodeMetaData::updateField(LdDecodeMetaData::Field _field, qint32 sequen
     updateFieldDropOuts(_field.dropOuts, sequentialFieldNumber);
 
     // Padding flag
-    json.setValue({"fields", fieldNumber, "pad"}, _field.pad);
+    field->pad = _field.pad;
 }
 
 // This method sets the field VBI metadata for a field
 void LdDecodeMetaData::updateFieldVitsMetrics(LdDecodeMetaData::VitsMetrics _vitsMetrics, qint32 sequentialFieldNumber)
 {
-    qint32 fieldNumber = sequentialFieldNumber - 1;
-
-    if (fieldNumber >= getNumberOfFields() + 1 || fieldNumber < 0) {
-        qCritical() << "LdDecodeMetaData::updateFieldVitsMetrics(): Requested field number" << sequentialFieldNumber << "out of bounds!";
-    }
+    Field *field = getFieldPointer(sequentialFieldNumber, true, "LdDecodeMetaData::updateFieldVitsMetrics():");
+    if (field == nullptr) return;
 
-    if (_vitsMetrics.inUse) {
-        json.setValue({"fields", fieldNumber, "vitsMetrics", "wSNR"}, _vitsMetrics.wSNR);
-        json.setValue({"fields", fieldNumber, "vitsMetrics", "bPSNR"}, _vitsMetrics.bPSNR);
-    }
+    if (_vitsMetrics.inUse) field->vitsMetrics = _vitsMetrics;
 }
 
 // This method sets the field VBI metadata for a field
 void LdDecodeMetaData::updateFieldVbi(LdDecodeMetaData::Vbi _vbi, qint32 sequentialFieldNumber)
 {
-    qint32 fieldNumber = sequentialFieldNumber - 1;
-
-    if (fieldNumber >= getNumberOfFields() + 1 || fieldNumber < 0) {
-        qCritical() << "LdDecodeMetaData::updateFieldVbi(): Requested field number" << sequentialFieldNumber << "out of bounds!";
-    }
+    Field *field = getFieldPointer(sequentialFieldNumber, true, "LdDecodeMetaData::updateFieldVbi():");
+    if (field == nullptr) return;
 
     if (_vbi.inUse) {
         // Validate the VBI data array
@@ -382,89 +1313,58 @@ void LdDecodeMetaData::updateFieldVbi(LdDecodeMetaData::Vbi _vbi, qint32 sequent
             _vbi.vbiData[2] = -1;
         }
 
-        json.setValue({"fields", fieldNumber, "vbi", "vbiData", 0}, _vbi.vbiData[0]);
-        json.setValue({"fields", fieldNumber, "vbi", "vbiData", 1}, _vbi.vbiData[1]);
-        json.setValue({"fields", fieldNumber, "vbi", "vbiData", 2}, _vbi.vbiData[2]);
+        field->vbi = _vbi;
+        invalidateFrameVbi();
     }
 }
 
 // This method sets the field NTSC metadata for a field
 void LdDecodeMetaData::updateFieldNtsc(LdDecodeMetaData::Ntsc _ntsc, qint32 sequentialFieldNumber)
 {
-    qint32 fieldNumber = sequentialFieldNumber - 1;
-
-    if (fieldNumber >= getNumberOfFields() + 1 || fieldNumber < 0) {
-        qCritical() << "LdDecodeMetaData::updateFieldNtsc(): Requested field number" << sequentialFieldNumber << "out of bounds!";
-    }
+    Field *field = getFieldPointer(sequentialFieldNumber, true, "LdDecodeMetaData::updateFieldNtsc():");
+    if (field == nullptr) return;
 
     if (_ntsc.inUse) {
-        json.setValue({"fields", fieldNumber, "ntsc", "isFmCodeDataValid"}, _ntsc.isFmCodeDataValid);
-        if (_ntsc.isFmCodeDataValid)
-            json.setValue({"fields", fieldNumber, "ntsc", "fmCodeData"}, _ntsc.fmCodeData);
-        else json.setValue({"fields", fieldNumber, "ntsc", "fmCodeData"}, -1);
-        json.setValue({"fields", fieldNumber, "ntsc", "fieldFlag"}, _ntsc.fieldFlag);
-        json.setValue({"fields", fieldNumber, "ntsc", "whiteFlag"}, _ntsc.whiteFlag);
-        json.setValue({"fields", fieldNumber, "ntsc", "ccData0"}, _ntsc.ccData0);
-        json.setValue({"fields", fieldNumber, "ntsc", "ccData1"}, _ntsc.ccData1);
+        if (!_ntsc.isFmCodeDataValid) _ntsc.fmCodeData = -1;
+        field->ntsc = _ntsc;
     }
 }
 
 // This method sets the field dropout metadata for a field
 void LdDecodeMetaData::updateFieldDropOuts(DropOuts _dropOuts, qint32 sequentialFieldNumber)
 {
-    qint32 fieldNumber = sequentialFieldNumber - 1;
+    Field *field = getFieldPointer(sequentialFieldNumber, true, "LdDecodeMetaData::updateFieldDropOuts():");
+    if (field == nullptr) return;
 
-    if (fieldNumber >= getNumberOfFields() + 1 || fieldNumber < 0) {
-        qCritical() << "LdDecodeMetaData::updateFieldDropOuts(): Requested field number" << sequentialFieldNumber << "out of bounds!";
-    }
-
-    if (_dropOuts.size() != 0) {
-        // Populate the arrays with the drop out metadata
-        for (qint32 doCounter = 0; doCounter < _dropOuts.size(); doCounter++) {
-            json.setValue({"fields", fieldNumber, "dropOuts", "startx", doCounter}, _dropOuts.startx(doCounter));
-            json.setValue({"fields", fieldNumber, "dropOuts", "endx", doCounter}, _dropOuts.endx(doCounter));
-            json.setValue({"fields", fieldNumber, "dropOuts", "fieldLine", doCounter}, _dropOuts.fieldLine(doCounter));
-        }
-    } else {
-        // If updated dropouts is empty, clear the field's dropouts
-        clearFieldDropOuts(sequentialFieldNumber);
-    }
+    // Note: If the updated dropouts are empty, this clears the field's dropouts
+    field->dropOuts = _dropOuts;
 }
 
 // This method clears the field dropout metadata for a field
 void LdDecodeMetaData::clearFieldDropOuts(qint32 sequentialFieldNumber)
 {
-    qint32 fieldNumber = sequentialFieldNumber - 1;
-
-    if (fieldNumber >= getNumberOfFields() + 1 || fieldNumber < 0) {
-        qCritical() << "LdDecodeMetaData::updateFieldDropOuts(): Requested field number" << sequentialFieldNumber << "out of bounds!";
-    }
+    Field *field = getFieldPointer(sequentialFieldNumber, true, "LdDecodeMetaData::clearFieldDropOuts():");
+    if (field == nullptr) return;
 
-    json.remove({"fields", fieldNumber, "dropOuts", "startx"});
-    json.remove({"fields", fieldNumber, "dropOuts", "endx"});
-    json.remove({"fields", fieldNumber, "dropOuts", "fieldLine"});
+    field->dropOuts.clear();
 }
 
 // This method appends a new field to the existing metadata
 void LdDecodeMetaData::appendField(LdDecodeMetaData::Field _field)
 {
-    // Get the field number (and adjust to 0 if there are no fields in the JSON)
-    qint32 fieldNumber = getNumberOfFields();
-    if (fieldNumber < 0) fieldNumber = 0;
-
-    updateField(_field, fieldNumber + 1);
+    updateField(_field, metaData.fields.size() + 1);
 }
 
 // Method to get the available number of fields (according to the metadata)
 qint32 LdDecodeMetaData::getNumberOfFields()
 {
-    return json.size({"fields"});
+    return metaData.fields.size();
 }
 
 // Method to set the available number of fields
 void LdDecodeMetaData::setNumberOfFields(qint32 numberOfFields)
 {
-    json.setValue({"videoParameters", "numberOfSequentialFields"}, numberOfFields);
+    metaData.videoParameters.numberOfSequentialFields = numberOfFields;
 }
 
 // A note about fields, frames and still-frames:
@@ -622,6 +1522,7 @@ qint32 LdDecodeMetaData::getSecondFieldNumber(qint32 frameNumber)
 // Method to set the isFirstFieldFirst flag
 void LdDecodeMetaData::setIsFirstFieldFirst(bool flag)
 {
+    if (flag != isFirstFieldFirst) invalidateFrameVbi();
     isFirstFieldFirst = flag;
 }
 
@@ -631,6 +1532,225 @@ bool LdDecodeMetaData::getIsFirstFieldFirst()
     return isFirstFieldFirst;
 }
 
+namespace {
+    // Minimum number of frames for each VBI decoding thread
+    const qint32 MIN_FRAMES_PER_THREAD = 5000;
+
+    // Thread that decodes the VBI for a range of frames
+    class FrameVbiDecoderThread : public QThread
+    {
+    public:
+        FrameVbiDecoderThread(const QVector<LdDecodeMetaData::Field> &_fields, const QVector<qint32> &_firstFields,
+                              const QVector<qint32> &_secondFields, VbiDecoder::Vbi *_output,
+                              qint32 _startFrame, qint32 _endFrame)
+            : fields(_fields), firstFields(_firstFields), secondFields(_secondFields), output(_output),
+              startFrame(_startFrame), endFrame(_endFrame)
+        {
+        }
+
+    protected:
+        void run() override
+        {
+            VbiDecoder vbiDecoder;
+            for (qint32 frame = startFrame; frame < endFrame; frame++) {
+                const qint32 firstField = firstFields[frame];
+                const qint32 secondField = secondFields[frame];
+
+                // Leave the default (unknown) VBI if the frame's fields couldn't be found
+                if (firstField < 1 || secondField < 1 || firstField > fields.size() || secondField > fields.size()) {
+                    continue;
+                }
+
+                const QVector<qint32> &vbi1 = fields[firstField - 1].vbi.vbiData;
+                const QVector<qint32> &vbi2 = fields[secondField - 1].vbi.vbiData;
+                if (vbi1.size() < 3 || vbi2.size() < 3) continue;
+
+                output[frame] = vbiDecoder.decodeFrame(vbi1[0], vbi1[1], vbi1[2], vbi2[0], vbi2[1], vbi2[2]);
+            }
+        }
+
+    private:
+        const QVector<LdDecodeMetaData::Field> &fields;
+        const QVector<qint32> &firstFields;
+        const QVector<qint32> &secondFields;
+        VbiDecoder::Vbi *output;
+        qint32 startFrame;
+        qint32 endFrame;
+    };
+}
+
+// Method to get the decoded VBI for a frame (indexed from 1)
+VbiDecoder::Vbi LdDecodeMetaData::getFrameVbi(qint32 frameNumber)
+{
+    const QVector<VbiDecoder::Vbi> &table = getFrameVbiTable();
+
+    if (frameNumber < 1 || frameNumber > table.size()) {
+        qCritical() << "LdDecodeMetaData::getFrameVbi(): Requested frame number" << frameNumber << "out of bounds!";
+        return VbiDecoder::Vbi();
+    }
+
+    return table[frameNumber - 1];
+}
+
+// Method to get the decoded VBI for all frames (indexed from 0)
+// Note: The returned reference is only valid until the metadata is next changed
+const QVector<VbiDecoder::Vbi> &LdDecodeMetaData::getFrameVbiTable()
+{
+    if (!isFrameVbiValid) buildFrameVbi();
+
+    return frameVbi;
+}
+
+// Private method to decode the VBI for every frame into the cache
+void LdDecodeMetaData::buildFrameVbi()
+{
+    const qint32 numberOfFrames = metaData.fields.isEmpty() ? 0 : qMax(0, getNumberOfFrames());
+
+    // Find each frame's fields. This is cheap compared to decoding, and
+    // getFieldNumber depends on the field order, so do it serially first.
+    QVector<qint32> firstFields(numberOfFrames);
+    QVector<qint32> secondFields(numberOfFrames);
+    for (qint32 frame = 0; frame < numberOfFrames; frame++) {
+        firstFields[frame] = getFirstFieldNumber(frame + 1);
+        secondFields[frame] = getSecondFieldNumber(frame + 1);
+    }
+
+    // Decode the frames in parallel, each thread writing its own range of the table
+    frameVbi.clear();
+    frameVbi.resize(numberOfFrames);
+    VbiDecoder::Vbi *output = frameVbi.data();
+
+    const qint32 numberOfThreads = qBound(1, numberOfFrames / MIN_FRAMES_PER_THREAD, QThread::idealThreadCount());
+    QVector<FrameVbiDecoderThread *> threads(numberOfThreads);
+    for (qint32 i = 0; i < numberOfThreads; i++) {
+        const qint32 startFrame = static_cast<qint32>((static_cast<qint64>(numberOfFrames) * i) / numberOfThreads);
+        const qint32 endFrame = static_cast<qint32>((static_cast<qint64>(numberOfFrames) * (i + 1)) / numberOfThreads);
+        threads[i] = new FrameVbiDecoderThread(metaData.fields, firstFields, secondFields, output, startFrame, endFrame);
+        threads[i]->start();
+    }
+
+    for (qint32 i = 0; i < numberOfThreads; i++) {
+        threads[i]->wait();
+        delete threads[i];
+    }
+
+    isFrameVbiValid = true;
+
+    buildSeekIndex(firstFields);
+}
+
+// Private method to discard the cached frame VBI and seek index
+void LdDecodeMetaData::invalidateFrameVbi()
+{
+    isFrameVbiValid = false;
+    isSeekIndexValid = false;
+}
+
+// Private method to build the seek index from the frame VBI
+void LdDecodeMetaData::buildSeekIndex(const QVector<qint32> &firstFields)
+{
+    pictureNumberIndex.clear();
+    clvTimecodeIndex.clear();
+    chapterStarts.clear();
+
+    qint32 lastChapter = -1;
+    for (qint32 frame = 0; frame < frameVbi.size(); frame++) {
+        const VbiDecoder::Vbi &vbi = frameVbi[frame];
+
+        SeekIndexEntry entry;
+        entry.frameNumber = frame + 1;
+        entry.fieldNumber = firstFields[frame];
+
+        if (vbi.picNo != -1) {
+            entry.code = vbi.picNo;
+            pictureNumberIndex.append(entry);
+        }
+
+        // Only complete timecodes can be converted (and that needs the video parameters)
+        if (isVideoParametersValid && vbi.clvHr != -1 && vbi.clvMin != -1 && vbi.clvSec != -1 && vbi.clvPicNo != -1) {
+            ClvTimecode clvTimecode;
+            clvTimecode.hours = vbi.clvHr;
+            clvTimecode.minutes = vbi.clvMin;
+            clvTimecode.seconds = vbi.clvSec;
+            clvTimecode.pictureNumber = vbi.clvPicNo;
+            entry.code = convertClvTimecodeToFrameNumber(clvTimecode);
+            clvTimecodeIndex.append(entry);
+        }
+
+        if (vbi.chNo != -1 && vbi.chNo != lastChapter) {
+            entry.code = vbi.chNo;
+            chapterStarts.append(entry);
+            lastChapter = vbi.chNo;
+        }
+    }
+
+    // Sort the codes, keeping only the first frame for each
+    auto byCode = [](const SeekIndexEntry &a, const SeekIndexEntry &b) { return a.code < b.code; };
+    auto sameCode = [](const SeekIndexEntry &a, const SeekIndexEntry &b) { return a.code == b.code; };
+    std::stable_sort(pictureNumberIndex.begin(), pictureNumberIndex.end(), byCode);
+    pictureNumberIndex.erase(std::unique(pictureNumberIndex.begin(), pictureNumberIndex.end(), sameCode),
+                             pictureNumberIndex.end());
+    std::stable_sort(clvTimecodeIndex.begin(), clvTimecodeIndex.end(), byCode);
+    clvTimecodeIndex.erase(std::unique(clvTimecodeIndex.begin(), clvTimecodeIndex.end(), sameCode),
+                           clvTimecodeIndex.end());
+
+    qDebug() << "LdDecodeMetaData::buildSeekIndex(): Indexed" << pictureNumberIndex.size() << "picture numbers,"
+             << clvTimecodeIndex.size() << "CLV timecodes and" << chapterStarts.size() << "chapter starts";
+
+    isSeekIndexValid = true;
+}
+
+// Private method to find the first entry with a code of at least the one given
+LdDecodeMetaData::SeekIndexEntry LdDecodeMetaData::findInSeekIndex(const QVector<SeekIndexEntry> &index, qint32 code)
+{
+    auto it = std::lower_bound(index.begin(), index.end(), code,
+                               [](const SeekIndexEntry &entry, qint32 value) { return entry.code < value; });
+    if (it == index.end()) return SeekIndexEntry();
+
+    return *it;
+}
+
+// Method to find the frame with a CAV picture number
+LdDecodeMetaData::SeekIndexEntry LdDecodeMetaData::findPictureNumber(qint32 pictureNumber)
+{
+    if (!isSeekIndexValid) buildFrameVbi();
+
+    return findInSeekIndex(pictureNumberIndex, pictureNumber);
+}
+
+// Method to find the frame with a CLV timecode
+LdDecodeMetaData::SeekIndexEntry LdDecodeMetaData::findClvTimecode(LdDecodeMetaData::ClvTimecode clvTimecode)
+{
+    if (!isSeekIndexValid) buildFrameVbi();
+
+    const qint32 clvFrameNumber = convertClvTimecodeToFrameNumber(clvTimecode);
+    if (clvFrameNumber == -1) return SeekIndexEntry();
+
+    return findInSeekIndex(clvTimecodeIndex, clvFrameNumber);
+}
+
+// Method to find the start of a chapter
+// Note: Chapter numbers aren't necessarily in order on the disc, so this is
+// an exact match rather than a search
+LdDecodeMetaData::SeekIndexEntry LdDecodeMetaData::findChapter(qint32 chapter)
+{
+    if (!isSeekIndexValid) buildFrameVbi();
+
+    for (const SeekIndexEntry &entry : chapterStarts) {
+        if (entry.code == chapter) return entry;
+    }
+
+    return SeekIndexEntry();
+}
+
+// Method to get the chapter starts, in frame order
+const QVector<LdDecodeMetaData::SeekIndexEntry> &LdDecodeMetaData::getChapterStarts()
+{
+    if (!isSeekIndexValid) buildFrameVbi();
+
+    return chapterStarts;
+}
+
 // Method to convert a CLV time code into an equivalent frame number (to make
 // processing the timecodes easier)
 qint32 LdDecodeMetaData::convertClvTimecodeToFrameNumber(LdDecodeMetaData::ClvTimecode clvTimeCode)
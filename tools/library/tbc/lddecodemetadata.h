@@ -29,21 +29,28 @@
 #include <QTemporaryFile>
 #include <QDebug>
 
-#include "../JsonWax/JsonWax.h"
 #include "vbidecoder.h"
 #include "dropouts.h"
 
+class JsonReader;
+
 class LdDecodeMetaData
 {
 
 public:
 
+    // Note: otherMembers in the structures below holds any members of the
+    // corresponding JSON object that the tools don't use (e.g. the extra
+    // metrics ld-decode writes in verbose mode), as JSON text in the form
+    // "name":value,"name":value -- so they are written out again unchanged
+
     // VBI Metadata definition
     struct Vbi {
         Vbi() : inUse(false) {}
 
         bool inUse;
         QVector<qint32> vbiData;
+        QByteArray otherMembers;
     };
 
     // Video metadata definition
@@ -75,6 +82,8 @@ public:
         qint32 lastActiveFieldLine;
         qint32 firstActiveFrameLine;
         qint32 lastActiveFrameLine;
+
+        QByteArray otherMembers;
     };
 
     // VITS metrics metadata definition
@@ -84,6 +93,7 @@ public:
         bool inUse;
         qreal wSNR;
         qreal bPSNR;
+        QByteArray otherMembers;
     };
 
     // NTSC Specific metadata definition
@@ -98,6 +108,7 @@ public:
         bool whiteFlag;
         qint32 ccData0;
         qint32 ccData1;
+        QByteArray otherMembers;
     };
 
     // PCM sound metadata definition
@@ -106,12 +117,16 @@ public:
         bool isLittleEndian;
         bool isSigned;
         qint32 bits;
+        QByteArray otherMembers;
     };
 
     // Field metadata definition
+    // Note: diskLoc, fileLoc and decodeFaults are only written by ld-decode;
+    // they are -1 if not present
     struct Field {
         Field() : seqNo(0), isFirstField(false), syncConf(0), medianBurstIRE(0),
-            fieldPhaseID(0), audioSamples(0), pad(false) {}
+            fieldPhaseID(0), audioSamples(0), diskLoc(-1), fileLoc(-1), decodeFaults(-1),
+            pad(false) {}
 
         qint32 seqNo;       // Note: This is the unique primary-key
         bool isFirstField;
@@ -119,12 +134,16 @@ public:
         qreal medianBurstIRE;
         qint32 fieldPhaseID;
         qint32 audioSamples;
+        qreal diskLoc;
+        qint64 fileLoc;
+        qint32 decodeFaults;
 
         VitsMetrics vitsMetrics;
         Vbi vbi;
         Ntsc ntsc;
         DropOuts dropOuts;
         bool pad;
+        QByteArray otherMembers;
     };
 
     // Overall metadata definition
@@ -132,6 +151,7 @@ public:
         VideoParameters videoParameters;
         PcmAudioParameters pcmAudioParameters;
         QVector<Field> fields;
+        QByteArray otherMembers;
     };
 
     // CLV timecode (used by frame number conversion methods)
@@ -142,6 +162,13 @@ public:
         qint32 pictureNumber;
     };
 
+    // Seek index entry, giving the first frame in which a VBI code appears
+    struct SeekIndexEntry {
+        qint32 code = -1;           // CAV picture number, CLV frame number or chapter number
+        qint32 frameNumber = -1;    // Sequential frame number (indexed from 1)
+        qint32 fieldNumber = -1;    // Sequential field number of the frame's first field
+    };
+
     LdDecodeMetaData();
 
     // Prevent copying or assignment
@@ -183,14 +210,61 @@ public:
     void setIsFirstFieldFirst(bool flag);
     bool getIsFirstFieldFirst();
 
+    // Get the decoded VBI for a frame (indexed from 1), or for all frames
+    // (indexed from 0). These are decoded when first needed, and cached until
+    // the field metadata or field order changes.
+    VbiDecoder::Vbi getFrameVbi(qint32 frameNumber);
+    const QVector<VbiDecoder::Vbi> &getFrameVbiTable();
+
+    // Seek using the VBI. Picture number and timecode lookups return the
+    // first indexed frame with a code greater than or equal to the one
+    // requested (so check the entry's code if you need an exact match);
+    // chapter lookups return the first start of that chapter. If there's no
+    // such frame, the entry's frame number is -1.
+    SeekIndexEntry findPictureNumber(qint32 pictureNumber);
+    SeekIndexEntry findClvTimecode(LdDecodeMetaData::ClvTimecode clvTimecode);
+    SeekIndexEntry findChapter(qint32 chapter);
+    const QVector<SeekIndexEntry> &getChapterStarts();
+
     qint32 convertClvTimecodeToFrameNumber(LdDecodeMetaData::ClvTimecode clvTimeCode);
     LdDecodeMetaData::ClvTimecode convertFrameNumberToClvTimecode(qint32 clvFrameNumber);
 
 private:
-    JsonWax json;
+    MetaData metaData;
+    bool isVideoParametersValid;
+    bool isPcmAudioParametersValid;
     bool isFirstFieldFirst;
+    bool isFrameVbiValid;
+    QVector<VbiDecoder::Vbi> frameVbi;
+
+    // Seek index, sorted by code (except chapterStarts, which is in frame order)
+    bool isSeekIndexValid;
+    QVector<SeekIndexEntry> pictureNumberIndex;
+    QVector<SeekIndexEntry> clvTimecodeIndex;
+    QVector<SeekIndexEntry> chapterStarts;
 
     qint32 getFieldNumber(qint32 frameNumber, qint32 field);
+    Field *getFieldPointer(qint32 sequentialFieldNumber, bool forUpdate, const char *caller);
+
+    bool readJson(QString fileName);
+    static void readVideoParameters(JsonReader &reader, VideoParameters &videoParameters, bool &isValid);
+    static void readPcmAudioParameters(JsonReader &reader, PcmAudioParameters &pcmAudioParameters, bool &isValid);
+    static void readFields(JsonReader &reader, QVector<Field> &fields);
+    static void readField(JsonReader &reader, Field &field);
+
+    static QString getJournalFileName(QString fileName);
+    bool readJournal(QString fileName);
+    bool writeJson(QString fileName);
+
+    // Sidecar index file (see lddecodemetadata.cpp)
+    static QString getSidecarFileName(QString fileName);
+    bool readSidecar(QString fileName);
+    bool writeSidecar(QString fileName);
+
+    void invalidateFrameVbi();
+    void buildFrameVbi();
+    void buildSeekIndex(const QVector<qint32> &firstFields);
+    static SeekIndexEntry findInSeekIndex(const QVector<SeekIndexEntry> &index, qint32 code);
 };
 
 #endif // LDDECODEMETADATA_H
@@ -0,0 +1,181 @@
+/************************************************************************
+
+    multisourcereader.cpp
+
+    ld-decode-tools TBC library
+    Copyright (C) 2026 agent
+
+    This file is part of ld-decode-tools.
+
+    ld-decode-tools is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+************************************************************************/
+
+#include "multisourcereader.h"
+
+#include "stagestats.h"
+
+#include <QThread>
+
+// Thread that reads the fields for one source
+class MultiSourceReaderThread : public QThread
+{
+public:
+    MultiSourceReaderThread(MultiSourceReader &_reader, qint32 _sourceNo)
+        : reader(_reader), sourceNo(_sourceNo)
+    {
+    }
+
+protected:
+    void run() override
+    {
+        reader.readSource(sourceNo);
+    }
+
+private:
+    MultiSourceReader &reader;
+    qint32 sourceNo;
+};
+
+MultiSourceReader::MultiSourceReader(qint32 _maxPrefetch)
+    : maxPrefetch(qMax(_maxPrefetch, 1)), stopping(false)
+{
+}
+
+MultiSourceReader::~MultiSourceReader()
+{
+    stop();
+}
+
+void MultiSourceReader::start(const QVector<SourceVideo *> &_sourceVideos, const QVector<FrameFields> &_frames)
+{
+    stop();
+
+    sourceVideos = _sourceVideos;
+    frames = _frames;
+    pendingFrames.clear();
+    stopping = false;
+
+    // Start one thread per source
+    threads.resize(sourceVideos.size());
+    for (qint32 sourceNo = 0; sourceNo < sourceVideos.size(); sourceNo++) {
+        threads[sourceNo] = new MultiSourceReaderThread(*this, sourceNo);
+        threads[sourceNo]->start();
+    }
+}
+
+bool MultiSourceReader::getFrame(qint32 frameIndex, QVector<SourceVideo::Data> &firstFieldVideoData,
+                                 QVector<SourceVideo::Data> &secondFieldVideoData)
+{
+    if (frameIndex < 0 || frameIndex >= frames.size()) {
+        qCritical() << "MultiSourceReader::getFrame(): Frame index" << frameIndex << "is out of range";
+        return false;
+    }
+
+    // With no sources, there's nothing that would ever complete the frame
+    if (sourceVideos.isEmpty()) {
+        qCritical() << "MultiSourceReader::getFrame(): There are no sources to read from";
+        return false;
+    }
+
+    QMutexLocker locker(&mutex);
+
+    // Wait until all the sources have been read
+    while (!stopping) {
+        if (pendingFrames.contains(frameIndex) && pendingFrames[frameIndex].remainingSources == 0) {
+            firstFieldVideoData = pendingFrames[frameIndex].firstFieldVideoData;
+            secondFieldVideoData = pendingFrames[frameIndex].secondFieldVideoData;
+            pendingFrames.remove(frameIndex);
+
+            // Let the reading threads move on
+            frameTaken.wakeAll();
+            return true;
+        }
+
+        frameRead.wait(&mutex);
+    }
+
+    return false;
+}
+
+void MultiSourceReader::stop()
+{
+    {
+        QMutexLocker locker(&mutex);
+        stopping = true;
+        frameRead.wakeAll();
+        frameTaken.wakeAll();
+    }
+
+    for (qint32 i = 0; i < threads.size(); i++) {
+        threads[i]->wait();
+        delete threads[i];
+    }
+    threads.clear();
+}
+
+// Read the fields for one source. Called by that source's thread.
+void MultiSourceReader::readSource(qint32 sourceNo)
+{
+    SourceVideo *sourceVideo = sourceVideos[sourceNo];
+
+    for (qint32 frameIndex = 0; frameIndex < frames.size(); frameIndex++) {
+        const qint32 firstFieldNumber = frames[frameIndex].firstFieldNumber[sourceNo];
+        const qint32 secondFieldNumber = frames[frameIndex].secondFieldNumber[sourceNo];
+
+        {
+            QMutexLocker locker(&mutex);
+
+            // The first source to reach a frame creates its entry -- but only
+            // once there's space for it. The slower sources will always find
+            // the entry for their next frame already exists, so they never wait.
+            while (!stopping && !pendingFrames.contains(frameIndex) && pendingFrames.size() >= maxPrefetch) {
+                frameTaken.wait(&mutex);
+            }
+            if (stopping) return;
+
+            if (!pendingFrames.contains(frameIndex)) {
+                PendingFrame &pendingFrame = pendingFrames[frameIndex];
+                pendingFrame.firstFieldVideoData.resize(sourceVideos.size());
+                pendingFrame.secondFieldVideoData.resize(sourceVideos.size());
+                pendingFrame.remainingSources = sourceVideos.size();
+            }
+        }
+
+        // Read the fields (in TBC sequence order to save seeking)
+        StageTimer readTimer("read");
+        SourceVideo::Data firstFieldVideoData;
+        SourceVideo::Data secondFieldVideoData;
+        if (firstFieldNumber < secondFieldNumber) {
+            if (firstFieldNumber != -1) firstFieldVideoData = sourceVideo->getVideoField(firstFieldNumber);
+            if (secondFieldNumber != -1) secondFieldVideoData = sourceVideo->getVideoField(secondFieldNumber);
+        } else {
+            if (secondFieldNumber != -1) secondFieldVideoData = sourceVideo->getVideoField(secondFieldNumber);
+            if (firstFieldNumber != -1) firstFieldVideoData = sourceVideo->getVideoField(firstFieldNumber);
+        }
+        readTimer.stop();
+
+        {
+            QMutexLocker locker(&mutex);
+
+            // The entry can't have been taken yet, as this source hasn't finished it
+            PendingFrame &pendingFrame = pendingFrames[frameIndex];
+            pendingFrame.firstFieldVideoData[sourceNo] = firstFieldVideoData;
+            pendingFrame.secondFieldVideoData[sourceNo] = secondFieldVideoData;
+            pendingFrame.remainingSources--;
+
+            if (pendingFrame.remainingSources == 0) frameRead.wakeAll();
+        }
+    }
+}
@@ -0,0 +1,105 @@
+/************************************************************************
+
+    multisourcereader.h
+
+    ld-decode-tools TBC library
+    Copyright (C) 2026 agent
+
+    This file is part of ld-decode-tools.
+
+    ld-decode-tools is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+************************************************************************/
+
+#ifndef MULTISOURCEREADER_H
+#define MULTISOURCEREADER_H
+
+#include <QMap>
+#include <QMutex>
+#include <QVector>
+#include <QWaitCondition>
+
+#include "sourcevideo.h"
+
+class MultiSourceReaderThread;
+
+// Reads frames from several TBC sources in parallel, ahead of the threads
+// that process them.
+//
+// The caller supplies a list of frames to read, giving the field numbers to
+// read from each source for each frame. Each source is read by its own
+// thread, working through the list in order, so a slow source only delays
+// the frames it's needed for rather than all reads. Up to maxPrefetch frames
+// are buffered; once that many are waiting, the reading threads stop until
+// workers take some of them.
+//
+// While the reader is running, the SourceVideo objects must not be used by
+// anything else.
+class MultiSourceReader
+{
+public:
+    // The fields to read for a frame. Both vectors have one entry per
+    // source; sources with a field number of -1 aren't read.
+    struct FrameFields {
+        QVector<qint32> firstFieldNumber;
+        QVector<qint32> secondFieldNumber;
+    };
+
+    MultiSourceReader(qint32 maxPrefetch);
+    ~MultiSourceReader();
+
+    // Prevent copying or assignment
+    MultiSourceReader(const MultiSourceReader &) = delete;
+    MultiSourceReader& operator=(const MultiSourceReader &) = delete;
+
+    // Start reading the given frames from the given sources
+    void start(const QVector<SourceVideo *> &sourceVideos, const QVector<FrameFields> &frames);
+
+    // Wait for a frame (an index into the list given to start) to be read,
+    // and return its field data. Each frame can only be taken once. Sources
+    // that weren't read return empty data.
+    //
+    // Returns false if the reader has been stopped, or has no sources.
+    bool getFrame(qint32 frameIndex, QVector<SourceVideo::Data> &firstFieldVideoData,
+                  QVector<SourceVideo::Data> &secondFieldVideoData);
+
+    // Stop the reading threads, and wait for them to finish
+    void stop();
+
+private:
+    friend class MultiSourceReaderThread;
+
+    // A frame that's being read or waiting to be taken
+    struct PendingFrame {
+        QVector<SourceVideo::Data> firstFieldVideoData;
+        QVector<SourceVideo::Data> secondFieldVideoData;
+        qint32 remainingSources;
+    };
+
+    QVector<SourceVideo *> sourceVideos;
+    qint32 maxPrefetch;
+    QVector<FrameFields> frames;
+    QVector<MultiSourceReaderThread *> threads;
+
+    // Shared state (all guarded by mutex while threads are running)
+    QMutex mutex;
+    QWaitCondition frameRead;
+    QWaitCondition frameTaken;
+    QMap<qint32, PendingFrame> pendingFrames;
+    bool stopping;
+
+    void readSource(qint32 sourceNo);
+};
+
+#endif // MULTISOURCEREADER_H
@@ -0,0 +1,416 @@
+/************************************************************************
+
+    stagestats.cpp
+
+    ld-decode-tools TBC library
+    Copyright (C) 2026 agent
+
+    This file is part of ld-decode-tools.
+
+    ld-decode-tools is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+************************************************************************/
+
+#include "stagestats.h"
+
+#include "jsonwriter.h"
+
+#include <QAtomicInteger>
+#include <QCoreApplication>
+#include <QDebug>
+#include <QMap>
+#include <QMutex>
+#include <QSaveFile>
+#include <QThread>
+#include <QVector>
+#include <QWaitCondition>
+
+#include <cstring>
+
+namespace {
+    // The accumulated measurements for one stage or counter in one thread.
+    // Only the owning thread writes to these, but other threads may read
+    // them while a report is being written, so they're atomic.
+    struct Slot {
+        Slot(const char *_name) : name(_name), calls(0), total(0) {}
+
+        const char *name;
+        QAtomicInteger<qint64> calls;
+        QAtomicInteger<qint64> total;
+    };
+
+    // The slots belonging to one thread
+    struct ThreadData {
+        qint32 index;
+        QVector<Slot *> stages;
+        QVector<Slot *> counters;
+    };
+
+    // Whether collection is enabled
+    QAtomicInt enabled(0);
+
+    // Time since collection was enabled
+    QElapsedTimer elapsedTimer;
+
+    // All the threads that have recorded anything. The ThreadData objects
+    // are never freed, so the statistics for threads that have finished are
+    // still available for the report. This also guards changes to the slot
+    // lists.
+    QMutex registryMutex;
+    QVector<ThreadData *> allThreads;
+
+    // The calling thread's data, once it's been registered
+    thread_local ThreadData *currentThreadData = nullptr;
+
+    // Report state (guarded by reportMutex)
+    QMutex reportMutex;
+    QString reportFileName;
+
+    ThreadData *getThreadData()
+    {
+        if (currentThreadData == nullptr) {
+            QMutexLocker locker(&registryMutex);
+            currentThreadData = new ThreadData;
+            currentThreadData->index = allThreads.size();
+            allThreads.append(currentThreadData);
+        }
+
+        return currentThreadData;
+    }
+
+    // Find the slot for name in one of the calling thread's lists, adding it
+    // if necessary
+    Slot *findSlot(QVector<Slot *> &slotList, const char *name)
+    {
+        // Usually the name will be the same literal as last time, so check
+        // the pointer before comparing the string
+        for (Slot *slot : slotList) {
+            if (slot->name == name || strcmp(slot->name, name) == 0) return slot;
+        }
+
+        QMutexLocker locker(&registryMutex);
+        Slot *slot = new Slot(name);
+        slotList.append(slot);
+        return slot;
+    }
+
+    // Totals for one stage or counter across all threads
+    struct Total {
+        Total() : calls(0), total(0) {}
+
+        qint64 calls;
+        qint64 total;
+    };
+
+    void addTotals(const QVector<Slot *> &slotList, QMap<QByteArray, Total> &totals)
+    {
+        for (const Slot *slot : slotList) {
+            Total &total = totals[QByteArray(slot->name)];
+            total.calls += slot->calls.loadAcquire();
+            total.total += slot->total.loadAcquire();
+        }
+    }
+
+    void clearSlots(const QVector<Slot *> &slotList)
+    {
+        for (Slot *slot : slotList) {
+            slot->calls.storeRelease(0);
+            slot->total.storeRelease(0);
+        }
+    }
+
+    // Has anything been recorded in these slots since the last reset?
+    bool anySlotUsed(const QVector<Slot *> &slotList)
+    {
+        for (const Slot *slot : slotList) {
+            if (slot->calls.loadAcquire() != 0) return true;
+        }
+
+        return false;
+    }
+
+    void writeStages(JsonWriter &writer, const QMap<QByteArray, Total> &stages)
+    {
+        writer.beginObject();
+        for (auto it = stages.constBegin(); it != stages.constEnd(); ++it) {
+            writer.writeMember(it.key().constData());
+            writer.beginObject();
+            writer.writeMember("calls");
+            writer.write(it.value().calls);
+            writer.writeMember("nsecs");
+            writer.write(it.value().total);
+            writer.endObject();
+        }
+        writer.endObject();
+    }
+
+    void writeCounters(JsonWriter &writer, const QMap<QByteArray, Total> &counters)
+    {
+        writer.beginObject();
+        for (auto it = counters.constBegin(); it != counters.constEnd(); ++it) {
+            writer.writeMember(it.key().constData());
+            writer.write(it.value().total);
+        }
+        writer.endObject();
+    }
+
+    // Write the report file, containing the current statistics. Snapshots
+    // and the final report both go through here, replacing the previous
+    // contents, so the file is always a complete JSON document of a bounded
+    // size. You must hold reportMutex to call this.
+    void writeReport(bool complete)
+    {
+        QByteArray report;
+        JsonWriter writer(report);
+        writer.beginObject();
+        writer.writeMember("complete");
+        writer.write(complete);
+        writer.writeMember("report");
+        StageStats::writeJson(writer);
+        writer.endObject();
+        report.append('\n');
+
+        // Replace the file atomically, so a snapshot can be read at any time
+        QSaveFile reportFile(reportFileName);
+        if (!reportFile.open(QIODevice::WriteOnly)) {
+            qWarning() << "Could not open" << reportFileName << "as statistics output file";
+            return;
+        }
+        reportFile.write(report);
+        if (!reportFile.commit()) {
+            qWarning() << "Writing to the statistics output file failed";
+        }
+    }
+
+    // Thread that writes snapshots at a fixed interval
+    class SnapshotThread : public QThread
+    {
+    public:
+        SnapshotThread(qint32 _intervalMsecs)
+            : intervalMsecs(_intervalMsecs), stopping(false)
+        {
+        }
+
+        void stop()
+        {
+            QMutexLocker locker(&mutex);
+            stopping = true;
+            stopCondition.wakeAll();
+        }
+
+    protected:
+        void run() override
+        {
+            QMutexLocker locker(&mutex);
+            while (!stopping) {
+                stopCondition.wait(&mutex, static_cast<unsigned long>(intervalMsecs));
+                if (stopping) break;
+
+                QMutexLocker reportLocker(&reportMutex);
+                writeReport(false);
+            }
+        }
+
+    private:
+        qint32 intervalMsecs;
+        QMutex mutex;
+        QWaitCondition stopCondition;
+        bool stopping;
+    };
+
+    SnapshotThread *snapshotThread = nullptr;
+
+    // Called when the application exits
+    void finishReport()
+    {
+        if (snapshotThread != nullptr) {
+            snapshotThread->stop();
+            snapshotThread->wait();
+            delete snapshotThread;
+            snapshotThread = nullptr;
+        }
+
+        QMutexLocker reportLocker(&reportMutex);
+        writeReport(true);
+    }
+}
+
+// Define the standard statistics command line options
+static QCommandLineOption statsJsonOption(QStringList() << "stats-json",
+                                          QCoreApplication::translate("main", "Write per-stage timing statistics to a JSON file"),
+                                          QCoreApplication::translate("main", "filename"));
+static QCommandLineOption statsIntervalOption(QStringList() << "stats-interval",
+                                              QCoreApplication::translate("main", "Also update the statistics file with a snapshot every N seconds"),
+                                              QCoreApplication::translate("main", "seconds"));
+
+void StageStats::setEnabled(bool state)
+{
+    if (state && !enabled.loadAcquire()) elapsedTimer.start();
+    enabled.storeRelease(state ? 1 : 0);
+}
+
+bool StageStats::isEnabled()
+{
+    return enabled.loadAcquire() != 0;
+}
+
+void StageStats::addTime(const char *stage, qint64 nsecs)
+{
+    if (!isEnabled()) return;
+
+    Slot *slot = findSlot(getThreadData()->stages, stage);
+    slot->calls.fetchAndAddRelaxed(1);
+    slot->total.fetchAndAddRelaxed(nsecs);
+}
+
+void StageStats::count(const char *counter, qint64 value)
+{
+    if (!isEnabled()) return;
+
+    Slot *slot = findSlot(getThreadData()->counters, counter);
+    slot->calls.fetchAndAddRelaxed(1);
+    slot->total.fetchAndAddRelaxed(value);
+}
+
+void StageStats::reset()
+{
+    QMutexLocker locker(&registryMutex);
+
+    for (const ThreadData *threadData : allThreads) {
+        clearSlots(threadData->stages);
+        clearSlots(threadData->counters);
+    }
+
+    if (isEnabled()) elapsedTimer.start();
+}
+
+void StageStats::writeJson(JsonWriter &writer)
+{
+    QMutexLocker locker(&registryMutex);
+
+    writer.beginObject();
+    writer.writeMember("elapsedNsecs");
+    writer.write(static_cast<qint64>(elapsedTimer.isValid() ? elapsedTimer.nsecsElapsed() : 0));
+
+    // Totals across all threads
+    QMap<QByteArray, Total> stageTotals, counterTotals;
+    for (const ThreadData *threadData : allThreads) {
+        addTotals(threadData->stages, stageTotals);
+        addTotals(threadData->counters, counterTotals);
+    }
+    writer.writeMember("stages");
+    writeStages(writer, stageTotals);
+    writer.writeMember("counters");
+    writeCounters(writer, counterTotals);
+
+    // Breakdown by thread, leaving out threads that haven't recorded
+    // anything since the last reset
+    writer.writeMember("threads");
+    writer.beginArray();
+    for (const ThreadData *threadData : allThreads) {
+        if (!anySlotUsed(threadData->stages) && !anySlotUsed(threadData->counters)) continue;
+
+        QMap<QByteArray, Total> threadStages, threadCounters;
+        addTotals(threadData->stages, threadStages);
+        addTotals(threadData->counters, threadCounters);
+
+        writer.beginObject();
+        writer.writeMember("thread");
+        writer.write(threadData->index);
+        writer.writeMember("stages");
+        writeStages(writer, threadStages);
+        writer.writeMember("counters");
+        writeCounters(writer, threadCounters);
+        writer.endObject();
+    }
+    writer.endArray();
+
+    writer.endObject();
+}
+
+StageTimer::StageTimer(const char *_stage)
+    : stage(_stage), running(StageStats::isEnabled())
+{
+    if (running) timer.start();
+}
+
+StageTimer::~StageTimer()
+{
+    stop();
+}
+
+void StageTimer::stop()
+{
+    if (!running) return;
+
+    StageStats::addTime(stage, timer.nsecsElapsed());
+    running = false;
+}
+
+void StageTimer::restart(const char *_stage)
+{
+    stop();
+
+    stage = _stage;
+    running = StageStats::isEnabled();
+    if (running) timer.start();
+}
+
+// Method to add the standard statistics options to the command line parser
+void addStandardStatsOptions(QCommandLineParser &parser)
+{
+    // Option to write a statistics report (--stats-json)
+    parser.addOption(statsJsonOption);
+
+    // Option to write periodic snapshots (--stats-interval)
+    parser.addOption(statsIntervalOption);
+}
+
+// Method to process the standard statistics options
+bool processStandardStatsOptions(QCommandLineParser &parser)
+{
+    if (!parser.isSet(statsJsonOption)) {
+        if (parser.isSet(statsIntervalOption)) {
+            qCritical() << "--stats-interval requires --stats-json";
+            return false;
+        }
+        return true;
+    }
+
+    reportFileName = parser.value(statsJsonOption);
+
+    qint32 intervalMsecs = 0;
+    if (parser.isSet(statsIntervalOption)) {
+        bool ok;
+        double intervalSecs = parser.value(statsIntervalOption).toDouble(&ok);
+        if (!ok || intervalSecs <= 0.0) {
+            qCritical() << "Statistics interval must be a positive number of seconds";
+            return false;
+        }
+        intervalMsecs = qMax(1, static_cast<qint32>(intervalSecs * 1000.0));
+    }
+
+    StageStats::setEnabled(true);
+
+    // Write the final report when the QCoreApplication is destroyed, which
+    // happens after the tool has finished with its worker threads
+    qAddPostRoutine(finishReport);
+
+    if (intervalMsecs > 0) {
+        snapshotThread = new SnapshotThread(intervalMsecs);
+        snapshotThread->start(QThread::LowPriority);
+    }
+
+    return true;
+}
@@ -0,0 +1,101 @@
+/************************************************************************
+
+    stagestats.h
+
+    ld-decode-tools TBC library
+    Copyright (C) 2026 agent
+
+    This file is part of ld-decode-tools.
+
+    ld-decode-tools is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+************************************************************************/
+
+#ifndef STAGESTATS_H
+#define STAGESTATS_H
+
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QString>
+
+class JsonWriter;
+
+// Timing and counting instrumentation for the tools' processing pipelines.
+//
+// Code that wants to be measured wraps each stage of its work (e.g. "input",
+// "decode", "output") in a StageTimer, and counts the items it processes with
+// StageStats::count. Stage and counter names must be string literals.
+// Times and counts are accumulated separately for each thread, so recording
+// a measurement never contends with other threads.
+//
+// Collection is disabled by default, in which case timers and counters only
+// check a flag. Tools enable it with the --stats-json option (see
+// addStandardStatsOptions), which writes a JSON report when the tool exits.
+class StageStats
+{
+public:
+    // Enable or disable collection
+    static void setEnabled(bool state);
+    static bool isEnabled();
+
+    // Add a measurement of a stage taking nsecs nanoseconds
+    static void addTime(const char *stage, qint64 nsecs);
+
+    // Add value to a counter
+    static void count(const char *counter, qint64 value = 1);
+
+    // Discard the statistics collected so far, and restart the elapsed time
+    // (e.g. between the runs of a benchmark)
+    static void reset();
+
+    // Write the statistics collected so far as a JSON object, with totals
+    // for each stage and counter, and a breakdown by thread
+    static void writeJson(JsonWriter &writer);
+};
+
+// Time a stage from construction until stop() is called or the timer goes
+// out of scope, whichever comes first
+class StageTimer
+{
+public:
+    StageTimer(const char *_stage);
+    ~StageTimer();
+
+    // Prevent copying or assignment
+    StageTimer(const StageTimer &) = delete;
+    StageTimer& operator=(const StageTimer &) = delete;
+
+    void stop();
+
+    // Stop timing the current stage, and start timing another. This is
+    // convenient for a sequence of stages in a pipeline.
+    void restart(const char *_stage);
+
+private:
+    const char *stage;
+    bool running;
+    QElapsedTimer timer;
+};
+
+// Add the standard statistics options (--stats-json and --stats-interval) to
+// the command line parser
+void addStandardStatsOptions(QCommandLineParser &parser);
+
+// Process the standard statistics options. If a report was requested, this
+// enables collection and arranges for the report to be written when the
+// application exits (and periodically, if requested).
+// Returns true on success; on failure, prints a message and returns false.
+bool processStandardStatsOptions(QCommandLineParser &parser);
+
+#endif // STAGESTATS_H
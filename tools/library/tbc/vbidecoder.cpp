@@ -24,6 +24,111 @@
 
 #include "vbidecoder.h"
 
+namespace {
+    // Values of pairs of BCD digits, indexed by byte; -1 if either digit
+    // isn't in the range 0-9
+    struct BcdTable {
+        BcdTable()
+        {
+            for (qint32 i = 0; i < 256; i++) {
+                const qint32 high = i >> 4;
+                const qint32 low = i & 0xF;
+                if (high > 9 || low > 9) value[i] = -1;
+                else value[i] = (high * 10) + low;
+            }
+        }
+
+        qint8 value[256];
+    };
+    const BcdTable BCD_TABLE;
+
+    // Results of the programme status parity check, indexed by (x4 << 4) | x5
+    struct ParityTable {
+        ParityTable()
+        {
+            for (qint32 i = 0; i < 256; i++) {
+                const qint32 x4 = i >> 4;
+                const qint32 x5 = i & 0xF;
+
+                // Get the data bits from X4
+                const qint32 x41 = (x4 >> 3) & 1;
+                const qint32 x42 = (x4 >> 2) & 1;
+                const qint32 x43 = (x4 >> 1) & 1;
+                const qint32 x44 = x4 & 1;
+
+                // X51 is the parity with X41, X42 and X44
+                // X52 is the parity with X41, X43 and X44
+                // X53 is the parity with X42, X43 and X44
+                const qint32 x51 = (x5 >> 3) & 1;
+                const qint32 x52 = (x5 >> 2) & 1;
+                const qint32 x53 = (x5 >> 1) & 1;
+
+                valid[i] = (((x41 + x42 + x44) & 1) == x51)
+                        && (((x41 + x43 + x44) & 1) == x52)
+                        && (((x42 + x43 + x44) & 1) == x53);
+            }
+        }
+
+        bool valid[256];
+    };
+    const ParityTable PARITY_TABLE;
+
+    // Meaning of the programme status code's audio status (IEC 60857-1986 10.1.8)
+    struct AudioStatus {
+        bool dump;
+        bool fm;
+        VbiDecoder::VbiSoundModes soundMode;
+    };
+    const AudioStatus AUDIO_STATUS[16] = {
+        {false, false, VbiDecoder::VbiSoundModes::stereo},                  // 0
+        {false, false, VbiDecoder::VbiSoundModes::mono},                    // 1
+        {false, false, VbiDecoder::VbiSoundModes::futureUse},               // 2
+        {false, false, VbiDecoder::VbiSoundModes::bilingual},               // 3
+        {false, true,  VbiDecoder::VbiSoundModes::stereo_stereo},           // 4
+        {false, true,  VbiDecoder::VbiSoundModes::stereo_bilingual},        // 5
+        {false, true,  VbiDecoder::VbiSoundModes::crossChannelStereo},      // 6
+        {false, true,  VbiDecoder::VbiSoundModes::bilingual_bilingual},     // 7
+        {true,  false, VbiDecoder::VbiSoundModes::mono_dump},               // 8
+        {true,  false, VbiDecoder::VbiSoundModes::mono_dump},               // 9
+        {true,  false, VbiDecoder::VbiSoundModes::futureUse},               // 10
+        {true,  false, VbiDecoder::VbiSoundModes::mono_dump},               // 11
+        {true,  true,  VbiDecoder::VbiSoundModes::stereo_dump},             // 12
+        {true,  true,  VbiDecoder::VbiSoundModes::stereo_dump},             // 13
+        {true,  true,  VbiDecoder::VbiSoundModes::bilingual_dump},          // 14
+        {true,  true,  VbiDecoder::VbiSoundModes::bilingual_dump},          // 15
+    };
+
+    // Meaning of the audio status as redefined by IEC Amendment 2
+    struct AudioStatusAm2 {
+        bool standard;
+        VbiDecoder::VbiSoundModes soundMode;
+    };
+    const AudioStatusAm2 AUDIO_STATUS_AM2[16] = {
+        {true,  VbiDecoder::VbiSoundModes::stereo},                         // 0
+        {true,  VbiDecoder::VbiSoundModes::mono},                           // 1
+        {false, VbiDecoder::VbiSoundModes::futureUse},                      // 2
+        {true,  VbiDecoder::VbiSoundModes::bilingual},                      // 3
+        {false, VbiDecoder::VbiSoundModes::futureUse},                      // 4
+        {false, VbiDecoder::VbiSoundModes::futureUse},                      // 5
+        {false, VbiDecoder::VbiSoundModes::futureUse},                      // 6
+        {false, VbiDecoder::VbiSoundModes::futureUse},                      // 7
+        {true,  VbiDecoder::VbiSoundModes::mono_dump},                      // 8
+        {false, VbiDecoder::VbiSoundModes::futureUse},                      // 9
+        {false, VbiDecoder::VbiSoundModes::futureUse},                      // 10
+        {false, VbiDecoder::VbiSoundModes::futureUse},                      // 11
+        {false, VbiDecoder::VbiSoundModes::futureUse},                      // 12
+        {false, VbiDecoder::VbiSoundModes::futureUse},                      // 13
+        {false, VbiDecoder::VbiSoundModes::futureUse},                      // 14
+        {false, VbiDecoder::VbiSoundModes::futureUse},                      // 15
+    };
+
+    // Names of the sound modes, for debug output
+    const char *const SOUND_MODE_NAMES[] = {
+        "stereo", "mono", "audioSubCarriersOff", "bilingual", "stereo_stereo", "stereo_bilingual",
+        "crossChannelStereo", "bilingual_bilingual", "mono_dump", "stereo_dump", "bilingual_dump", "futureUse"
+    };
+}
+
 VbiDecoder::VbiDecoder()
 {
     verboseDebug = false;
@@ -305,109 +410,13 @@ VbiDecoder::Vbi VbiDecoder::decode(qint32 vbi16, qint32 vbi17, qint32 vbi18)
         if (verboseDebug) qDebug() << "VbiDecoder::decode(): VBI Programme status code - audio status is" << audioStatus;
 
         // Configure according to the audio status code
-        switch(audioStatus) {
-        case 0:
-            vbi.dump = false;
-            vbi.fm = false;
-            vbi.soundMode = VbiDecoder::VbiSoundModes::stereo;
-            if (verboseDebug) qDebug() << "VbiDecoder::decode(): VBI audio status 0 - isProgrammeDump = false - isFmFmMultiplex = false - soundMode = stereo";
-            break;
-        case 1:
-            vbi.dump = false;
-            vbi.fm = false;
-            vbi.soundMode = VbiDecoder::VbiSoundModes::mono;
-            if (verboseDebug) qDebug() << "VbiDecoder::decode(): VBI audio status 1 - isProgrammeDump = false - isFmFmMultiplex = false - soundMode = mono";
-            break;
-        case 2:
-            vbi.dump = false;
-            vbi.fm = false;
-            vbi.soundMode = VbiDecoder::VbiSoundModes::futureUse;
-            if (verboseDebug) qDebug() << "VbiDecoder::decode(): VBI audio status 2 - isProgrammeDump = false - isFmFmMultiplex = false - soundMode = futureUse";
-            break;
-        case 3:
-            vbi.dump = false;
-            vbi.fm = false;
-            vbi.soundMode = VbiDecoder::VbiSoundModes::bilingual;
-            if (verboseDebug) qDebug() << "VbiDecoder::decode(): VBI audio status 3 - isProgrammeDump = false - isFmFmMultiplex = false - soundMode = bilingual";
-            break;
-        case 4:
-            vbi.dump = false;
-            vbi.fm = true;
-            vbi.soundMode = VbiDecoder::VbiSoundModes::stereo_stereo;
-            if (verboseDebug) qDebug() << "VbiDecoder::decode(): VBI audio status 4 - isProgrammeDump = false - isFmFmMultiplex = true - soundMode = stereo_stereo";
-            break;
-        case 5:
-            vbi.dump = false;
-            vbi.fm = true;
-            vbi.soundMode = VbiDecoder::VbiSoundModes::stereo_bilingual;
-            if (verboseDebug) qDebug() << "VbiDecoder::decode(): VBI audio status 5 - isProgrammeDump = false - isFmFmMultiplex = true - soundMode = stereo_bilingual";
-            break;
-        case 6:
-            vbi.dump = false;
-            vbi.fm = true;
-            vbi.soundMode = VbiDecoder::VbiSoundModes::crossChannelStereo;
-            if (verboseDebug) qDebug() << "VbiDecoder::decode(): VBI audio status 6 - isProgrammeDump = false - isFmFmMultiplex = true - soundMode = crossChannelStereo";
-            break;
-        case 7:
-            vbi.dump = false;
-            vbi.fm = true;
-            vbi.soundMode = VbiDecoder::VbiSoundModes::bilingual_bilingual;
-            if (verboseDebug) qDebug() << "VbiDecoder::decode(): VBI audio status 7 - isProgrammeDump = false - isFmFmMultiplex = true - soundMode = bilingual_bilingual";
-            break;
-        case 8:
-            vbi.dump = true;
-            vbi.fm = false;
-            vbi.soundMode = VbiDecoder::VbiSoundModes::mono_dump;
-            if (verboseDebug) qDebug() << "VbiDecoder::decode(): VBI audio status 8 - isProgrammeDump = true - isFmFmMultiplex = false - soundMode = mono_dump";
-            break;
-        case 9:
-            vbi.dump = true;
-            vbi.fm = false;
-            vbi.soundMode = VbiDecoder::VbiSoundModes::mono_dump;
-            if (verboseDebug) qDebug() << "VbiDecoder::decode(): VBI audio status 9 - isProgrammeDump = true - isFmFmMultiplex = false - soundMode = mono_dump";
-            break;
-        case 10:
-            vbi.dump = true;
-            vbi.fm = false;
-            vbi.soundMode = VbiDecoder::VbiSoundModes::futureUse;
-            if (verboseDebug) qDebug() << "VbiDecoder::decode(): VBI audio status 10 - isProgrammeDump = true - isFmFmMultiplex = false - soundMode = futureUse";
-            break;
-        case 11:
-            vbi.dump = true;
-            vbi.fm = false;
-            vbi.soundMode = VbiDecoder::VbiSoundModes::mono_dump;
-            if (verboseDebug) qDebug() << "VbiDecoder::decode(): VBI audio status 11 - isProgrammeDump = true - isFmFmMultiplex = false - soundMode = mono_dump";
-            break;
-        case 12:
-            vbi.dump = true;
-            vbi.fm = true;
-            vbi.soundMode = VbiDecoder::VbiSoundModes::stereo_dump;
-            if (verboseDebug) qDebug() << "VbiDecoder::decode(): VBI audio status 12 - isProgrammeDump = true - isFmFmMultiplex = true - soundMode = stereo_dump";
-            break;
-        case 13:
-            vbi.dump = true;
-            vbi.fm = true;
-            vbi.soundMode = VbiDecoder::VbiSoundModes::stereo_dump;
-            if (verboseDebug) qDebug() << "VbiDecoder::decode(): VBI audio status 13 - isProgrammeDump = true - isFmFmMultiplex = true - soundMode = stereo_dump";
-            break;
-        case 14:
-            vbi.dump = true;
-            vbi.fm = true;
-            vbi.soundMode = VbiDecoder::VbiSoundModes::bilingual_dump;
-            if (verboseDebug) qDebug() << "VbiDecoder::decode(): VBI audio status 14 - isProgrammeDump = true - isFmFmMultiplex = true - soundMode = bilingual_dump";
-            break;
-        case 15:
-            vbi.dump = true;
-            vbi.fm = true;
-            vbi.soundMode = VbiDecoder::VbiSoundModes::bilingual_dump;
-            if (verboseDebug) qDebug() << "VbiDecoder::decode(): VBI audio status 15 - isProgrammeDump = true - isFmFmMultiplex = true - soundMode = bilingual_dump";
-            break;
-        default:
-            if (verboseDebug) qDebug() << "VbiDecoder::decode(): VBI - Invalid audio status code!";
-            vbi.dump = false;
-            vbi.fm = false;
-            vbi.soundMode = VbiDecoder::VbiSoundModes::stereo;
-        }
+        const AudioStatus &status = AUDIO_STATUS[audioStatus];
+        vbi.dump = status.dump;
+        vbi.fm = status.fm;
+        vbi.soundMode = status.soundMode;
+        if (verboseDebug) qDebug() << "VbiDecoder::decode(): VBI audio status" << audioStatus <<
+                    "- isProgrammeDump =" << vbi.dump << "- isFmFmMultiplex =" << vbi.fm <<
+                    "- soundMode =" << SOUND_MODE_NAMES[vbi.soundMode];
     }
 
     // IEC 60857-1986 - 10.1.8 Programme status code (IEC Amendment 2) ------------------------------------------------
@@ -446,92 +455,12 @@ VbiDecoder::Vbi VbiDecoder::decode(qint32 vbi16, qint32 vbi17, qint32 vbi18)
         if (verboseDebug) qDebug() << "VbiDecoder::decode(): VBI (Am2) Programme status code - audio status is" << audioStatus;
 
         // Configure according to the audio status code
-        switch(audioStatus) {
-        case 0:
-            vbi.standardAm2 = true;
-            vbi.soundModeAm2 = VbiDecoder::VbiSoundModes::stereo;
-            if (verboseDebug) qDebug() << "VbiDecoder::decode(): VBI (Am2) audio status 0 - isVideoSignalStandard = true - soundMode = stereo";
-            break;
-        case 1:
-            vbi.standardAm2 = true;
-            vbi.soundModeAm2 = VbiDecoder::VbiSoundModes::mono;
-            if (verboseDebug) qDebug() << "VbiDecoder::decode(): VBI (Am2) audio status 1 - isVideoSignalStandard = true - soundMode = mono";
-            break;
-        case 2:
-            vbi.standardAm2 = false;
-            vbi.soundModeAm2 = VbiDecoder::VbiSoundModes::futureUse;
-            if (verboseDebug) qDebug() << "VbiDecoder::decode(): VBI (Am2) audio status 2 - isVideoSignalStandard = false - soundMode = futureUse";
-            break;
-        case 3:
-            vbi.standardAm2 = true;
-            vbi.soundModeAm2 = VbiDecoder::VbiSoundModes::bilingual;
-            if (verboseDebug) qDebug() << "VbiDecoder::decode(): VBI (Am2) audio status 3 - isVideoSignalStandard = true - soundMode = bilingual";
-            break;
-        case 4:
-            vbi.standardAm2 = false;
-            vbi.soundModeAm2 = VbiDecoder::VbiSoundModes::futureUse;
-            if (verboseDebug) qDebug() << "VbiDecoder::decode(): VBI (Am2) audio status 4 - isVideoSignalStandard = false - soundMode = futureUse";
-            break;
-        case 5:
-            vbi.standardAm2 = false;
-            vbi.soundModeAm2 = VbiDecoder::VbiSoundModes::futureUse;
-            if (verboseDebug) qDebug() << "VbiDecoder::decode(): VBI (Am2) audio status 5 - isVideoSignalStandard = false - soundMode = futureUse";
-            break;
-        case 6:
-            vbi.standardAm2 = false;
-            vbi.soundModeAm2 = VbiDecoder::VbiSoundModes::futureUse;
-            if (verboseDebug) qDebug() << "VbiDecoder::decode(): VBI (Am2) audio status 6 - isVideoSignalStandard = false - soundMode = futureUse";
-            break;
-        case 7:
-            vbi.standardAm2 = false;
-            vbi.soundModeAm2 = VbiDecoder::VbiSoundModes::futureUse;
-            if (verboseDebug) qDebug() << "VbiDecoder::decode(): VBI (Am2) audio status 7 - isVideoSignalStandard = false - soundMode = futureUse";
-            break;
-        case 8:
-            vbi.standardAm2 = true;
-            vbi.soundModeAm2 = VbiDecoder::VbiSoundModes::mono_dump;
-            if (verboseDebug) qDebug() << "VbiDecoder::decode(): VBI (Am2) audio status 8 - isVideoSignalStandard = true - soundMode = mono_dump";
-            break;
-        case 9:
-            vbi.standardAm2 = false;
-            vbi.soundModeAm2 = VbiDecoder::VbiSoundModes::futureUse;
-            if (verboseDebug) qDebug() << "VbiDecoder::decode(): VBI (Am2) audio status 9 - isVideoSignalStandard = false - soundMode = futureUse";
-            break;
-        case 10:
-            vbi.standardAm2 = false;
-            vbi.soundModeAm2 = VbiDecoder::VbiSoundModes::futureUse;
-            if (verboseDebug) qDebug() << "VbiDecoder::decode(): VBI (Am2) audio status 10 - isVideoSignalStandard = false - soundMode = futureUse";
-            break;
-        case 11:
-            vbi.standardAm2 = false;
-            vbi.soundModeAm2 = VbiDecoder::VbiSoundModes::futureUse;
-            if (verboseDebug) qDebug() << "VbiDecoder::decode(): VBI (Am2) audio status 11 - isVideoSignalStandard = false - soundMode = futureUse";
-            break;
-        case 12:
-            vbi.standardAm2 = false;
-            vbi.soundModeAm2 = VbiDecoder::VbiSoundModes::futureUse;
-            if (verboseDebug) qDebug() << "VbiDecoder::decode(): VBI (Am2) audio status 12 - isVideoSignalStandard = false - soundMode = futureUse";
-            break;
-        case 13:
-            vbi.standardAm2 = false;
-            vbi.soundModeAm2 = VbiDecoder::VbiSoundModes::futureUse;
-            if (verboseDebug) qDebug() << "VbiDecoder::decode(): VBI (Am2) audio status 13 - isVideoSignalStandard = false - soundMode = futureUse";
-            break;
-        case 14:
-            vbi.standardAm2 = false;
-            vbi.soundModeAm2 = VbiDecoder::VbiSoundModes::futureUse;
-            if (verboseDebug) qDebug() << "VbiDecoder::decode(): VBI (Am2) audio status 14 - isVideoSignalStandard = false - soundMode = futureUse";
-            break;
-        case 15:
-            vbi.standardAm2 = false;
-            vbi.soundModeAm2 = VbiDecoder::VbiSoundModes::futureUse;
-            if (verboseDebug) qDebug() << "VbiDecoder::decode(): VBI (Am2) audio status 15 - isVideoSignalStandard = false - soundMode = futureUse";
-            break;
-        default:
-            vbi.standardAm2 = false;
-            vbi.soundModeAm2 = VbiDecoder::VbiSoundModes::stereo;
-            if (verboseDebug) qDebug() << "VbiDecoder::decode(): VBI (Am2) - Invalid audio status code!";
-        }
+        const AudioStatusAm2 &status = AUDIO_STATUS_AM2[audioStatus];
+        vbi.standardAm2 = status.standard;
+        vbi.soundModeAm2 = status.soundMode;
+        if (verboseDebug) qDebug() << "VbiDecoder::decode(): VBI (Am2) audio status" << audioStatus <<
+                    "- isVideoSignalStandard =" << vbi.standardAm2 <<
+                    "- soundMode =" << SOUND_MODE_NAMES[vbi.soundModeAm2];
     }
 
     // IEC 60857-1986 - 10.1.9 Users code -----------------------------------------------------------------------------
@@ -593,39 +522,7 @@ VbiDecoder::Vbi VbiDecoder::decode(qint32 vbi16, qint32 vbi17, qint32 vbi18)
 // Private method to verifiy parity
 bool VbiDecoder::parity(quint32 x4, quint32 x5)
 {
-    // X51 is the parity with X41, X42 and X44
-    // X52 is the parity with X41, X43 and X44
-    // X53 is the parity with X42, X43 and X44
-
-    // Get the parity bits from X5
-    qint32 x51, x52, x53;
-    if ((x5 & 0x8) == 0x8) x51 = 1; else x51 = 0;
-    if ((x5 & 0x4) == 0x4) x52 = 1; else x52 = 0;
-    if ((x5 & 0x2) == 0x2) x53 = 1; else x53 = 0;
-
-    // Get the data bits from X4
-    qint32 x41, x42, x43, x44;
-    if ((x4 & 0x8) == 0x8) x41 = 1; else x41 = 0;
-    if ((x4 & 0x4) == 0x4) x42 = 1; else x42 = 0;
-    if ((x4 & 0x2) == 0x2) x43 = 1; else x43 = 0;
-    if ((x4 & 0x1) == 0x1) x44 = 1; else x44 = 0;
-
-    // Count the data bits according to the IEC specification
-    qint32 x51count = x41 + x42 + x44;
-    qint32 x52count = x41 + x43 + x44;
-    qint32 x53count = x42 + x43 + x44;
-
-    // Check if the parity is correct
-    bool x51p = false;
-    bool x52p = false;
-    bool x53p = false;
-
-    if ((((x51count % 2) == 0) && (x51 == 0)) || (((x51count % 2) != 0) && (x51 != 0))) x51p = true;
-    if ((((x52count % 2) == 0) && (x52 == 0)) || (((x52count % 2) != 0) && (x52 != 0))) x52p = true;
-    if ((((x53count % 2) == 0) && (x53 == 0)) || (((x53count % 2) != 0) && (x53 != 0))) x53p = true;
-
-    if (x51p && x52p && x53p) return true;
-    return false;
+    return PARITY_TABLE.valid[((x4 & 0xF) << 4) | (x5 & 0xF)];
 }
 
 // Decode a BCD number from bcd into output.
@@ -635,16 +532,17 @@ bool VbiDecoder::decodeBCD(quint32 bcd, qint32 &output)
 {
     qint32 value = 0;
 
-    quint32 place = 1;
+    // Decode two digits at a time
+    qint32 place = 1;
     while (bcd != 0) {
-        quint32 digit = bcd & 0xF;
-        if (digit > 9) {
+        const qint32 digits = BCD_TABLE.value[bcd & 0xFF];
+        if (digits < 0) {
             return false;
         }
 
-        value += digit * place;
-        place *= 10;
-        bcd >>= 4;
+        value += digits * place;
+        place *= 100;
+        bcd >>= 8;
     }
 
     output = value;
@@ -0,0 +1,143 @@
+/************************************************************************
+
+    vbiframemap.cpp
+
+    ld-decode-tools TBC library
+    Copyright (C) 2026 agent
+
+    This file is part of ld-decode-tools.
+
+    ld-decode-tools is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+************************************************************************/
+
+#include "vbiframemap.h"
+
+#include "vbidecoder.h"
+
+bool VbiFrameMap::build(LdDecodeMetaData &ldDecodeMetaData)
+{
+    const qint32 numberOfFrames = ldDecodeMetaData.getNumberOfFrames();
+
+    const QVector<VbiDecoder::Vbi> &frameVbi = ldDecodeMetaData.getFrameVbiTable();
+    qint32 cavCount = 0;
+    qint32 clvCount = 0;
+    qint32 cavMin = 1000000;
+    qint32 cavMax = 0;
+    qint32 clvMin = 1000000;
+    qint32 clvMax = 0;
+
+    frames.resize(numberOfFrames);
+
+    // Using sequential frame numbering starting from 1
+    for (qint32 seqFrame = 1; seqFrame <= numberOfFrames; seqFrame++) {
+        Frame &frame = frames[seqFrame - 1];
+        frame.firstFieldNumber = ldDecodeMetaData.getFirstFieldNumber(seqFrame);
+        frame.secondFieldNumber = ldDecodeMetaData.getSecondFieldNumber(seqFrame);
+
+        const LdDecodeMetaData::Field firstField = ldDecodeMetaData.getField(frame.firstFieldNumber);
+        const LdDecodeMetaData::Field secondField = ldDecodeMetaData.getField(frame.secondFieldNumber);
+        frame.isPadded = firstField.pad && secondField.pad;
+
+        // Get the decoded VBI
+        const VbiDecoder::Vbi &vbi = frameVbi[seqFrame - 1];
+
+        // Look for a complete, valid CAV picture number or CLV time-code
+        if (vbi.picNo > 0) {
+            cavCount++;
+
+            if (vbi.picNo < cavMin) cavMin = vbi.picNo;
+            if (vbi.picNo > cavMax) cavMax = vbi.picNo;
+        }
+
+        if (vbi.clvHr != -1 && vbi.clvMin != -1 &&
+                vbi.clvSec != -1 && vbi.clvPicNo != -1) {
+            clvCount++;
+
+            LdDecodeMetaData::ClvTimecode timecode;
+            timecode.hours = vbi.clvHr;
+            timecode.minutes = vbi.clvMin;
+            timecode.seconds = vbi.clvSec;
+            timecode.pictureNumber = vbi.clvPicNo;
+            qint32 cvFrameNumber = ldDecodeMetaData.convertClvTimecodeToFrameNumber(timecode);
+
+            if (cvFrameNumber < clvMin) clvMin = cvFrameNumber;
+            if (cvFrameNumber > clvMax) clvMax = cvFrameNumber;
+        }
+    }
+    qDebug() << "VbiFrameMap::build(): Got" << cavCount << "CAV picture codes and" << clvCount << "CLV timecodes";
+
+    // If the metadata has no picture numbers or time-codes, we cannot use the source
+    if (cavCount == 0 && clvCount == 0) {
+        qDebug() << "VbiFrameMap::build(): Source does not seem to contain valid CAV picture numbers or CLV time-codes";
+        frames.clear();
+        return false;
+    }
+
+    // Determine disc type
+    if (cavCount > clvCount) {
+        discCav = true;
+        minimumVbiFrame = cavMin;
+        maximumVbiFrame = cavMax;
+    } else {
+        discCav = false;
+        minimumVbiFrame = clvMin;
+        maximumVbiFrame = clvMax;
+    }
+
+    return true;
+}
+
+bool VbiFrameMap::isDiscCav() const
+{
+    return discCav;
+}
+
+qint32 VbiFrameMap::getMinimumVbiFrame() const
+{
+    return minimumVbiFrame;
+}
+
+qint32 VbiFrameMap::getMaximumVbiFrame() const
+{
+    return maximumVbiFrame;
+}
+
+// Method to convert a VBI frame number to a sequential frame number
+qint32 VbiFrameMap::convertVbiFrameNumberToSequential(qint32 vbiFrameNumber) const
+{
+    // Offset the VBI frame number to get the sequential source frame number
+    return vbiFrameNumber - minimumVbiFrame + 1;
+}
+
+// Method to convert a sequential frame number to a VBI frame number
+qint32 VbiFrameMap::convertSequentialFrameNumberToVbi(qint32 sequentialFrameNumber) const
+{
+    return (minimumVbiFrame - 1) + sequentialFrameNumber;
+}
+
+bool VbiFrameMap::containsVbiFrame(qint32 vbiFrameNumber) const
+{
+    return !getVbiFrame(vbiFrameNumber).isPadded;
+}
+
+const VbiFrameMap::Frame &VbiFrameMap::getVbiFrame(qint32 vbiFrameNumber) const
+{
+    if (vbiFrameNumber < minimumVbiFrame || vbiFrameNumber > maximumVbiFrame) return missingFrame;
+
+    const qint32 index = convertVbiFrameNumberToSequential(vbiFrameNumber) - 1;
+    if (index < 0 || index >= frames.size()) return missingFrame;
+
+    return frames[index];
+}
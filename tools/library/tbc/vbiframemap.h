@@ -0,0 +1,78 @@
+/************************************************************************
+
+    vbiframemap.h
+
+    ld-decode-tools TBC library
+    Copyright (C) 2026 agent
+
+    This file is part of ld-decode-tools.
+
+    ld-decode-tools is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+************************************************************************/
+
+#ifndef VBIFRAMEMAP_H
+#define VBIFRAMEMAP_H
+
+#include <QtGlobal>
+#include <QVector>
+
+#include "lddecodemetadata.h"
+
+// A lookup table from a mapped source's VBI frame numbers to its fields.
+//
+// Tools that combine several sources of the same disc need to find the same
+// frame in each source, and whether that source has a usable copy of it.
+// build() scans the source's metadata once, so these become array lookups.
+//
+// The source must have been mapped with ld-discmap, so that sequential
+// frames correspond directly to VBI frame numbers.
+class VbiFrameMap
+{
+public:
+    struct Frame {
+        qint32 firstFieldNumber = -1;
+        qint32 secondFieldNumber = -1;
+        bool isPadded = true;       // Both fields are padding (i.e. the frame is missing)
+    };
+
+    // Determine the disc type and VBI frame number range of a source, and
+    // build the table. Returns false if the source has no usable VBI.
+    bool build(LdDecodeMetaData &ldDecodeMetaData);
+
+    bool isDiscCav() const;
+    qint32 getMinimumVbiFrame() const;
+    qint32 getMaximumVbiFrame() const;
+
+    qint32 convertVbiFrameNumberToSequential(qint32 vbiFrameNumber) const;
+    qint32 convertSequentialFrameNumberToVbi(qint32 sequentialFrameNumber) const;
+
+    // Is a usable (non-padded) copy of the frame present in the source?
+    bool containsVbiFrame(qint32 vbiFrameNumber) const;
+
+    // Get the fields for a frame. Frames outside the source have field
+    // numbers of -1.
+    const Frame &getVbiFrame(qint32 vbiFrameNumber) const;
+
+private:
+    bool discCav = false;
+    qint32 minimumVbiFrame = 0;
+    qint32 maximumVbiFrame = 0;
+
+    // Indexed by sequential frame number - 1
+    QVector<Frame> frames;
+    Frame missingFrame;
+};
+
+#endif // VBIFRAMEMAP_H
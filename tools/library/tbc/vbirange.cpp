@@ -0,0 +1,190 @@
+/************************************************************************
+
+    vbirange.cpp
+
+    ld-decode-tools TBC library
+    Copyright (C) 2026 agent
+
+    This file is part of ld-decode-tools.
+
+    ld-decode-tools is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+************************************************************************/
+
+#include "vbirange.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QStringList>
+
+namespace {
+    // A position on the disc given by the VBI: a CAV picture number, or a CLV
+    // timecode converted to a frame count
+    struct VbiAddress {
+        bool isClv;
+        qint32 code;
+    };
+
+    // Parse a CAV picture number ("12345") or CLV timecode ("hh:mm:ss.pp" or "hh:mm:ss")
+    bool parseVbiAddress(LdDecodeMetaData &metaData, QString text, VbiAddress &address)
+    {
+        bool ok = false;
+
+        if (!text.contains(':')) {
+            address.isClv = false;
+            address.code = text.toInt(&ok);
+            return ok && address.code >= 0;
+        }
+
+        const QStringList parts = text.replace('.', ':').split(':');
+        if (parts.size() != 3 && parts.size() != 4) return false;
+
+        qint32 values[4] = {0, 0, 0, 0};
+        for (qint32 i = 0; i < parts.size(); i++) {
+            values[i] = parts[i].toInt(&ok);
+            if (!ok || values[i] < 0) return false;
+        }
+
+        LdDecodeMetaData::ClvTimecode clvTimecode;
+        clvTimecode.hours = values[0];
+        clvTimecode.minutes = values[1];
+        clvTimecode.seconds = values[2];
+        clvTimecode.pictureNumber = values[3];
+
+        address.isClv = true;
+        address.code = metaData.convertClvTimecodeToFrameNumber(clvTimecode);
+        return true;
+    }
+
+    // Find the first indexed frame with an address of at least the one given
+    LdDecodeMetaData::SeekIndexEntry findVbiAddress(LdDecodeMetaData &metaData, bool isClv, qint32 code)
+    {
+        if (isClv) return metaData.findClvTimecode(metaData.convertFrameNumberToClvTimecode(code));
+        return metaData.findPictureNumber(code);
+    }
+}
+
+// Define the standard VBI range command line options
+static QCommandLineOption vbiStartOption(QStringList() << "vbi-start",
+                                         QCoreApplication::translate("main", "Start at the frame with this VBI CAV picture number or CLV timecode (hh:mm:ss.pp)"),
+                                         QCoreApplication::translate("main", "address"));
+static QCommandLineOption vbiEndOption(QStringList() << "vbi-end",
+                                       QCoreApplication::translate("main", "End at (and include) the frame with this VBI CAV picture number or CLV timecode"),
+                                       QCoreApplication::translate("main", "address"));
+static QCommandLineOption chapterOption(QStringList() << "chapter",
+                                        QCoreApplication::translate("main", "Only process the frames in this VBI chapter"),
+                                        QCoreApplication::translate("main", "number"));
+
+// Method to add the standard VBI range options to the command line parser
+void addStandardVbiRangeOptions(QCommandLineParser &parser)
+{
+    // Options to select a range by VBI address (--vbi-start and --vbi-end)
+    parser.addOption(vbiStartOption);
+    parser.addOption(vbiEndOption);
+
+    // Option to select a chapter (--chapter)
+    parser.addOption(chapterOption);
+}
+
+// Method to process the standard VBI range options
+bool processStandardVbiRangeOptions(QCommandLineParser &parser, LdDecodeMetaData &metaData,
+                                    qint32 &startFrame, qint32 &length)
+{
+    const bool isAddressSet = parser.isSet(vbiStartOption) || parser.isSet(vbiEndOption);
+    if (!isAddressSet && !parser.isSet(chapterOption)) return true;
+
+    if (isAddressSet && parser.isSet(chapterOption)) {
+        qCritical() << "A chapter cannot be combined with --vbi-start or --vbi-end";
+        return false;
+    }
+    if (startFrame != -1 || length != -1) {
+        qCritical() << "A VBI range cannot be combined with a sequential frame range";
+        return false;
+    }
+
+    const qint32 numberOfFrames = metaData.getNumberOfFrames();
+    qint32 firstFrame = 1;
+    qint32 lastFrame = numberOfFrames;
+
+    if (parser.isSet(chapterOption)) {
+        bool ok = false;
+        const qint32 chapter = parser.value(chapterOption).toInt(&ok);
+        if (!ok || chapter < 0) {
+            qCritical() << "Chapter must be a number";
+            return false;
+        }
+
+        const LdDecodeMetaData::SeekIndexEntry start = metaData.findChapter(chapter);
+        if (start.frameNumber == -1) {
+            qCritical() << "Chapter" << chapter << "was not found in the VBI";
+            return false;
+        }
+        firstFrame = start.frameNumber;
+
+        // The chapter ends where the next one starts
+        for (const LdDecodeMetaData::SeekIndexEntry &entry : metaData.getChapterStarts()) {
+            if (entry.frameNumber > firstFrame) {
+                lastFrame = entry.frameNumber - 1;
+                break;
+            }
+        }
+    } else {
+        VbiAddress startAddress = {false, -1};
+        VbiAddress endAddress = {false, -1};
+
+        if (parser.isSet(vbiStartOption)) {
+            if (!parseVbiAddress(metaData, parser.value(vbiStartOption), startAddress)) {
+                qCritical() << "VBI start must be a CAV picture number or CLV timecode (hh:mm:ss.pp)";
+                return false;
+            }
+
+            const LdDecodeMetaData::SeekIndexEntry start = findVbiAddress(metaData, startAddress.isClv, startAddress.code);
+            if (start.frameNumber == -1) {
+                qCritical() << "VBI start" << parser.value(vbiStartOption) << "is beyond the end of the VBI in the source";
+                return false;
+            }
+            if (start.code != startAddress.code) {
+                qInfo() << "VBI start address was not found exactly; starting at the next address available";
+            }
+            firstFrame = start.frameNumber;
+        }
+
+        if (parser.isSet(vbiEndOption)) {
+            if (!parseVbiAddress(metaData, parser.value(vbiEndOption), endAddress)) {
+                qCritical() << "VBI end must be a CAV picture number or CLV timecode (hh:mm:ss.pp)";
+                return false;
+            }
+            if (parser.isSet(vbiStartOption) && endAddress.isClv != startAddress.isClv) {
+                qCritical() << "VBI start and end must both be picture numbers or both be timecodes";
+                return false;
+            }
+
+            // The range ends just before the first frame after the end address
+            const LdDecodeMetaData::SeekIndexEntry next = findVbiAddress(metaData, endAddress.isClv, endAddress.code + 1);
+            if (next.frameNumber != -1) lastFrame = next.frameNumber - 1;
+        }
+    }
+
+    if (lastFrame < firstFrame) {
+        qCritical() << "The selected VBI range does not contain any frames";
+        return false;
+    }
+
+    startFrame = firstFrame;
+    length = lastFrame - firstFrame + 1;
+    qInfo() << "VBI range selects" << length << "frames starting at sequential frame" << startFrame
+            << "of" << numberOfFrames;
+
+    return true;
+}
@@ -0,0 +1,53 @@
+/************************************************************************
+
+    vbirange.h
+
+    ld-decode-tools TBC library
+    Copyright (C) 2026 agent
+
+    This file is part of ld-decode-tools.
+
+    ld-decode-tools is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+************************************************************************/
+
+#ifndef VBIRANGE_H
+#define VBIRANGE_H
+
+#include <QCommandLineParser>
+
+#include "lddecodemetadata.h"
+
+// Selection of the frames to process by their VBI addresses.
+//
+// A range can be given as a start and/or end address -- either a CAV picture
+// number (e.g. "12345") or a CLV timecode ("hh:mm:ss.pp") -- or as a chapter
+// number. The range is resolved through the metadata's VBI seek index into
+// sequential frame numbers, so the tool can seek directly to the first frame
+// rather than decoding from the start of the TBC.
+
+// Add the standard VBI range options (--vbi-start, --vbi-end and --chapter)
+// to the command line parser
+void addStandardVbiRangeOptions(QCommandLineParser &parser);
+
+// Process the standard VBI range options. The metadata must already be loaded
+// with the field order the tool will use.
+// If a range was given, sets startFrame (indexed from 1) and length (in
+// frames) to select it; otherwise leaves them unchanged. If startFrame or
+// length have already been set (i.e. are not -1), a VBI range is an error.
+// Returns true on success; on failure, prints a message and returns false.
+bool processStandardVbiRangeOptions(QCommandLineParser &parser, LdDecodeMetaData &metaData,
+                                    qint32 &startFrame, qint32 &length);
+
+#endif // VBIRANGE_H